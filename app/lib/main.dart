@@ -6,16 +6,33 @@ import 'package:toastification/toastification.dart';
 
 import 'constants.dart';
 import 'model/input_file.dart';
+import 'model/score_expression.dart';
+import 'model/solver.dart';
+import 'services/auction.dart';
+import 'services/components.dart';
+import 'services/hungarian.dart';
+import 'services/jonker_volgenant.dart';
 import 'services/match.dart';
 import 'view/screens/flow.dart';
 
 void main(List<String> args) {
-  // create args paser and configure it
+  // create args paser and configure it, the options taking a value are also
+  // listed in linux/my_application.cc to find the file before the engine runs
   ArgParser parser = ArgParser();
   parser.addFlag("help", defaultsTo: false);
   parser.addOption("extra");
   parser.addFlag("ff", defaultsTo: false);
   parser.addFlag("matrix", defaultsTo: false);
+  parser.addFlag("sparse", defaultsTo: false);
+  parser.addMultiOption("score", splitCommas: false);
+  parser.addOption("k-best");
+  parser.addOption("max-gap");
+  parser.addOption("profile");
+  parser.addOption("solution-cache");
+  parser.addOption(
+    "solver",
+    allowed: ["hungarian", "jonker-volgenant", "auction", "components"],
+  );
 
   // parse options and handle results
   ArgResults results = parser.parse(args);
@@ -29,6 +46,23 @@ void main(List<String> args) {
   String? extraPoints = results.option("extra");
   bool fastForwardMatch = results.flag("ff");
   bool showMatrices = results.flag("matrix");
+  bool sparse = results.flag("sparse");
+  String? solverName = results.option("solver");
+  String? kBest = results.option("k-best");
+  String? maxGap = results.option("max-gap");
+  String? profilePath = results.option("profile");
+  String? solutionCacheDirectory = results.option("solution-cache");
+
+  // parse the user defined scores before starting the gui
+  List<ScoreExpression> scores = [];
+  for (String text in results.multiOption("score")) {
+    try {
+      scores.add(ScoreExpression.parse(text));
+    } on FormatException catch (e) {
+      stderr.writeln("error: invalid score \"$text\": ${e.message}");
+      exit(1);
+    }
+  }
 
   int? points = extraPoints != null ? int.tryParse(extraPoints) : null;
 
@@ -46,19 +80,49 @@ void main(List<String> args) {
       showProgressBar: false,
       pauseOnHover: true,
     ),
+    // write the profile of every run, "-" prints it
+    onProfile: profilePath == null
+        ? null
+        : (profile) {
+            if (profilePath == "-") {
+              stdout.writeln(profile);
+            } else {
+              File(profilePath).writeAsStringSync("$profile\n");
+            }
+          },
     fastStart: fastForwardMatch,
     fastForward: fastForwardMatch,
     directMatchBonus: points ?? 10,
+    sparse: sparse,
+    scores: scores,
+    kBest: (kBest != null ? int.tryParse(kBest) : null) ?? 1,
+    maxGap: maxGap != null ? int.tryParse(maxGap) : null,
+    // solve on worker threads of the runner to keep the window responsive
+    background: true,
+    // keep the solutions across restarts if a directory is set
+    solutionCacheDirectory: solutionCacheDirectory,
+    solver: _solver(solverName),
   );
 
   runApp(
     App(
       service: service,
       showMatrices: showMatrices || !fastForwardMatch,
+      showProfile: profilePath != null,
     ),
   );
 }
 
+/// select the solver named [name], null selects the default solver
+AssignmentSolver<int>? _solver(String? name) => switch (name) {
+      "hungarian" => HungarianSolver(),
+      "jonker-volgenant" when JonkerVolgenantSolver.isAvailable =>
+        JonkerVolgenantSolver(),
+      "auction" when AuctionSolver.isAvailable => AuctionSolver(),
+      "components" when ComponentSolver.isAvailable => ComponentSolver(),
+      _ => null,
+    };
+
 void _printUsage() => print("""
 Usage:
 
@@ -69,9 +133,18 @@ Options:
   --extra <number>      Specify an optional number of extra points for direct match (default: 10).
   --ff                  Enable fast mode, which skips as many interactions as possible.
   --matrix              When used with --ff, dont hide matrices.
+  --sparse              Never match vetoes, entries that cannot be matched otherwise are reported.
+  --solver <name>       Select the solver: hungarian, jonker-volgenant, auction or components (default: jonker-volgenant if available).
+  --score <expression>  Also match with pairs scored by this expression of the ratings a and b, e.g. "a * b - abs(a - b) / 3". May be repeated.
+  --k-best <number>     Also show the next best matches of each strategy, up to this many in total (default: 1).
+  --max-gap <number>    Only show matches costing at most this much more than the best one, 0 shows the equally good matches.
+  --profile <file>      Write the time and memory of every stage and the solver counters of each run to this json file ("-" prints them), and show them on screen.
+  --solution-cache <directory>
+                        Also keep the solutions in this directory, so unchanged inputs are not solved again after a restart.
 
 Arguments:
   FILE                  (optional) The file to be used with the program. If omitted, the program provides a button to select a file.
+                        To match several files or a whole directory at once, use belegium_matcher_cli.
 
 Examples:
   Show usage information:
@@ -85,6 +158,12 @@ Examples:
   
   Run with a file:
     <executable> --extra 5 --ff inputfile.csv
+
+  Add a custom score:
+    <executable> --score "min(a, b) * 2 + max(a, b)"
+
+  Show all equally good matches:
+    <executable> --k-best 100 --max-gap 0
 """);
 
 class App extends StatelessWidget {
@@ -94,10 +173,14 @@ class App extends StatelessWidget {
   /// flag to show / hide matrices on screen
   final bool showMatrices;
 
+  /// flag to show the profile of the last run on screen
+  final bool showProfile;
+
   const App({
     super.key,
     required this.service,
     required this.showMatrices,
+    this.showProfile = false,
   });
 
   @override
@@ -117,6 +200,7 @@ class App extends StatelessWidget {
           home: FlowScreen(
             service: service,
             showMatrices: showMatrices,
+            showProfile: showProfile,
           ),
         ),
       );
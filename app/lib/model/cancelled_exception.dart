@@ -0,0 +1,10 @@
+/// exception thrown if the solve of a problem was cancelled
+class MatchCancelledException implements Exception {
+  /// description of the merge operation of the problem
+  final String problemOperatrionDescription;
+
+  const MatchCancelledException(this.problemOperatrionDescription);
+
+  @override
+  String toString() => "Match cancelled ($problemOperatrionDescription)";
+}
@@ -0,0 +1,97 @@
+import 'dart:collection';
+import 'dart:math';
+
+import 'dimension.dart';
+import 'matrix.dart';
+
+/// lazy view of the costs of a problem, a cell is computed from the input
+/// matrices every time it is read
+///
+/// cell (i, j) combines [a] at (i, j) with [b] at (j, i), so [b] is read
+/// transposed without copying it. an inverted view subtracts each combined
+/// cell from its [largest] entry. no n×n matrix is stored, so each solver
+/// materializes the costs once into its own workspace.
+class CostView {
+  /// matrices to combine, [b] is read transposed
+  final Matrix<int> a;
+  final Matrix<int> b;
+
+  /// merge operation
+  final int Function(int a, int b) combination;
+
+  /// value the combined cells are subtracted from, null if not inverted
+  final int? largest;
+
+  /// rows of this view, created once so reading a row allocates nothing
+  late final List<List<int>> _rows = List.generate(
+    dimension.m,
+    (i) => _CostRow(this, i),
+    growable: false,
+  );
+
+  CostView._(this.a, this.b, this.combination, this.largest);
+
+  /// constructor to view the combination of [a] and the transpose of [b]
+  factory CostView(
+    Matrix<int> a,
+    Matrix<int> b,
+    int Function(int a, int b) combination,
+  ) {
+    if (a.dimension != Dimension(b.dimension.n, b.dimension.m)) {
+      throw ArgumentError(
+          "Matrix dimensions must be compatible for combination.");
+    }
+
+    return CostView._(a, b, combination, null);
+  }
+
+  /// dimension of this view
+  Dimension get dimension => a.dimension;
+
+  /// method to read a single cell
+  int at(int i, int j) {
+    int value = combination(a[i][j], b[j][i]);
+    return largest == null ? value : largest! - value;
+  }
+
+  /// operator to read a row of the view, it is computed on access
+  List<int> operator [](int index) => _rows[index];
+
+  /// get the view of the minimize problem whose cells are subtracted from
+  /// [largest] (default: the largest entry), the entry is found in one pass
+  /// over the cells without storing them
+  CostView inverted([int? largest]) =>
+      CostView._(a, b, combination, largest ?? largestEntry());
+
+  /// get the value of the largest entry
+  int largestEntry() {
+    int? number;
+
+    for (int i = 0; i < dimension.m; i++) {
+      for (int j = 0; j < dimension.n; j++) {
+        int value = at(i, j);
+        number = number == null ? value : max(number, value);
+      }
+    }
+
+    return number ?? 0;
+  }
+
+  /// get a read only [Matrix] whose rows are computed on access, nothing is
+  /// copied
+  Matrix<int> asMatrix() => Matrix<int>.fromRows(dimension, _rows);
+}
+
+/// row of a [CostView], its cells are computed on access
+class _CostRow extends UnmodifiableListBase<int> {
+  final CostView view;
+  final int row;
+
+  _CostRow(this.view, this.row);
+
+  @override
+  int get length => view.dimension.n;
+
+  @override
+  int operator [](int index) => view.at(row, index);
+}
@@ -0,0 +1,56 @@
+import 'matrix.dart';
+
+/// 64 bit fingerprint of a sequence of values, used to recognize problems
+/// that were solved before
+///
+/// the values are mixed in one integer at a time like the FNV-1a hash, with
+/// an extra shift so the high bits reach the low ones. it is fast, but not
+/// meant to resist deliberate collisions
+class Fingerprint {
+  /// start value of new fingerprints
+  static const int _seed = 0x165667b19e3779f9;
+
+  /// multiplier of the mix, the 64 bit FNV prime
+  static const int _prime = 0x100000001b3;
+
+  /// current fingerprint
+  int _value;
+  int get value => _value;
+
+  /// constructor to start a fingerprint, or to continue [value]
+  Fingerprint([int? value]) : _value = value ?? _seed;
+
+  /// add the integer [value]
+  void addInt(int value) {
+    int hash = (_value ^ value) * _prime;
+    _value = hash ^ (hash >>> 32);
+  }
+
+  /// add the length and the elements of [values]
+  void addInts(List<int> values) {
+    addInt(values.length);
+    for (int value in values) {
+      addInt(value);
+    }
+  }
+
+  /// add the length and the code units of [text]
+  void addString(String text) => addInts(text.codeUnits);
+
+  /// add the dimension and the entries of [matrix]
+  void addMatrix(Matrix<int> matrix) {
+    addInt(matrix.dimension.m);
+    addInt(matrix.dimension.n);
+    for (int i = 0; i < matrix.dimension.m; i++) {
+      for (int value in matrix[i]) {
+        addInt(value);
+      }
+    }
+  }
+
+  /// fingerprint as 16 hex digits
+  @override
+  String toString() =>
+      (_value >>> 32).toRadixString(16).padLeft(8, "0") +
+      (_value & 0xffffffff).toRadixString(16).padLeft(8, "0");
+}
@@ -0,0 +1,251 @@
+import 'dart:ffi';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'cost_view.dart';
+import 'dimension.dart';
+import 'matrix.dart';
+
+/// matrix of 32 bit integers stored row-major in one contiguous buffer
+///
+/// the buffer is allocated in native memory and freed once it is no longer
+/// referenced, so it can be handed to the native core without copying. views
+/// share the buffer of their parent and address their cells with a stride.
+class FlatMatrix {
+  /// range of the cells, larger values would be truncated by [buffer]
+  static const int minValue = -0x80000000;
+  static const int maxValue = 0x7fffffff;
+
+  /// dimension of this matrix
+  final Dimension dimension;
+
+  /// distance between the first cells of two consecutive rows
+  final int stride;
+
+  /// index of the first cell in [buffer]
+  final int offset;
+
+  /// whole buffer shared with all views
+  final Int32List buffer;
+
+  /// native address of the first element of [buffer]
+  final Pointer<Int32> _bufferAddress;
+
+  const FlatMatrix._(
+    this.dimension,
+    this.stride,
+    this.offset,
+    this.buffer,
+    this._bufferAddress,
+  );
+
+  /// constructor to create a matrix
+  factory FlatMatrix(
+    Dimension dimension, {
+    int fillValue = 0,
+  }) {
+    int length = max(dimension.m * dimension.n, 1);
+
+    Pointer<Int32> address = malloc<Int32>(length);
+    Int32List buffer = address.asTypedList(
+      length,
+      finalizer: malloc.nativeFree,
+    );
+    buffer.fillRange(0, length, fillValue);
+
+    return FlatMatrix._(dimension, dimension.n, 0, buffer, address);
+  }
+
+  /// factory constructor to create a flat copy of [matrix], it throws a
+  /// [RangeError] if a cell does not fit into 32 bits
+  factory FlatMatrix.fromMatrix(Matrix<int> matrix) =>
+      tryFromMatrix(matrix) ??
+      (throw RangeError("The cells do not fit into 32 bits."));
+
+  /// factory constructor to compute all cells of [view] once into a flat
+  /// matrix, it throws a [RangeError] if a cell does not fit into 32 bits
+  factory FlatMatrix.fromView(CostView view) =>
+      tryFromView(view) ??
+      (throw RangeError("The cells do not fit into 32 bits."));
+
+  /// create a flat copy of [matrix], null if a cell does not fit into 32 bits
+  static FlatMatrix? tryFromMatrix(Matrix<int> matrix) {
+    FlatMatrix flat = FlatMatrix(matrix.dimension);
+    Int32List cells = flat.buffer;
+
+    for (int i = 0; i < matrix.dimension.m; i++) {
+      int start = i * flat.stride;
+      List<int> row = matrix[i];
+      for (int j = 0; j < matrix.dimension.n; j++) {
+        int value = row[j];
+        if (value < minValue || value > maxValue) return null;
+        cells[start + j] = value;
+      }
+    }
+
+    return flat;
+  }
+
+  /// compute all cells of [view] once into a flat matrix, null if a cell does
+  /// not fit into 32 bits
+  static FlatMatrix? tryFromView(CostView view) {
+    FlatMatrix flat = FlatMatrix(view.dimension);
+    Int32List cells = flat.buffer;
+
+    for (int i = 0; i < view.dimension.m; i++) {
+      int start = i * flat.stride;
+      for (int j = 0; j < view.dimension.n; j++) {
+        int value = view.at(i, j);
+        if (value < minValue || value > maxValue) return null;
+        cells[start + j] = value;
+      }
+    }
+
+    return flat;
+  }
+
+  /// native address of the first cell, the matrix must stay referenced as
+  /// long as the address is used
+  Pointer<Int32> get address => _bufferAddress + offset;
+
+  /// getter to check if the rows follow each other without gaps
+  bool get isContiguous => stride == dimension.n;
+
+  /// operator to read a row of the matrix, the row is a view into [buffer]
+  Int32List operator [](int index) => Int32List.sublistView(
+        buffer,
+        offset + index * stride,
+        offset + index * stride + dimension.n,
+      );
+
+  /// method to read a single cell
+  int at(int i, int j) => buffer[offset + i * stride + j];
+
+  /// method to write a single cell
+  void setAt(int i, int j, int value) {
+    buffer[offset + i * stride + j] = value;
+  }
+
+  /// get a view of the [dimension] sized block starting at [row], [column]
+  FlatMatrix view(int row, int column, Dimension dimension) {
+    assert(row >= 0 && column >= 0);
+    assert(row + dimension.m <= this.dimension.m);
+    assert(column + dimension.n <= this.dimension.n);
+
+    return FlatMatrix._(
+      dimension,
+      stride,
+      offset + row * stride + column,
+      buffer,
+      _bufferAddress,
+    );
+  }
+
+  /// method to copy this matrix into a new contiguous buffer
+  FlatMatrix copy() {
+    FlatMatrix matrix = FlatMatrix(dimension);
+
+    for (int i = 0; i < dimension.m; i++) {
+      matrix[i].setAll(0, this[i]);
+    }
+
+    return matrix;
+  }
+
+  /// method to transpose this matrix into a new buffer
+  FlatMatrix transpose() {
+    FlatMatrix matrix = FlatMatrix(
+      Dimension(dimension.n, dimension.m),
+    );
+
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      for (int j = 0; j < dimension.n; j++) {
+        matrix.buffer[j * matrix.stride + i] = buffer[start + j];
+      }
+    }
+
+    return matrix;
+  }
+
+  /// method to set all cells to [value] in place
+  void fill(int value) {
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      buffer.fillRange(start, start + dimension.n, value);
+    }
+  }
+
+  /// method to turn a maximize into a minimize problem in place by
+  /// subtracting each cell from [largest] (default: the largest entry)
+  void invert([int? largest]) {
+    int value = largest ?? largestEntry();
+
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      for (int j = start; j < start + dimension.n; j++) {
+        buffer[j] = value - buffer[j];
+      }
+    }
+  }
+
+  /// combine [other] element wise into this matrix in place
+  void combineWith(
+    FlatMatrix other,
+    int Function(int a, int b) combine,
+  ) {
+    if (dimension != other.dimension) {
+      throw ArgumentError(
+          "Matrix dimensions must be compatible for combination.");
+    }
+
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      int otherStart = other.offset + i * other.stride;
+      for (int j = 0; j < dimension.n; j++) {
+        buffer[start + j] = combine(
+          buffer[start + j],
+          other.buffer[otherStart + j],
+        );
+      }
+    }
+  }
+
+  /// get the value of the largest entry
+  int largestEntry() {
+    int number = minValue;
+
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      for (int j = start; j < start + dimension.n; j++) {
+        number = max(number, buffer[j]);
+      }
+    }
+
+    return number;
+  }
+
+  /// get the value of the smallest entry
+  int smallestEntry() {
+    int number = maxValue;
+
+    for (int i = 0; i < dimension.m; i++) {
+      int start = offset + i * stride;
+      for (int j = start; j < start + dimension.n; j++) {
+        number = min(number, buffer[j]);
+      }
+    }
+
+    return number;
+  }
+
+  /// get a [Matrix] whose rows are views into this matrix, nothing is copied
+  Matrix<int> asMatrix() => Matrix<int>.fromRows(
+        dimension,
+        [
+          for (int i = 0; i < dimension.m; i++) this[i],
+        ],
+      );
+}
@@ -0,0 +1,18 @@
+/// exception reported if some entries cannot be matched without a veto
+class InfeasibleMatchException implements Exception {
+  /// description of the merge operation of the problem
+  final String problemOperatrionDescription;
+
+  /// names of the entries left without a match
+  final List<String> unassigned;
+
+  const InfeasibleMatchException(
+    this.problemOperatrionDescription,
+    this.unassigned,
+  );
+
+  @override
+  String toString() =>
+      "No match without veto for ${unassigned.join(", ")} "
+      "($problemOperatrionDescription)";
+}
@@ -1,5 +1,11 @@
+import 'dart:ffi';
 import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
 
+import 'package:ffi/ffi.dart';
+
+import '../services/native_core.dart';
 import 'dimension.dart';
 import 'table_position.dart';
 import 'input_exception.dart';
@@ -14,7 +20,10 @@ class InputFile {
   final MatrixStorage<String> table = [];
 
   /// loaded tables (wgs, persons)
-  final List<MatrixStorage<String>> tables = [];
+  final List<MatrixStorage<String>> _tables = [];
+
+  /// matrices parsed by the native core, their text is built on demand
+  List<Matrix<int>>? _nativeTables;
 
   final List<String> wgs = [];
   final List<String> persons = [];
@@ -25,11 +34,34 @@ class InputFile {
   /// constructor for input files
   InputFile(String filepath) : _file = File(filepath);
 
+  /// getter for the loaded tables (wgs, persons)
+  ///
+  /// tables of a file parsed by the native core are rebuilt from the parsed
+  /// ratings, so each cell holds the canonical text of its number, e.g. "5"
+  /// for "+5" or " 5", instead of the spelling used in the file
+  List<MatrixStorage<String>> get tables {
+    if (_tables.isEmpty && _nativeTables != null) {
+      _tables.add(_textTable(persons, wgs, _nativeTables![0]));
+      _tables.add(_textTable(wgs, persons, _nativeTables![1]));
+    }
+
+    return _tables;
+  }
+
   /// method to load content
   Future<List<Matrix<int>>> load() async {
     // clear old data
     _clear();
 
+    // parse the file in the background if the native core is available
+    if (NativeCore.instance != null) {
+      String path = _file.path;
+
+      return _applyNativeInput(
+        await Isolate.run(() => _loadNative(path)),
+      );
+    }
+
     // split the table
     _splitTable(
       await _getContent(),
@@ -46,6 +78,13 @@ class InputFile {
     // clear old data
     _clear();
 
+    // parse the file with the native core if available
+    if (NativeCore.instance != null) {
+      return _applyNativeInput(
+        _loadNative(_file.path),
+      );
+    }
+
     // split the table
     _splitTable(
       _getContentSync(),
@@ -59,12 +98,173 @@ class InputFile {
 
   /// internal metod to clear old data
   void _clear() {
-    tables.clear();
+    _nativeTables = null;
+    _tables.clear();
     wgs.clear();
     persons.clear();
     error = null;
   }
 
+  /// internal method to load the file with the native core
+  ///
+  /// the file is memory mapped and parsed without building the text tables,
+  /// the same validation checks as below are performed. a file passed on the
+  /// command line was already loaded by the runner while the engine started,
+  /// its result is taken once instead of loading the file again. invalid
+  /// files are split here as well, so the error can be shown in the table
+  /// without reading the file again on the calling isolate
+  static _NativeInput _loadNative(String path) {
+    NativeCore core = NativeCore.instance!;
+
+    Pointer<Utf8> nativePath = path.toNativeUtf8();
+    Pointer<Pointer<BelegiumInput>> handle = calloc<Pointer<BelegiumInput>>();
+    Pointer<Int32> position = calloc<Int32>(3);
+
+    try {
+      int status = core.takePreloadedInput(nativePath, handle);
+      if (status == NativeCore.errorNotFound) {
+        status = core.loadInput(nativePath, handle);
+      }
+      Pointer<BelegiumInput> input = handle.value;
+
+      if (status == NativeCore.errorInvalidInput) {
+        bool hasPosition = core.inputErrorPosition(
+              input,
+              position,
+              position + 1,
+              position + 2,
+            ) !=
+            0;
+
+        // split the file to show the error position, errors detected until
+        // there are reported the same way as without the native core
+        InputFile split = InputFile(path);
+        Exception? splitError;
+
+        try {
+          split._splitTable(
+            split._getContentSync(),
+          );
+        } on FileSystemException catch (e) {
+          splitError = e;
+        } on FormatException catch (e) {
+          splitError = e;
+        }
+
+        // unset members of the position are -1
+        return _NativeInput.failed(
+          core.inputErrorMessage(input).toDartString(),
+          hasPosition
+              ? TablePosition(
+                  position[0] < 0 ? null : position[0],
+                  position[1] < 0 ? null : position[1],
+                  position[2] < 0 ? null : position[2],
+                )
+              : null,
+          split.table,
+          split._tables,
+          splitError,
+        );
+      }
+
+      if (status != NativeCore.ok) {
+        throw StateError("Native loader failed with status $status.");
+      }
+
+      List<String> wgs = [
+        for (int i = 0; i < core.inputWgCount(input); i++)
+          core.inputWg(input, i).toDartString(),
+      ];
+
+      List<String> persons = [
+        for (int i = 0; i < core.inputPersonCount(input); i++)
+          core.inputPerson(input, i).toDartString(),
+      ];
+
+      return _NativeInput(
+        wgs,
+        persons,
+        [
+          _nativeMatrix(
+            core.inputRatingsA(input),
+            Dimension(persons.length, wgs.length),
+          ),
+          _nativeMatrix(
+            core.inputRatingsB(input),
+            Dimension(wgs.length, persons.length),
+          ),
+        ],
+      );
+    } finally {
+      if (handle.value != nullptr) core.inputFree(handle.value);
+
+      calloc.free(nativePath);
+      calloc.free(handle);
+      calloc.free(position);
+    }
+  }
+
+  /// internal method to copy ratings owned by the native core, the rows of
+  /// the matrix are views into a single buffer
+  static Matrix<int> _nativeMatrix(Pointer<Int64> ratings, Dimension size) {
+    Int64List data = Int64List.fromList(
+      ratings.asTypedList(size.m * size.n),
+    );
+
+    return Matrix<int>.fromRows(
+      size,
+      [
+        for (int i = 0; i < size.m; i++)
+          Int64List.sublistView(data, i * size.n, (i + 1) * size.n),
+      ],
+    );
+  }
+
+  /// internal method to take over the result of the native loader
+  /// \throws InputException or FormatException if the file is invalid
+  List<Matrix<int>> _applyNativeInput(_NativeInput input) {
+    if (input.message != null) {
+      table.addAll(input.table);
+      _tables.addAll(input.splitTables);
+
+      if (input.splitError != null) {
+        // only the split reports its errors in [error]
+        if (input.splitError is InputException) {
+          error = input.splitError as InputException;
+        }
+
+        throw input.splitError!;
+      }
+
+      error = input.position != null
+          ? InputException(input.message!, input.position!)
+          : FormatException(input.message!);
+
+      throw error!;
+    }
+
+    wgs.addAll(input.wgs);
+    persons.addAll(input.persons);
+    _nativeTables = input.tables;
+
+    return input.tables;
+  }
+
+  /// internal method to build the text of a sorted table from its matrix
+  static MatrixStorage<String> _textTable(
+    List<String> rowHeader,
+    List<String> columnHeader,
+    Matrix<int> matrix,
+  ) =>
+      [
+        ["", ...columnHeader],
+        for (int i = 0; i < matrix.dimension.m; i++)
+          [
+            rowHeader[i],
+            for (int value in matrix[i]) value.toString(),
+          ],
+      ];
+
   /// internal method to load file content
   /// \throws FileSystemException if file doesnt exist
   /// \throws FormatException on missing lines
@@ -494,3 +694,45 @@ class InputFile {
     return matrix;
   }
 }
+
+/// result of the native loader, it is sent back from a background isolate
+class _NativeInput {
+  /// sorted names of the headers
+  final List<String> wgs;
+  final List<String> persons;
+
+  /// parsed tables (persons x wgs, wgs x persons)
+  final List<Matrix<int>> tables;
+
+  /// message of the detected error, null if the file is valid
+  final String? message;
+
+  /// position of the detected error
+  final TablePosition? position;
+
+  /// content of an invalid file and its split tables, see [InputFile.table]
+  final MatrixStorage<String> table;
+  final List<MatrixStorage<String>> splitTables;
+
+  /// error thrown while reading or splitting an invalid file
+  final Exception? splitError;
+
+  /// constructor for a loaded file
+  const _NativeInput(this.wgs, this.persons, this.tables)
+      : message = null,
+        position = null,
+        table = const [],
+        splitTables = const [],
+        splitError = null;
+
+  /// constructor for an invalid file
+  const _NativeInput.failed(
+    this.message,
+    this.position,
+    this.table,
+    this.splitTables,
+    this.splitError,
+  )   : wgs = const [],
+        persons = const [],
+        tables = const [];
+}
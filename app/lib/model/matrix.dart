@@ -19,6 +19,9 @@ class Matrix<T extends num> {
           (_) => List<T>.filled(dimension.n, fillValue ?? 0 as T),
         );
 
+  /// constructor to wrap existing rows, [data] is not copied
+  Matrix.fromRows(this.dimension, this.data);
+
   /// factory constructor to create a square matrix
   factory Matrix.square(
     int dimension, {
@@ -49,7 +52,7 @@ class Matrix<T extends num> {
 
     for (int i = 0; i < m; i++) {
       for (int j = 0; j < n; j++) {
-        matrix[[i, j]] = data[i][j];
+        matrix[i][j] = data[i][j];
       }
     }
 
@@ -74,7 +77,7 @@ class Matrix<T extends num> {
 
     for (int i = 0; i < dimension.m; i++) {
       for (int j = 0; j < dimension.n; j++) {
-        matrix[[i, j]] = (data[i][j] + other[i][j]) as T;
+        matrix[i][j] = (data[i][j] + other[i][j]) as T;
       }
     }
 
@@ -91,7 +94,7 @@ class Matrix<T extends num> {
 
     for (int i = 0; i < dimension.m; i++) {
       for (int j = 0; j < dimension.n; j++) {
-        matrix[[i, j]] = (data[i][j] - other[i][j]) as T;
+        matrix[i][j] = (data[i][j] - other[i][j]) as T;
       }
     }
 
@@ -118,7 +121,7 @@ class Matrix<T extends num> {
         for (int r = 0; r < dimension.n; r++) {
           sum = (sum + data[i][r] * other[r][j]) as T;
         }
-        matrix[[i, j]] = sum;
+        matrix[i][j] = sum;
       }
     }
 
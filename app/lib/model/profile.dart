@@ -0,0 +1,130 @@
+import 'dart:convert';
+import 'dart:io';
+
+/// work counters of a solve, the dart and the native solvers fill the same
+/// counters as far as they apply to them
+class SolverCounters {
+  /// number of augmenting paths searched, auction rounds for the auction
+  /// solver
+  int augmentations = 0;
+
+  /// number of changes of the dual potentials, e.g. step 6 of the hungarian
+  /// method or bids of the auction solver
+  int dualUpdates = 0;
+
+  /// number of zeros or columns looked at by the path searches
+  int scanned = 0;
+
+  /// number of pairs added to the assignment along all augmenting paths
+  int pathLength = 0;
+
+  SolverCounters();
+
+  /// add the counters of [other] to this one
+  void add(SolverCounters other) {
+    augmentations += other.augmentations;
+    dualUpdates += other.dualUpdates;
+    scanned += other.scanned;
+    pathLength += other.pathLength;
+  }
+
+  Map<String, int> toJson() => {
+        "augmentations": augmentations,
+        "dual_updates": dualUpdates,
+        "scanned": scanned,
+        "path_length": pathLength,
+      };
+}
+
+/// measurement of one stage of a match
+class StageProfile {
+  /// name of the stage, e.g. "load" or "solve a + b"
+  final String name;
+
+  /// monotonic time spent in the stage
+  final Duration elapsed;
+
+  /// growth of the resident memory of the process during the stage in bytes,
+  /// it includes allocations of stages running at the same time
+  final int allocated;
+
+  const StageProfile(this.name, this.elapsed, this.allocated);
+
+  /// measure the synchronous [stage] called [name]
+  static (T, StageProfile) measure<T>(String name, T Function() stage) {
+    int rss = ProcessInfo.currentRss;
+    Stopwatch stopwatch = Stopwatch()..start();
+
+    T value = stage();
+
+    return (
+      value,
+      StageProfile(name, stopwatch.elapsed, ProcessInfo.currentRss - rss),
+    );
+  }
+
+  /// measure the asynchronous [stage] called [name], the time includes
+  /// waiting for other work
+  static Future<(T, StageProfile)> measureAsync<T>(
+    String name,
+    Future<T> Function() stage,
+  ) async {
+    int rss = ProcessInfo.currentRss;
+    Stopwatch stopwatch = Stopwatch()..start();
+
+    T value = await stage();
+
+    return (
+      value,
+      StageProfile(name, stopwatch.elapsed, ProcessInfo.currentRss - rss),
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        "name": name,
+        "elapsed_us": elapsed.inMicroseconds,
+        "allocated_bytes": allocated,
+      };
+}
+
+/// stages and solver counters of the last match of a [MatchService]
+class MatchProfile {
+  /// stages in order of completion
+  final List<StageProfile> stages = [];
+
+  /// solver counters by problem description
+  final Map<String, SolverCounters> counters = {};
+
+  /// measure the synchronous [stage] called [name] and add it
+  T measure<T>(String name, T Function() stage) {
+    var (value, profile) = StageProfile.measure(name, stage);
+    stages.add(profile);
+    return value;
+  }
+
+  /// measure the asynchronous [stage] called [name] and add it, the time
+  /// includes waiting for other work
+  Future<T> measureAsync<T>(String name, Future<T> Function() stage) async {
+    var (value, profile) = await StageProfile.measureAsync(name, stage);
+    stages.add(profile);
+    return value;
+  }
+
+  void clear() {
+    stages.clear();
+    counters.clear();
+  }
+
+  Map<String, dynamic> toJson() => {
+        "stages": [for (StageProfile stage in stages) stage.toJson()],
+        "solvers": {
+          for (MapEntry<String, SolverCounters> entry in counters.entries)
+            entry.key: entry.value.toJson(),
+        },
+        "peak_rss_bytes": ProcessInfo.maxRss,
+      };
+
+  /// report as indented json
+  @override
+  String toString() => const JsonEncoder.withIndent("  ").convert(toJson());
+}
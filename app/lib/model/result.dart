@@ -1,4 +1,5 @@
 import 'matrix.dart';
+import 'profile.dart';
 
 class AssignmentResult {
   final List<MapEntry<int, int>> assignments = [];
@@ -6,5 +7,30 @@ class AssignmentResult {
   int costs = 0;
   String problemOperatrionDescription = "";
 
+  /// rows that could not be assigned, the problem is infeasible if there are
+  /// any
+  final List<int> unassignedRows = [];
+  bool get feasible => unassignedRows.isEmpty;
+
+  /// rows and columns of a problem that is not quadratic left without a
+  /// match, because the other side has fewer entries. only one of them has
+  /// entries, unlike [unassignedRows] they do not make the problem infeasible
+  final List<int> unmatchedRows = [];
+  final List<int> unmatchedColumns = [];
+
+  /// optimal dual potentials of the problem, the reduced cost
+  /// `problem[i][j] - rowPotentials[i] - columnPotentials[j]` of every cell
+  /// is non-negative and 0 for the assigned cells. null if the solver does
+  /// not report them
+  List<int>? rowPotentials;
+  List<int>? columnPotentials;
+
+  /// work counters of the solver that found the assignment
+  SolverCounters counters = SolverCounters();
+
+  /// next best assignments of the problem ordered by costs, only searched if
+  /// requested
+  final List<AssignmentResult> alternatives = [];
+
   AssignmentResult(this.problem);
 }
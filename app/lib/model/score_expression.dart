@@ -0,0 +1,247 @@
+import 'dart:math';
+
+/// user defined strategy to merge the ratings a and b of a pair into a score,
+/// e.g. "a * b - abs(a - b) / 3"
+///
+/// expressions consist of the ratings a and b, decimal numbers, the
+/// operators + - * / with the usual precedence, parentheses and the functions
+/// abs(x), sign(x), min(x, y) and max(x, y). they are evaluated with double
+/// precision and the score is truncated towards zero, a division by zero
+/// yields 0 and scores are clamped to +-[maxScore]. this is the same grammar
+/// and arithmetic as ScoreExpression of the native core.
+///
+/// the text is parsed once into nested closures, so evaluating a cell does
+/// not look at the text again
+class ScoreExpression {
+  /// bound of the magnitude of a score
+  static const int maxScore = 1 << 53;
+
+  /// largest number of nested parentheses and function calls
+  static const int _maxNesting = 64;
+
+  /// text the expression was parsed from
+  final String text;
+
+  /// postfix form of the expression, equal for texts that only differ in
+  /// spacing or redundant parentheses
+  final String postfix;
+
+  /// compiled expression
+  final double Function(int a, int b) _function;
+
+  const ScoreExpression._(this.text, this.postfix, this._function);
+
+  /// factory constructor to parse [text], throws a [FormatException] if it is
+  /// no valid expression
+  factory ScoreExpression.parse(String text) {
+    _Parser parser = _Parser(text);
+    _Node node = parser.parseSum();
+    parser.skipSpaces();
+    if (parser.position < text.length) parser.unexpected();
+
+    return ScoreExpression._(text, node.postfix, node.function);
+  }
+
+  /// get the score of the ratings [a] and [b]
+  int call(int a, int b) {
+    double value = _function(a, b);
+    if (value.isNaN) return 0;
+
+    return value.clamp(-maxScore.toDouble(), maxScore.toDouble()).toInt();
+  }
+
+  @override
+  String toString() => text;
+}
+
+/// parsed part of an expression
+class _Node {
+  final String postfix;
+  final double Function(int a, int b) function;
+
+  const _Node(this.postfix, this.function);
+}
+
+/// recursive descent parser, each method parses one level of precedence
+class _Parser {
+  final String text;
+  int position = 0;
+  int nesting = 0;
+
+  _Parser(this.text);
+
+  /// sum := product (("+" | "-") product)*
+  _Node parseSum() {
+    _Node node = parseProduct();
+    while (true) {
+      if (accept("+")) {
+        node = _binary(node, parseProduct(), "+", (x, y) => x + y);
+      } else if (accept("-")) {
+        node = _binary(node, parseProduct(), "-", (x, y) => x - y);
+      } else {
+        return node;
+      }
+    }
+  }
+
+  /// product := unary (("*" | "/") unary)*
+  _Node parseProduct() {
+    _Node node = parseUnary();
+    while (true) {
+      if (accept("*")) {
+        node = _binary(node, parseUnary(), "*", (x, y) => x * y);
+      } else if (accept("/")) {
+        node = _binary(
+          node,
+          parseUnary(),
+          "/",
+          (x, y) => y != 0 ? x / y : 0,
+        );
+      } else {
+        return node;
+      }
+    }
+  }
+
+  /// unary := "-" unary | primary
+  _Node parseUnary() {
+    if (!accept("-")) return parsePrimary();
+
+    enter();
+    _Node node = _unary(parseUnary(), "neg", (x) => -x);
+    nesting--;
+    return node;
+  }
+
+  /// primary := number | "a" | "b" | "(" sum ")" | name "(" arguments ")"
+  _Node parsePrimary() {
+    skipSpaces();
+    if (position >= text.length) unexpected();
+
+    Match? number = RegExp(r"[0-9.]+").matchAsPrefix(text, position);
+    if (number != null) {
+      double value = double.tryParse(number[0]!) ?? unexpected();
+
+      position = number.end;
+      return _Node("$value", (a, b) => value);
+    }
+
+    if (accept("(")) {
+      enter();
+      _Node node = parseSum();
+      expect(")");
+      nesting--;
+      return node;
+    }
+
+    Match name =
+        RegExp(r"[A-Za-z][A-Za-z0-9]*").matchAsPrefix(text, position) ??
+            unexpected();
+
+    int start = position;
+    position = name.end;
+    switch (name[0]) {
+      case "a":
+        return _Node("a", (a, b) => a.toDouble());
+      case "b":
+        return _Node("b", (a, b) => b.toDouble());
+      case "abs":
+        return _call((x) => _unary(x.first, "abs", (x) => x.abs()), 1);
+      case "sign":
+        return _call((x) => _unary(x.first, "sign", (x) => x.sign), 1);
+      case "min":
+        return _call((x) => _binary(x[0], x[1], "min", min), 2);
+      case "max":
+        return _call((x) => _binary(x[0], x[1], "max", max), 2);
+    }
+
+    throw FormatException(
+      "unknown name '${name[0]}' at position ${start + 1}",
+      text,
+      start,
+    );
+  }
+
+  /// parses the [count] arguments of a function and applies [build]
+  _Node _call(_Node Function(List<_Node> arguments) build, int count) {
+    expect("(");
+    enter();
+
+    List<_Node> arguments = [];
+    for (int k = 0; k < count; k++) {
+      if (k > 0) expect(",");
+      arguments.add(parseSum());
+    }
+
+    expect(")");
+    nesting--;
+    return build(arguments);
+  }
+
+  /// enters a parenthesis or function call
+  void enter() {
+    if (++nesting > ScoreExpression._maxNesting) {
+      throw FormatException(
+        "expression is nested too deeply",
+        text,
+        position,
+      );
+    }
+  }
+
+  /// skip spaces and consume [token] if it follows
+  bool accept(String token) {
+    skipSpaces();
+    if (!text.startsWith(token, position)) return false;
+
+    position += token.length;
+    return true;
+  }
+
+  /// same as [accept], but fails if [token] does not follow
+  void expect(String token) {
+    if (!accept(token)) unexpected();
+  }
+
+  /// throw the error for the character at [position]
+  Never unexpected() {
+    if (position >= text.length) {
+      throw FormatException("unexpected end of expression", text, position);
+    }
+
+    throw FormatException(
+      "unexpected '${text[position]}' at position ${position + 1}",
+      text,
+      position,
+    );
+  }
+
+  void skipSpaces() {
+    while (position < text.length && text[position].trim().isEmpty) {
+      position++;
+    }
+  }
+
+  static _Node _unary(
+    _Node x,
+    String name,
+    double Function(double x) apply,
+  ) {
+    double Function(int, int) f = x.function;
+    return _Node("${x.postfix} $name", (a, b) => apply(f(a, b)));
+  }
+
+  static _Node _binary(
+    _Node x,
+    _Node y,
+    String name,
+    double Function(double x, double y) apply,
+  ) {
+    double Function(int, int) f = x.function;
+    double Function(int, int) g = y.function;
+    return _Node(
+      "${x.postfix} ${y.postfix} $name",
+      (a, b) => apply(f(a, b), g(a, b)),
+    );
+  }
+}
@@ -0,0 +1,28 @@
+/// progress of a problem solved by a native job
+class SolveProgress {
+  /// id of the job
+  final int job;
+
+  /// number of rows assigned so far
+  final int assigned;
+
+  /// number of rows of the problem
+  final int n;
+
+  /// sum of the dual potentials, a lower bound of the costs of the solution
+  /// that rises to them
+  final int dualObjective;
+
+  const SolveProgress(this.job, this.assigned, this.n, this.dualObjective);
+
+  /// constructor to read a progress event of the solver channel
+  factory SolveProgress.fromEvent(dynamic event) => SolveProgress(
+        event["job"] as int,
+        event["assigned"] as int,
+        event["n"] as int,
+        event["dual_objective"] as int,
+      );
+
+  /// share of the assigned rows from 0 to 1
+  double get fraction => n == 0 ? 1.0 : assigned / n;
+}
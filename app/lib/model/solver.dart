@@ -1,6 +1,38 @@
+import 'flat_matrix.dart';
 import 'matrix.dart';
 import 'result.dart';
+import 'sparse_matrix.dart';
 
 abstract class AssignmentSolver<T extends num> {
   AssignmentResult solve(Matrix<T> problem);
 }
+
+/// solver for problems where rows and columns may be assigned multiple times
+abstract class CapacitatedAssignmentSolver<T extends num> {
+  /// solve [problem] where row i can be used [rowCapacities][i] times and
+  /// column j [columnCapacities][j] times, the result contains one assignment
+  /// per used capacity unit
+  AssignmentResult solve(
+    Matrix<T> problem,
+    List<int> rowCapacities,
+    List<int> columnCapacities,
+  );
+}
+
+/// solver that works on flat matrices without copying them
+abstract class FlatAssignmentSolver {
+  AssignmentResult solveFlat(FlatMatrix problem);
+}
+
+/// flat solver that also solves problems that are not quadratic without
+/// padding them, the rows or columns of the larger side left without a match
+/// are reported in [AssignmentResult.unmatchedRows] and
+/// [AssignmentResult.unmatchedColumns]
+abstract class RectangularAssignmentSolver implements FlatAssignmentSolver {}
+
+/// solver for problems where only the set cells of a sparse matrix may be
+/// assigned, rows that cannot be assigned are reported in
+/// [AssignmentResult.unassignedRows]
+abstract class SparseAssignmentSolver {
+  AssignmentResult solveSparse(SparseMatrix problem);
+}
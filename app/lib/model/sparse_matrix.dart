@@ -0,0 +1,68 @@
+import 'dart:typed_data';
+
+import 'dimension.dart';
+import 'matrix.dart';
+
+/// matrix of which only some cells are set, stored in compressed sparse row
+/// form
+///
+/// the set columns of row i and their values are stored at the indices
+/// [rowOffsets][i] to [rowOffsets][i + 1] - 1 of [columns] and [values]
+class SparseMatrix {
+  /// dimension of this matrix
+  final Dimension dimension;
+
+  /// index of the first cell of each row and the number of cells at the end
+  final Int32List rowOffsets;
+
+  /// columns of the set cells
+  final Int32List columns;
+
+  /// values of the set cells
+  final Int64List values;
+
+  const SparseMatrix._(
+    this.dimension,
+    this.rowOffsets,
+    this.columns,
+    this.values,
+  );
+
+  /// factory constructor to create a sparse copy of the cells of [matrix] at
+  /// which [where] is true
+  factory SparseMatrix.fromMatrix(
+    Matrix<int> matrix,
+    bool Function(int i, int j) where,
+  ) {
+    int m = matrix.dimension.m;
+    int n = matrix.dimension.n;
+
+    // count the cells first to allocate the buffers once
+    Int32List rowOffsets = Int32List(m + 1);
+    for (int i = 0; i < m; i++) {
+      int count = 0;
+      for (int j = 0; j < n; j++) {
+        if (where(i, j)) count++;
+      }
+      rowOffsets[i + 1] = rowOffsets[i] + count;
+    }
+
+    Int32List columns = Int32List(rowOffsets[m]);
+    Int64List values = Int64List(rowOffsets[m]);
+    int k = 0;
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        if (!where(i, j)) continue;
+
+        columns[k] = j;
+        values[k] = matrix[i][j];
+        k++;
+      }
+    }
+
+    return SparseMatrix._(matrix.dimension, rowOffsets, columns, values);
+  }
+
+  /// number of set cells
+  int get length => columns.length;
+}
@@ -0,0 +1,12 @@
+/// exception reported if the costs of a problem are too large to be solved
+/// without overflow
+class ScoresTooLargeException implements Exception {
+  /// description of the merge operation of the problem
+  final String problemOperatrionDescription;
+
+  const ScoresTooLargeException(this.problemOperatrionDescription);
+
+  @override
+  String toString() =>
+      "Not solved, the scores are too large ($problemOperatrionDescription)";
+}
@@ -0,0 +1,74 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+import '../model/solver.dart';
+import 'native_core.dart';
+
+/// solver using the native auction algorithm with epsilon scaling
+///
+/// the unassigned rows bid for columns on several threads at once, which
+/// scales better than the sequential shortest augmenting paths on very large
+/// problems. the final scaling phase makes the result exactly optimal for the
+/// integer problems of the match service. the solver only looks up the native
+/// core when solving, so it can be sent to background isolates
+class AuctionSolver extends AssignmentSolver<int>
+    implements FlatAssignmentSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  /// number of bidding threads, one per hardware thread if it is < 1
+  final int threads;
+
+  AuctionSolver({this.threads = 0});
+
+  @override
+  AssignmentResult solve(Matrix<int> problem) =>
+      solveFlat(FlatMatrix.fromMatrix(problem));
+
+  @override
+  AssignmentResult solveFlat(FlatMatrix problem) {
+    if (!problem.dimension.isQuadratic || problem.dimension.n < 2) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+    int n = problem.dimension.n;
+
+    Pointer<Int32> rowToCol = calloc<Int32>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+
+    try {
+      // the solver reads the buffer of the problem directly
+      int status = core.solveAssignmentAuctionI32(
+        problem.address,
+        n,
+        problem.stride,
+        threads,
+        rowToCol,
+        totalCost,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem.asMatrix());
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int i = 0; i < n; i++) {
+        result.assignments.add(
+          MapEntry<int, int>(i, rowToCol[i]),
+        );
+      }
+
+      return result;
+    } finally {
+      calloc.free(rowToCol);
+      calloc.free(totalCost);
+    }
+  }
+}
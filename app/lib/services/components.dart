@@ -0,0 +1,113 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+import '../model/solver.dart';
+import 'native_core.dart';
+
+/// solver using the native core on the independent parts of a problem
+///
+/// rows and columns joined by a cell below the largest cost, e.g. a pair
+/// without a veto, form the components of a bipartite graph. every cell
+/// between two components has the largest cost, so each component is solved
+/// on its own and the rows and columns left over are paired at the largest
+/// cost, which is exactly optimal. the components are solved on several
+/// threads and k equally large ones take about 1 / k^2 of the time. the solver
+/// only looks up the native core when solving, so it can be sent to
+/// background isolates
+class ComponentSolver extends AssignmentSolver<int>
+    implements FlatAssignmentSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  /// number of threads solving the components, one per hardware thread if it
+  /// is < 1
+  final int threads;
+
+  ComponentSolver({this.threads = 0});
+
+  /// count the components of the [m] x [n] problem whose cells (i, j) are
+  /// [joined] that have at least one row and one column
+  static int countComponents(int m, int n, bool Function(int, int) joined) {
+    // rows are the nodes 0 to m - 1, columns m to m + n - 1
+    List<int> parent = List.generate(m + n, (node) => node);
+    int find(int node) {
+      while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+      }
+      return node;
+    }
+
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        if (!joined(i, j)) continue;
+
+        int a = find(i);
+        int b = find(m + j);
+        if (a != b) parent[a > b ? a : b] = a > b ? b : a;
+      }
+    }
+
+    // a component has a row and a column if any column has it as its root,
+    // as the smaller node is the root
+    Set<int> roots = {
+      for (int j = 0; j < n; j++)
+        if (find(m + j) < m) find(m + j),
+    };
+    return roots.length;
+  }
+
+  @override
+  AssignmentResult solve(Matrix<int> problem) =>
+      solveFlat(FlatMatrix.fromMatrix(problem));
+
+  @override
+  AssignmentResult solveFlat(FlatMatrix problem) {
+    if (!problem.dimension.isQuadratic) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+    int n = problem.dimension.n;
+
+    Pointer<Int32> rowToCol = calloc<Int32>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+    Pointer<Int32> componentCount = calloc<Int32>();
+
+    try {
+      // the solver reads the buffer of the problem directly
+      int status = core.solveComponentsI32(
+        problem.address,
+        n,
+        problem.stride,
+        threads,
+        rowToCol,
+        totalCost,
+        componentCount,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem.asMatrix());
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int i = 0; i < n; i++) {
+        result.assignments.add(
+          MapEntry<int, int>(i, rowToCol[i]),
+        );
+      }
+
+      return result;
+    } finally {
+      calloc.free(rowToCol);
+      calloc.free(totalCost);
+      calloc.free(componentCount);
+    }
+  }
+}
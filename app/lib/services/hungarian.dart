@@ -1,6 +1,7 @@
 import 'dart:math';
 
 import '../model/matrix.dart';
+import '../model/profile.dart';
 import '../model/result.dart';
 import '../model/solver.dart';
 
@@ -10,9 +11,17 @@ class HungarianSolver extends AssignmentSolver<int> {
   List<int> rowCover = [];
   List<int> colCover = [];
 
+  /// dual potentials, [matrix] always holds the reduced costs
+  /// `problem[i][j] - rowPotentials[i] - columnPotentials[j]`
+  List<int> rowPotentials = [];
+  List<int> columnPotentials = [];
+
   int pathRow0 = 0;
   int pathCol0 = 0;
 
+  /// work counters of the current solve
+  SolverCounters counters = SolverCounters();
+
   int get size => matrix.dimension.n;
 
   @override
@@ -26,11 +35,14 @@ class HungarianSolver extends AssignmentSolver<int> {
     mask = Matrix(problem.dimension);
     rowCover.clear();
     colCover.clear();
+    counters = SolverCounters();
 
     for (int i = 0; i < problem.dimension.n; i++) {
       rowCover.add(0);
       colCover.add(0);
     }
+    rowPotentials = List.filled(problem.dimension.n, 0);
+    columnPotentials = List.filled(problem.dimension.n, 0);
 
     bool done = false;
     int step = 1;
@@ -61,6 +73,9 @@ class HungarianSolver extends AssignmentSolver<int> {
     }
 
     AssignmentResult result = AssignmentResult(problem);
+    result.counters = counters;
+    result.rowPotentials = List.of(rowPotentials);
+    result.columnPotentials = List.of(columnPotentials);
 
     for (int i = 0; i < size; i++) {
       for (int j = 0; j < size; j++) {
@@ -87,6 +102,7 @@ class HungarianSolver extends AssignmentSolver<int> {
       for (int c = 0; c < size; ++c) {
         matrix[r][c] -= minVal;
       }
+      rowPotentials[r] += minVal;
     }
 
     for (int c = 0; c < size; ++c) {
@@ -98,6 +114,7 @@ class HungarianSolver extends AssignmentSolver<int> {
       for (int r = 0; r < size; ++r) {
         matrix[r][c] -= minVal;
       }
+      columnPotentials[c] += minVal;
     }
 
     // continue with [step2]
@@ -149,6 +166,7 @@ class HungarianSolver extends AssignmentSolver<int> {
       if (uncoveredZero == null) {
         return 6;
       } else {
+        counters.scanned++;
         row = uncoveredZero.key;
         col = uncoveredZero.value;
         mask[row][col] = 2;
@@ -192,6 +210,10 @@ class HungarianSolver extends AssignmentSolver<int> {
       }
     }
 
+    // the primed zeros of the path become stars
+    counters.augmentations++;
+    counters.pathLength += (path.length + 1) ~/ 2;
+
     _augmentPath(path);
     rowCover.fillRange(0, rowCover.length, 0);
     colCover.fillRange(0, colCover.length, 0);
@@ -202,6 +224,7 @@ class HungarianSolver extends AssignmentSolver<int> {
 
   /// internal method for solving step 6
   int _step6() {
+    counters.dualUpdates++;
     int minVal = _findSmallestUncovered();
     for (int r = 0; r < size; r++) {
       for (int c = 0; c < size; c++) {
@@ -210,6 +233,14 @@ class HungarianSolver extends AssignmentSolver<int> {
       }
     }
 
+    // covered rows lose and uncovered columns gain [minVal]
+    for (int r = 0; r < size; r++) {
+      if (rowCover[r] == 1) rowPotentials[r] -= minVal;
+    }
+    for (int c = 0; c < size; c++) {
+      if (colCover[c] == 0) columnPotentials[c] += minVal;
+    }
+
     return 4;
   }
 
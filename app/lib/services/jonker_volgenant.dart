@@ -0,0 +1,142 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+import '../model/solver.dart';
+import 'native_core.dart';
+
+/// solver using the O(n³) shortest augmenting path method of the native core
+///
+/// flat problems that are not quadratic are solved without padding in
+/// O(min(m, n)² max(m, n)). the solver only looks up the native core when
+/// solving, so it can be sent to background isolates
+class JonkerVolgenantSolver extends AssignmentSolver<int>
+    implements RectangularAssignmentSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  @override
+  AssignmentResult solve(Matrix<int> problem) {
+    if (!problem.dimension.isQuadratic || problem.dimension.n < 2) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+
+    int n = problem.dimension.n;
+
+    Pointer<Int64> costs = calloc<Int64>(n * n);
+    Pointer<Int32> rowToCol = calloc<Int32>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+
+    try {
+      // copy problem into a flat row-major buffer
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          costs[i * n + j] = problem[i][j];
+        }
+      }
+
+      int status = core.solveAssignment(costs, n, rowToCol, totalCost);
+      if (status == NativeCore.errorInvalidArgument) {
+        throw ArgumentError("The costs are too large to be solved.");
+      }
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem);
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int i = 0; i < n; i++) {
+        result.assignments.add(
+          MapEntry<int, int>(i, rowToCol[i]),
+        );
+      }
+
+      return result;
+    } finally {
+      calloc.free(costs);
+      calloc.free(rowToCol);
+      calloc.free(totalCost);
+    }
+  }
+
+  @override
+  AssignmentResult solveFlat(FlatMatrix problem) {
+    int m = problem.dimension.m;
+    int n = problem.dimension.n;
+    if (m < 1 || n < 1 || (m == n && n < 2)) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+
+    Pointer<Int32> rowToCol = calloc<Int32>(m);
+    Pointer<Int64> rowPotentials = calloc<Int64>(m);
+    Pointer<Int64> columnPotentials = calloc<Int64>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+
+    try {
+      // the solver reads the buffer of the problem directly, the duals of
+      // quadratic problems are kept for the sensitivity analysis
+      int status = m == n
+          ? core.solveAssignmentDualsI32(
+              problem.address,
+              n,
+              problem.stride,
+              rowToCol,
+              rowPotentials,
+              columnPotentials,
+              totalCost,
+            )
+          : core.solveRectangularI32(
+              problem.address,
+              m,
+              n,
+              problem.stride,
+              rowToCol,
+              totalCost,
+            );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem.asMatrix());
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+      if (m == n) {
+        result.rowPotentials = rowPotentials.asTypedList(n).toList();
+        result.columnPotentials = columnPotentials.asTypedList(n).toList();
+      }
+
+      // the larger side keeps the entries without a match
+      List<bool> matchedColumns = List.filled(n, false);
+      for (int i = 0; i < m; i++) {
+        if (rowToCol[i] < 0) {
+          result.unmatchedRows.add(i);
+          continue;
+        }
+
+        result.assignments.add(
+          MapEntry<int, int>(i, rowToCol[i]),
+        );
+        matchedColumns[rowToCol[i]] = true;
+      }
+      for (int j = 0; j < n; j++) {
+        if (!matchedColumns[j]) result.unmatchedColumns.add(j);
+      }
+
+      return result;
+    } finally {
+      calloc.free(rowToCol);
+      calloc.free(rowPotentials);
+      calloc.free(columnPotentials);
+      calloc.free(totalCost);
+    }
+  }
+}
@@ -0,0 +1,92 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/profile.dart';
+import '../model/result.dart';
+import 'native_core.dart';
+
+/// solver for the [k] cheapest assignments of a problem using the native
+/// partitioning of Murty
+///
+/// after the optimum is found, the remaining assignments are split into
+/// disjoint subproblems that inherit its dual potentials, so each of them is
+/// solved by a single shortest path search. the searches run on several
+/// threads and subproblems that cannot be among the [k] cheapest are dropped
+/// early. the solver only looks up the native core when solving, so it can
+/// be sent to background isolates
+class KBestSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  /// largest number of assignments to find
+  final int k;
+
+  /// only find assignments costing at most this much more than the optimum,
+  /// 0 finds the assignments tied with it and null does not limit them
+  final int? maxGap;
+
+  /// number of search threads, one per hardware thread if it is < 1
+  final int threads;
+
+  KBestSolver(this.k, {this.maxGap, this.threads = 0});
+
+  /// solve [problem] and return the up to [k] cheapest assignments ordered by
+  /// costs, ties are ordered the same way on every run
+  List<AssignmentResult> solveFlat(FlatMatrix problem) {
+    if (!problem.dimension.isQuadratic || problem.dimension.n < 1 || k < 1) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+    int n = problem.dimension.n;
+
+    Pointer<Int32> rowToCols = calloc<Int32>(k * n);
+    Pointer<Int64> totalCosts = calloc<Int64>(k);
+    Pointer<Int32> count = calloc<Int32>();
+
+    try {
+      // the solver reads the buffer of the problem directly
+      int status = core.solveKBestI32(
+        problem.address,
+        n,
+        problem.stride,
+        k,
+        maxGap ?? -1,
+        threads,
+        rowToCols,
+        totalCosts,
+        count,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      // all assignments share the copy of the problem and the counters
+      Matrix<int> matrix = problem.asMatrix();
+      SolverCounters counters = core.lastSolverCounters();
+      List<AssignmentResult> results = [];
+      for (int r = 0; r < count.value; r++) {
+        AssignmentResult result = AssignmentResult(matrix);
+        result.costs = totalCosts[r];
+        result.counters = counters;
+
+        for (int i = 0; i < n; i++) {
+          result.assignments.add(
+            MapEntry<int, int>(i, rowToCols[r * n + i]),
+          );
+        }
+
+        results.add(result);
+      }
+
+      return results;
+    } finally {
+      calloc.free(rowToCols);
+      calloc.free(totalCosts);
+      calloc.free(count);
+    }
+  }
+}
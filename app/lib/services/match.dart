@@ -1,13 +1,35 @@
 import 'dart:async';
+import 'dart:isolate';
+import 'dart:math';
+import 'dart:typed_data';
 
 import 'package:file_picker/file_picker.dart';
 import 'package:flutter/widgets.dart';
 
+import '../model/cancelled_exception.dart';
+import '../model/cost_view.dart';
+import '../model/fingerprint.dart';
+import '../model/flat_matrix.dart';
+import '../model/infeasible_exception.dart';
 import '../model/input_file.dart';
 import '../model/matrix.dart';
+import '../model/profile.dart';
 import '../model/result.dart';
+import '../model/score_expression.dart';
+import '../model/solve_progress.dart';
 import '../model/solver.dart';
+import '../model/sparse_matrix.dart';
+import '../model/too_large_exception.dart';
+import 'components.dart';
 import 'hungarian.dart';
+import 'jonker_volgenant.dart';
+import 'k_best.dart';
+import 'min_cost_flow.dart';
+import 'sensitivity.dart';
+import 'solution_cache.dart';
+import 'solver_channel.dart';
+import 'sparse.dart';
+import 'warm_start.dart';
 
 class MatchService extends ChangeNotifier {
   // file holding the data to work with
@@ -17,11 +39,21 @@ class MatchService extends ChangeNotifier {
   /// callback if errors occur
   final void Function(dynamic exception)? onError;
 
+  /// callback with the [profile] after each run
+  final void Function(MatchProfile profile)? onProfile;
+
+  /// timings and solver counters of the stages of the last run
+  final MatchProfile profile = MatchProfile();
+
   /// flag wether to skip step 3
   final bool fastForward;
 
   /// bonus for direct matches
-  final int directMatchBonus;
+  int _directMatchBonus;
+  int get directMatchBonus => _directMatchBonus;
+
+  /// score of vetoes and of entries added to make matrices quadratic
+  static const int vetoScore = -100;
 
   /// flag to prevent multiple runs at once
   bool _running = false;
@@ -56,28 +88,173 @@ class MatchService extends ChangeNotifier {
     "a + b": (a, b) => a + b,
     "a * b": (a, b) => a * b,
     "sign(a) * sign(b) * a * b": (a, b) => ((a < 0 || b < 0) ? -1 : 1) * a * b,
-    "a + b - abs(a - b) / 3": (a, b) => (a + b - (a - b).abs() / 3).toInt(),
+    "3 * (a + b) - abs(a - b)": (a, b) => 3 * (a + b) - (a - b).abs(),
   };
   Iterable<String> get combinationFunctionDescriptions =>
       _combinationFunctions.keys;
 
-  /// matrices of the problems [max, min]
-  final List<MapEntry<Matrix<int>, Matrix<int>>> problems = [];
+  /// matrices of the problems [max, min] by their description
+  final Map<String, MapEntry<Matrix<int>, Matrix<int>>> problems = {};
 
   /// used solver
-  final AssignmentSolver<int> _solver = HungarianSolver();
+  final AssignmentSolver<int> _solver;
+
+  /// used solver for multiple matches per entry, if null columns are copied
+  final CapacitatedAssignmentSolver<int>? _capacitySolver;
+
+  /// flag wether the current problems are solved with [_capacitySolver]
+  bool _capacitated = false;
+
+  /// flag wether the current problems are solved by a
+  /// [RectangularAssignmentSolver] without padding them to become quadratic
+  bool _rectangular = false;
+
+  /// flag wether quadratic problems that split into several independent ones
+  /// are solved by a [ComponentSolver], which replaces the default solvers
+  final bool _decompose;
+
+  /// merge operations whose current problems are solved by a
+  /// [ComponentSolver]
+  Set<String> _decomposedProblems = {};
+
+  /// flag wether to solve the problems concurrently in background isolates
+  final bool parallel;
+
+  /// flag wether each problem is solved by its own [WarmStartSolver], so
+  /// matching again after small changes only repairs the changed parts
+  final bool _warmStart;
+
+  /// solvers keeping the state of the last solve by problem description
+  final Map<String, WarmStartSolver> _warmStartSolvers = {};
 
-  /// solutions of the min problems
+  /// flag wether vetoes are left out of the problems and solved by the
+  /// [SparseShortestPathSolver], entries that cannot be matched without a
+  /// veto are then reported as [InfeasibleMatchException] instead
+  final bool _sparse;
+  bool get sparse => _sparse;
+
+  /// solver of the next best assignments of each problem, null if only the
+  /// best one is searched
+  final KBestSolver? _kBestSolver;
+
+  /// solver of the quadratic problems on native worker threads of the
+  /// runner, it replaces the warm start solvers if set
+  final ChannelSolver? _channelSolver;
+
+  /// progress of the problems solved by [_channelSolver] by description,
+  /// removed once they are solved
+  final Map<String, SolveProgress> progress = {};
+
+  /// flag wether the current run can be cancelled
+  bool get cancellable => _running && (_channelSolver?.running ?? false);
+
+  /// flag wether the current run was cancelled
+  bool _cancelled = false;
+
+  /// solutions of problems solved before, so matching an unchanged input
+  /// again returns them without solving, null if they are not cached
+  final SolutionCache? _solutionCache;
+
+  /// fingerprint of the input of the current problems except their merge
+  /// operation, null if solutions are not cached
+  int? _inputFingerprint;
+
+  /// solutions of the min problems in order of completion
   final List<AssignmentResult> solutions = [];
 
+  /// get the solution of the problem with [description] if it is solved
+  AssignmentResult? solutionOf(String description) => solutions
+      .where(
+        (solution) => solution.problemOperatrionDescription == description,
+      )
+      .firstOrNull;
+
+  /// margins of the solutions by description, computed once on request
+  final Map<String, Future<Matrix<int>>> _sensitivities = {};
+
+  /// flag wether the solution of the problem with [description] is a
+  /// complete assignment of a quadratic problem, whose margins can be
+  /// computed by [sensitivityOf]
+  bool hasSensitivity(String description) {
+    AssignmentResult? solution = solutionOf(description);
+    Matrix<int>? problem = solution?.problem;
+
+    return solution != null &&
+        problem != null &&
+        problem.dimension.isQuadratic &&
+        solution.assignments.length == problem.dimension.n;
+  }
+
+  /// get the margins of the pairs of the solution of the problem with
+  /// [description], see [SensitivityAnalysis]. they are computed on the
+  /// first request, which fails if not [hasSensitivity]
+  Future<Matrix<int>> sensitivityOf(String description) {
+    AssignmentResult? solution = solutionOf(description);
+    if (solution == null || !hasSensitivity(description)) {
+      return Future.error(
+        ArgumentError("No complete assignment of $description."),
+      );
+    }
+
+    return _sensitivities.putIfAbsent(
+      description,
+      () => parallel
+          ? Isolate.run(() => _analyzeSensitivity(solution))
+          : Future.value(_analyzeSensitivity(solution)),
+    );
+  }
+
   MatchService({
     InputFile? file,
     this.onError,
+    this.onProfile,
     this.fastForward = false,
-    this.directMatchBonus = 10,
+    int directMatchBonus = 10,
     bool fastStart = false,
+    this.parallel = true,
+    bool warmStart = true,
+    bool sparse = false,
+    List<ScoreExpression> scores = const [],
+    int kBest = 1,
+    int? maxGap,
+    bool background = false,
+    bool cacheSolutions = true,
+    String? solutionCacheDirectory,
+    AssignmentSolver<int>? solver,
+    CapacitatedAssignmentSolver<int>? capacitySolver,
   })  : _file = file,
+        _directMatchBonus = directMatchBonus,
+        _warmStart =
+            warmStart && solver == null && WarmStartSolver.isAvailable,
+        _decompose = solver == null && ComponentSolver.isAvailable,
+        _channelSolver = background &&
+                warmStart &&
+                solver == null &&
+                ChannelSolver.isAvailable
+            ? ChannelSolver()
+            : null,
+        _sparse = sparse && SparseShortestPathSolver.isAvailable,
+        _kBestSolver = kBest > 1 && KBestSolver.isAvailable
+            ? KBestSolver(kBest, maxGap: maxGap)
+            : null,
+        _solutionCache = cacheSolutions
+            ? SolutionCache(directory: solutionCacheDirectory)
+            : null,
+        _solver = solver ?? _defaultSolver(),
+        _capacitySolver = capacitySolver ?? _defaultCapacitySolver(),
         _activeStep = file != null ? 1 : 0 {
+    // add user defined scores after the built-in ones, unless they only
+    // differ from a known one in spacing or parentheses
+    Set<String> known = {
+      for (String description in _combinationFunctions.keys)
+        ScoreExpression.parse(description).postfix,
+    };
+    for (ScoreExpression score in scores) {
+      if (known.add(score.postfix)) {
+        _combinationFunctions[score.text] = score.call;
+      }
+    }
+
     if (fastStart) {
       unawaited(
         run(),
@@ -102,13 +279,53 @@ class MatchService extends ChangeNotifier {
     notifyListeners();
 
     // run the matching steps
+    _cancelled = false;
+    profile.clear();
     await _runSteps();
+    if (onProfile != null && profile.stages.isNotEmpty) onProfile!(profile);
 
     // notify done
     _running = false;
     notifyListeners();
   }
 
+  /// method to change a single rating of the loaded [table] (0: wgs,
+  /// 1: persons) and to match again, only the affected parts of the
+  /// problems are solved again
+  Future<void> updateRating(int table, int row, int column, int rating) async {
+    if (_running || _tables == null || _activeStep < 3) return;
+
+    _tables![table][row][column] = rating;
+    await run(3);
+  }
+
+  /// method to change the [directMatchBonus] and to match again
+  Future<void> updateDirectMatchBonus(int bonus) async {
+    if (_running) return;
+
+    _directMatchBonus = bonus;
+    if (_tables != null && _activeStep >= 3) await run(3);
+  }
+
+  /// method to cancel the solves of the current run, the problems that are
+  /// not solved yet are left without a solution until the next run
+  Future<void> cancel() async {
+    if (!cancellable) return;
+
+    _cancelled = true;
+    await _channelSolver!.cancel();
+  }
+
+  @override
+  void dispose() {
+    for (WarmStartSolver solver in _warmStartSolvers.values) {
+      solver.dispose();
+    }
+    _warmStartSolvers.clear();
+
+    super.dispose();
+  }
+
   /// internal method to run the actual matching steps
   Future<void> _runSteps() async {
     // select file
@@ -121,7 +338,7 @@ class MatchService extends ChangeNotifier {
 
     // load file content
     if (_activeStep == 1) {
-      await _load();
+      await profile.measureAsync("load", _load);
       if (_file!.error == null) {
         _continue(1);
       } else {
@@ -143,18 +360,58 @@ class MatchService extends ChangeNotifier {
 
     // transform data
     if (_activeStep == 3) {
-      await _processExtrema();
-      _copyColumns();
+      profile.measure("reset", _resetMatrices);
+      await profile.measureAsync("extrema", _processExtrema);
+
+      // multiple matches are either handled by the capacity solver or by
+      // copying columns and solving the quadratic problem, the sparse solver
+      // works on copied columns without padding. the capacity solver scans
+      // every entry once instead of once per copy, so it is preferred
+      _capacitated =
+          !_sparse && _capacitySolver != null && _hasMultipleMatches;
 
-      // make matrices quadratic
-      if (!_matrixA!.dimension.isQuadratic) {
-        _matrixA = _matrixA!.quadratic(-100);
+      if (!_capacitated) {
+        profile.measure("copy columns", _copyColumns);
       }
 
-      if (!_matrixB!.dimension.isQuadratic) {
-        _matrixB = _matrixB!.quadratic(-100);
+      // rectangular solvers leave the entries without a match unassigned
+      // instead of matching them with padding entries
+      _rectangular = !_capacitated &&
+          !_sparse &&
+          _kBestSolver == null &&
+          _solver is RectangularAssignmentSolver &&
+          !_matrixA!.dimension.isQuadratic;
+
+      if (!_capacitated && !_sparse && !_rectangular) {
+        // make matrices quadratic
+        profile.measure("quadratic", () {
+          if (!_matrixA!.dimension.isQuadratic) {
+            _matrixA = _matrixA!.quadratic(vetoScore);
+          }
+
+          if (!_matrixB!.dimension.isQuadratic) {
+            _matrixB = _matrixB!.quadratic(vetoScore);
+          }
+        });
       }
 
+      // vetoes and padding can split the problems into independent ones,
+      // which are solved faster on their own than warm started as a whole.
+      // whether a veto has the largest cost depends on the merge operation,
+      // so each problem is split on its own
+      _decomposedProblems = _decompose &&
+              !_capacitated &&
+              !_sparse &&
+              !_rectangular &&
+              _kBestSolver == null
+          ? profile.measure("components", () => {
+                for (String problemOperatrionDescription
+                    in combinationFunctionDescriptions)
+                  if (_countComponents(problemOperatrionDescription) > 1)
+                    problemOperatrionDescription,
+              })
+          : <String>{};
+
       _continue(1);
     }
 
@@ -163,42 +420,471 @@ class MatchService extends ChangeNotifier {
       // remove old problems
       problems.clear();
       solutions.clear();
+      _sensitivities.clear();
 
-      for (int i = 0; i < combinationFunctionDescriptions.length; i++) {
-        // get string describing the problem merge operation
-        String problemOperatrionDescription =
-            combinationFunctionDescriptions.elementAt(i);
+      _inputFingerprint = _solutionCache == null
+          ? null
+          : profile.measure("fingerprint", _fingerprintInput);
 
-        // define max problem
-        Matrix<int> problem = _matrixA!.combine(
-          _matrixB!.transpose(),
-          _combinationFunctions[problemOperatrionDescription]!,
-        );
+      // the problems are independent, so they are built and solved
+      // concurrently and added to [solutions] as soon as they are done
+      await profile.measureAsync(
+        "match",
+        () => Future.wait(
+          [
+            for (String problemOperatrionDescription
+                in combinationFunctionDescriptions)
+              _match(problemOperatrionDescription),
+          ],
+        ),
+      );
 
-        // define min problem
-        Matrix<int> inverseProblem = _invertProblem(problem);
+      // wait for the next run to solve the cancelled problems
+      if (_cancelled) return;
 
-        // add problems
-        problems.add(
-          MapEntry(
-            problem,
-            inverseProblem,
-          ),
-        );
+      // finished
+      _continue(1);
+    }
+  }
+
+  /// internal method to compute the margins of [solution], it must not
+  /// capture the service to be able to run in a background isolate
+  static Matrix<int> _analyzeSensitivity(AssignmentResult solution) =>
+      const SensitivityAnalysis().analyze(solution);
+
+  /// internal method to select the native solver if the core is available
+  static AssignmentSolver<int> _defaultSolver() =>
+      JonkerVolgenantSolver.isAvailable
+          ? JonkerVolgenantSolver()
+          : HungarianSolver();
+
+  /// internal method to select the native capacity solver if available
+  static CapacitatedAssignmentSolver<int>? _defaultCapacitySolver() =>
+      MinCostFlowSolver.isAvailable ? MinCostFlowSolver() : null;
+
+  /// internal method to count the independent problems the problem of
+  /// [problemOperatrionDescription] splits into, cells are joined unless they
+  /// have the largest cost of the min problem like in the [ComponentSolver]
+  int _countComponents(String problemOperatrionDescription) {
+    CostView inverseProblem = CostView(
+      _matrixA!,
+      _matrixB!,
+      _combinationFunctions[problemOperatrionDescription]!,
+    ).inverted();
+    int largest = inverseProblem.largestEntry();
+
+    return ComponentSolver.countComponents(
+      inverseProblem.dimension.m,
+      inverseProblem.dimension.n,
+      (i, j) => inverseProblem.at(i, j) != largest,
+    );
+  }
+
+  /// flag wether any entry should be matched multiple times
+  bool get _hasMultipleMatches =>
+      matrixRowHeaderMapA.values.any((count) => count > 1) ||
+      matrixRowHeaderMapB.values.any((count) => count > 1);
+
+  /// internal method to build and solve the problem of one merge operation
+  Future<void> _match(String problemOperatrionDescription) async {
+    bool onChannel = _solvesOnChannel(problemOperatrionDescription);
+    _MatchJob job = _MatchJob(
+      problemOperatrionDescription: problemOperatrionDescription,
+      matrixA: _matrixA!,
+      matrixB: _matrixB!,
+      combination: _combinationFunctions[problemOperatrionDescription]!,
+      solver: _decomposedProblems.contains(problemOperatrionDescription)
+          // the problems are already solved concurrently if parallel
+          ? ComponentSolver(threads: parallel ? 1 : 0)
+          : _warmStart && !_sparse && !_rectangular && !onChannel
+              ? _warmStartSolvers.putIfAbsent(
+                  problemOperatrionDescription,
+                  () => WarmStartSolver(),
+                )
+              : _solver,
+      capacitySolver: _capacitated ? _capacitySolver : null,
+      sparseSolver: _sparse ? SparseShortestPathSolver() : null,
+      kBestSolver: _capacitated || _sparse ? null : _kBestSolver,
+      rowCapacities: _rowCapacities,
+      columnCapacities: _columnCapacities,
+    );
+
+    // problems solved before with the same input are taken from the cache
+    int? fingerprint = _inputFingerprint == null
+        ? null
+        : (Fingerprint(_inputFingerprint)
+              ..addString(problemOperatrionDescription))
+            .value;
+    _MatchJobResult? cached = fingerprint == null
+        ? null
+        : await _matchFromCache(job, fingerprint);
 
-        // add solution
-        solutions.add(
-          _solver.solve(
-            inverseProblem,
-          )..problemOperatrionDescription = problemOperatrionDescription,
+    _MatchJobResult result;
+    if (cached != null) {
+      result = cached;
+    } else {
+      try {
+        result = onChannel
+            ? await _matchOnChannel(job, problemOperatrionDescription)
+            : parallel
+                ? await Isolate.run(() => _runMatchJob(job))
+                : _runMatchJob(job);
+      } on MatchCancelledException {
+        progress.remove(problemOperatrionDescription);
+        notifyListeners();
+        return;
+      } on ScoresTooLargeException catch (e) {
+        progress.remove(problemOperatrionDescription);
+        notifyListeners();
+        if (onError == null) rethrow;
+        onError!(e);
+        return;
+      }
+
+      if (fingerprint != null) {
+        await _solutionCache!.store(fingerprint, result.$3);
+      }
+    }
+
+    // add problems
+    problems[problemOperatrionDescription] = MapEntry(
+      result.$1,
+      result.$2,
+    );
+
+    // add solution
+    solutions.add(
+      result.$3..problemOperatrionDescription = problemOperatrionDescription,
+    );
+
+    // add the stages of the job, named after the problem
+    for (StageProfile stage in result.$4) {
+      profile.stages.add(
+        StageProfile(
+          "${stage.name} $problemOperatrionDescription",
+          stage.elapsed,
+          stage.allocated,
+        ),
+      );
+    }
+    profile.counters[problemOperatrionDescription] = result.$3.counters;
+
+    notifyListeners();
+
+    // report entries without a match
+    if (!result.$3.feasible && onError != null) {
+      onError!(
+        InfeasibleMatchException(
+          problemOperatrionDescription,
+          [for (int i in result.$3.unassignedRows) matrixRowHeaderB[i]],
+        ),
+      );
+    }
+  }
+
+  /// number of matches of the rows (B entries) of the current problems
+  List<int> get _rowCapacities => [
+        for (int i = 0; i < _matrixA!.dimension.m; i++)
+          matrixRowHeaderMapB[i] ?? 1,
+      ];
+
+  /// number of matches of the columns (A entries) of the current problems
+  List<int> get _columnCapacities => [
+        for (int j = 0; j < _matrixA!.dimension.n; j++)
+          matrixRowHeaderMapA[j] ?? 1,
+      ];
+
+  /// internal method to compute the fingerprint of everything the solutions
+  /// of the current problems depend on except their merge operation: the
+  /// matrices, which include the direct match bonus and the copied columns,
+  /// the number of matches of each entry and the solvers
+  int _fingerprintInput() {
+    Fingerprint fingerprint = Fingerprint()
+      ..addMatrix(_matrixA!)
+      ..addMatrix(_matrixB!)
+      ..addInt(directMatchBonus)
+      ..addInts(_rowCapacities)
+      ..addInts(_columnCapacities)
+      ..addString(
+        "$_capacitated $_sparse $_rectangular $_decompose "
+        "${_kBestSolver?.k} ${_kBestSolver?.maxGap} "
+        "${_solver.runtimeType} ${_capacitySolver.runtimeType}",
+      );
+
+    return fingerprint.value;
+  }
+
+  /// internal method to get the result of [job] from the cached solution of
+  /// [fingerprint], null if it is not cached
+  Future<_MatchJobResult?> _matchFromCache(
+    _MatchJob job,
+    int fingerprint,
+  ) async {
+    var (solution, stage) = await StageProfile.measureAsync(
+      "cache",
+      () => _solutionCache!.lookup(fingerprint),
+    );
+    if (solution == null) return null;
+
+    // the problems are lazy views, so they are rebuilt at almost no cost
+    CostView problem = CostView(job.matrixA, job.matrixB, job.combination);
+    CostView inverseProblem = job.capacitySolver == null
+        ? problem.inverted()
+        : problem.inverted(_capacitatedInversion(job, problem).$1);
+
+    // a solution of another problem with the same fingerprint is ignored
+    if (!solution.fits(inverseProblem.dimension)) return null;
+
+    return (
+      problem.asMatrix(),
+      inverseProblem.asMatrix(),
+      solution.toResult(inverseProblem.asMatrix()),
+      [stage],
+    );
+  }
+
+  /// flag wether the current problem of [problemOperatrionDescription] is
+  /// solved by [_channelSolver], which only solves quadratic problems for the
+  /// best assignment
+  bool _solvesOnChannel(String problemOperatrionDescription) =>
+      _channelSolver != null &&
+      !_capacitated &&
+      !_sparse &&
+      !_rectangular &&
+      !_decomposedProblems.contains(problemOperatrionDescription) &&
+      _kBestSolver == null;
+
+  /// internal method to solve the problem of [job] with a native job of the
+  /// runner and to report its [progress]
+  Future<_MatchJobResult> _matchOnChannel(
+    _MatchJob job,
+    String problemOperatrionDescription,
+  ) async {
+    var (maxProblem, costs, stages) = parallel
+        ? await Isolate.run(() => _buildChannelJob(job))
+        : _buildChannelJob(job);
+
+    // costs that do not fit into the buffer are solved with 64 bits instead
+    if (costs == null) {
+      return parallel
+          ? await Isolate.run(() => _runMatchJob(job))
+          : _runMatchJob(job);
+    }
+
+    var (result, stage) = await StageProfile.measureAsync(
+      "solve",
+      () => _channelSolver!.solve(
+        costs,
+        maxProblem.dimension.n,
+        key: problemOperatrionDescription,
+        onProgress: (update) {
+          progress[problemOperatrionDescription] = update;
+          notifyListeners();
+        },
+      ),
+    );
+    stages.add(stage);
+    progress.remove(problemOperatrionDescription);
+
+    return (maxProblem, result.problem!, result, stages);
+  }
+
+  /// internal method to compute the min problem of [job] into a row-major
+  /// buffer for [_matchOnChannel], the buffer is null if a cost does not fit
+  /// into 32 bits. it must not capture the service to be able to run in a
+  /// background isolate
+  static (Matrix<int>, Int32List?, List<StageProfile>) _buildChannelJob(
+    _MatchJob job,
+  ) {
+    CostView problem = CostView(job.matrixA, job.matrixB, job.combination);
+    int n = problem.dimension.n;
+
+    var (costs, stage) = StageProfile.measure("build", () {
+      CostView inverseProblem = problem.inverted();
+      Int32List costs = Int32List(n * n);
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          int value = inverseProblem.at(i, j);
+          if (value < FlatMatrix.minValue || value > FlatMatrix.maxValue) {
+            return null;
+          }
+          costs[i * n + j] = value;
+        }
+      }
+      return costs;
+    });
+
+    return (problem.asMatrix(), costs, [stage]);
+  }
+
+  /// internal method doing the work of [_match], it must not capture the
+  /// service to be able to run in a background isolate
+  static _MatchJobResult _runMatchJob(_MatchJob job) {
+    // the problems are built and solved in separate stages, they are named
+    // after the problem by [_match]
+    List<StageProfile> stages = [];
+    T measure<T>(String name, T Function() stage) {
+      var (value, profile) = StageProfile.measure(name, stage);
+      stages.add(profile);
+      return value;
+    }
+
+    // the max and min problems are lazy views on the input matrices, the
+    // costs are only stored once in the workspace of the solver
+    CostView problem = CostView(job.matrixA, job.matrixB, job.combination);
+
+    // vetoes are left out of the problem of the sparse solver
+    SparseAssignmentSolver? sparseSolver = job.sparseSolver;
+    if (sparseSolver != null) {
+      CostView inverseProblem = problem.inverted();
+      SparseMatrix sparseProblem = measure(
+        "build",
+        () => SparseMatrix.fromMatrix(
+          inverseProblem.asMatrix(),
+          (i, j) => job.matrixA[i][j] != vetoScore,
+        ),
+      );
+
+      return (
+        problem.asMatrix(),
+        inverseProblem.asMatrix(),
+        measure("solve", () {
+          try {
+            return sparseSolver.solveSparse(sparseProblem);
+          } on ArgumentError {
+            throw ScoresTooLargeException(job.problemOperatrionDescription);
+          }
+        }),
+        stages,
+      );
+    }
+
+    // the next best assignments are found along with the best one, they are
+    // attached to it as alternatives
+    KBestSolver? kBestSolver = job.kBestSolver;
+    if (job.capacitySolver == null && kBestSolver != null) {
+      FlatMatrix? inverseProblem =
+          measure("build", () => FlatMatrix.tryFromView(problem.inverted()));
+      if (inverseProblem == null) {
+        throw ScoresTooLargeException(job.problemOperatrionDescription);
+      }
+      List<AssignmentResult> results =
+          measure("solve", () => kBestSolver.solveFlat(inverseProblem));
+
+      return (
+        problem.asMatrix(),
+        inverseProblem.asMatrix(),
+        results.first..alternatives.addAll(results.skip(1)),
+        stages,
+      );
+    }
+
+    // flat solvers read the min problem computed once into a flat matrix
+    AssignmentSolver<int> solver = job.solver;
+    if (job.capacitySolver == null && solver is FlatAssignmentSolver) {
+      FlatMatrix? inverseProblem =
+          measure("build", () => FlatMatrix.tryFromView(problem.inverted()));
+
+      // costs that do not fit into 32 bits are solved with 64 bits instead
+      if (inverseProblem == null) {
+        Matrix<int> wideProblem = problem.inverted().asMatrix();
+
+        return (
+          problem.asMatrix(),
+          wideProblem,
+          measure("solve", () => _solveWide(job, wideProblem)),
+          stages,
         );
       }
 
-      // finished
-      _continue(1);
+      return (
+        problem.asMatrix(),
+        inverseProblem.asMatrix(),
+        measure(
+          "solve",
+          () => (solver as FlatAssignmentSolver).solveFlat(inverseProblem),
+        ),
+        stages,
+      );
+    }
+
+    CapacitatedAssignmentSolver<int>? capacitySolver = job.capacitySolver;
+    if (capacitySolver == null) {
+      // define min problem
+      Matrix<int> inverseProblem =
+          measure("build", () => problem.inverted().asMatrix());
+
+      return (
+        problem.asMatrix(),
+        inverseProblem,
+        measure("solve", () => job.solver.solve(inverseProblem)),
+        stages,
+      );
+    }
+
+    // define min problem with the same largest entry as the padded problem
+    var (largest, padding, pseudoMatches) =
+        measure("build", () => _capacitatedInversion(job, problem));
+    CostView inverseProblem = problem.inverted(largest);
+
+    AssignmentResult result = measure(
+      "solve",
+      () => capacitySolver.solve(
+        inverseProblem.asMatrix(),
+        job.rowCapacities,
+        job.columnCapacities,
+      ),
+    );
+
+    // add the costs of the pseudo matches to get the same costs
+    if (padding != null) {
+      result.costs += pseudoMatches * (largest - padding);
+    }
+
+    return (problem.asMatrix(), inverseProblem.asMatrix(), result, stages);
+  }
+
+  /// internal method to solve the min problem [inverseProblem] of [job] whose
+  /// costs do not fit into 32 bits with 64 bit costs, it throws a
+  /// [ScoresTooLargeException] if the costs are too large for that as well
+  static AssignmentResult _solveWide(
+    _MatchJob job,
+    Matrix<int> inverseProblem,
+  ) {
+    if (!inverseProblem.dimension.isQuadratic ||
+        inverseProblem.dimension.n < 2) {
+      throw ScoresTooLargeException(job.problemOperatrionDescription);
+    }
+
+    try {
+      return JonkerVolgenantSolver.isAvailable
+          ? JonkerVolgenantSolver().solve(inverseProblem)
+          : HungarianSolver().solve(inverseProblem);
+    } on ArgumentError {
+      throw ScoresTooLargeException(job.problemOperatrionDescription);
     }
   }
 
+  /// internal method to get the entry the min problem of the capacitated
+  /// [job] is inverted with, the score of its padding entries and their
+  /// number. the problem with copied columns is padded to become quadratic,
+  /// which adds |rows - columns| pseudo matches of padding entries, the
+  /// padding is null if there are none
+  static (int, int?, int) _capacitatedInversion(
+    _MatchJob job,
+    CostView problem,
+  ) {
+    int rows = job.rowCapacities.fold(0, (sum, count) => sum + count);
+    int columns = job.columnCapacities.fold(0, (sum, count) => sum + count);
+    int? padding =
+        rows != columns ? job.combination(vetoScore, vetoScore) : null;
+
+    int largest = problem.largestEntry();
+    if (padding != null) largest = max(largest, padding);
+
+    return (largest, padding, (rows - columns).abs());
+  }
+
   /// internal helper method to increment [activeStep] by [stepSize] and notify listeners
   void _continue(int stepSize) {
     _activeStep += stepSize;
@@ -235,10 +921,6 @@ class MatchService extends ChangeNotifier {
       // load tables
       _tables = await _file!.load();
 
-      // copy matrices to work with
-      _matrixA = tables?[0].copy();
-      _matrixB = tables?[1].copy();
-
       // initalize header A and its map
       for (int i = 0; i < _file!.wgs.length; i++) {
         matrixRowHeaderA.add(_file!.wgs[i]);
@@ -260,14 +942,26 @@ class MatchService extends ChangeNotifier {
     }
   }
 
+  /// internal method to start the transformation from the loaded tables, so
+  /// it can be repeated after changes
+  void _resetMatrices() {
+    // copy matrices to work with
+    _matrixA = tables![0].copy();
+    _matrixB = tables![1].copy();
+
+    // remove names of copied columns
+    matrixRowHeaderA.length = _file!.wgs.length;
+    matrixRowHeaderB.length = _file!.persons.length;
+  }
+
   /// internal method to modify extrema
   Future<void> _processExtrema() async {
     // adjust values for vetos and perfect matches
     for (int i = 0; i < matrixA!.dimension.m; i++) {
       for (int j = 0; j < matrixA!.dimension.n; j++) {
         if (matrixA![i][j] == 0 || matrixB![j][i] == 0) {
-          matrixA![i][j] = -100;
-          matrixB![j][i] = -100;
+          matrixA![i][j] = vetoScore;
+          matrixB![j][i] = vetoScore;
         } else if (matrixA![i][j] == 15 || matrixB![j][i] == 15) {
           matrixA![i][j] += directMatchBonus;
           matrixB![j][i] += directMatchBonus;
@@ -314,12 +1008,56 @@ class MatchService extends ChangeNotifier {
       }
     }
   }
+}
+
+/// input of a match job, it is sent to background isolates
+class _MatchJob {
+  /// description of the merge operation of the problem
+  final String problemOperatrionDescription;
+
+  /// matrices to combine
+  final Matrix<int> matrixA;
+  final Matrix<int> matrixB;
+
+  /// merge operation
+  final int Function(int, int) combination;
+
+  /// solver of quadratic problems
+  final AssignmentSolver<int> solver;
 
-  /// internal method to make minimize problem out of maximize problem
-  Matrix<int> _invertProblem(Matrix<int> problem) =>
-      Matrix(
-        problem.dimension,
-        fillValue: problem.largestEntry(),
-      ) -
-      problem;
+  /// solver of problems with multiple matches, used if set
+  final CapacitatedAssignmentSolver<int>? capacitySolver;
+
+  /// solver of problems without vetoes, used before all others if set
+  final SparseAssignmentSolver? sparseSolver;
+
+  /// solver of the next best assignments of quadratic problems, used before
+  /// [solver] if set
+  final KBestSolver? kBestSolver;
+
+  /// number of matches of the rows (B entries) and columns (A entries)
+  final List<int> rowCapacities;
+  final List<int> columnCapacities;
+
+  const _MatchJob({
+    required this.problemOperatrionDescription,
+    required this.matrixA,
+    required this.matrixB,
+    required this.combination,
+    required this.solver,
+    this.capacitySolver,
+    this.sparseSolver,
+    this.kBestSolver,
+    required this.rowCapacities,
+    required this.columnCapacities,
+  });
 }
+
+/// result of a match job: max problem, min problem, solution and the profiles
+/// of its stages
+typedef _MatchJobResult = (
+  Matrix<int>,
+  Matrix<int>,
+  AssignmentResult,
+  List<StageProfile>,
+);
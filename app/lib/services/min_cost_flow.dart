@@ -0,0 +1,99 @@
+import 'dart:ffi';
+import 'dart:math';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/matrix.dart';
+import '../model/result.dart';
+import '../model/solver.dart';
+import 'native_core.dart';
+
+/// solver using the native min-cost flow for entries with multiple matches
+///
+/// it gives the same result as solving the problem with copied rows and
+/// columns, but never builds the copied matrix
+class MinCostFlowSolver extends CapacitatedAssignmentSolver<int> {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  @override
+  AssignmentResult solve(
+    Matrix<int> problem,
+    List<int> rowCapacities,
+    List<int> columnCapacities,
+  ) {
+    int m = problem.dimension.m;
+    int n = problem.dimension.n;
+
+    if (rowCapacities.length != m || columnCapacities.length != n) {
+      throw ArgumentError(
+        "Capacities must match the problem size (${problem.dimension}).",
+      );
+    }
+
+    // number of assigned units
+    int units = min(
+      rowCapacities.fold<int>(0, (sum, c) => sum + c),
+      columnCapacities.fold<int>(0, (sum, c) => sum + c),
+    );
+
+    NativeCore core = NativeCore.instance!;
+
+    Pointer<Int64> costs = calloc<Int64>(m * n);
+    Pointer<Int32> rowCapacitiesBuffer = calloc<Int32>(m);
+    Pointer<Int32> columnCapacitiesBuffer = calloc<Int32>(n);
+    Pointer<Int32> rows = calloc<Int32>(max(units, 1));
+    Pointer<Int32> columns = calloc<Int32>(max(units, 1));
+    Pointer<Int32> assignmentCount = calloc<Int32>();
+    Pointer<Int64> totalCost = calloc<Int64>();
+
+    try {
+      // copy problem into a flat row-major buffer
+      for (int i = 0; i < m; i++) {
+        rowCapacitiesBuffer[i] = rowCapacities[i];
+        for (int j = 0; j < n; j++) {
+          costs[i * n + j] = problem[i][j];
+        }
+      }
+
+      for (int j = 0; j < n; j++) {
+        columnCapacitiesBuffer[j] = columnCapacities[j];
+      }
+
+      int status = core.solveTransportation(
+        costs,
+        m,
+        n,
+        rowCapacitiesBuffer,
+        columnCapacitiesBuffer,
+        rows,
+        columns,
+        assignmentCount,
+        totalCost,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem);
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int k = 0; k < assignmentCount.value; k++) {
+        result.assignments.add(
+          MapEntry<int, int>(rows[k], columns[k]),
+        );
+      }
+
+      return result;
+    } finally {
+      calloc.free(costs);
+      calloc.free(rowCapacitiesBuffer);
+      calloc.free(columnCapacitiesBuffer);
+      calloc.free(rows);
+      calloc.free(columns);
+      calloc.free(assignmentCount);
+      calloc.free(totalCost);
+    }
+  }
+}
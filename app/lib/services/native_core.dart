@@ -0,0 +1,571 @@
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/profile.dart';
+
+/// opaque handle of an input file loaded by the native core
+final class BelegiumInput extends Opaque {}
+
+/// opaque handle of a solver keeping the state of its last solve
+final class BelegiumIncrementalSolver extends Opaque {}
+
+/// work counters of a native solve, see [SolverCounters]
+final class BelegiumSolverStats extends Struct {
+  @Int64()
+  external int augmentations;
+
+  @Int64()
+  external int scanned;
+
+  @Int64()
+  external int dualUpdates;
+
+  @Int64()
+  external int pathLength;
+}
+
+/// native signature of belegium_last_solver_stats
+typedef _LastSolverStatsNative = Int32 Function(
+  Pointer<BelegiumSolverStats> stats,
+);
+
+/// dart signature of belegium_last_solver_stats
+typedef LastSolverStats = int Function(Pointer<BelegiumSolverStats> stats);
+
+/// native signature of belegium_solve_assignment
+typedef _SolveAssignmentNative = Int32 Function(
+  Pointer<Int64> costs,
+  Int32 n,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_assignment
+typedef SolveAssignment = int Function(
+  Pointer<Int64> costs,
+  int n,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_solve_assignment_i32
+typedef _SolveAssignmentI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_assignment_i32
+typedef SolveAssignmentI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_solve_assignment_duals_i32
+typedef _SolveAssignmentDualsI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> rowPotentials,
+  Pointer<Int64> columnPotentials,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_assignment_duals_i32
+typedef SolveAssignmentDualsI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> rowPotentials,
+  Pointer<Int64> columnPotentials,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_sensitivity_i32
+typedef _SensitivityI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> rowPotentials,
+  Pointer<Int64> columnPotentials,
+  Int32 threads,
+  Pointer<Int64> margins,
+);
+
+/// dart signature of belegium_sensitivity_i32
+typedef SensitivityI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> rowPotentials,
+  Pointer<Int64> columnPotentials,
+  int threads,
+  Pointer<Int64> margins,
+);
+
+/// native signature of belegium_solve_rectangular_i32
+typedef _SolveRectangularI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 m,
+  Int32 n,
+  Int32 stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_rectangular_i32
+typedef SolveRectangularI32 = int Function(
+  Pointer<Int32> costs,
+  int m,
+  int n,
+  int stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_solve_assignment_auction_i32
+typedef _SolveAssignmentAuctionI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Int32 threads,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_assignment_auction_i32
+typedef SolveAssignmentAuctionI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  int threads,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_solve_components_i32
+typedef _SolveComponentsI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Int32 threads,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> componentCount,
+);
+
+/// dart signature of belegium_solve_components_i32
+typedef SolveComponentsI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  int threads,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> componentCount,
+);
+
+/// native signature of belegium_solve_k_best_i32
+typedef _SolveKBestI32Native = Int32 Function(
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Int32 k,
+  Int64 maxGap,
+  Int32 threads,
+  Pointer<Int32> rowToCols,
+  Pointer<Int64> totalCosts,
+  Pointer<Int32> count,
+);
+
+/// dart signature of belegium_solve_k_best_i32
+typedef SolveKBestI32 = int Function(
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  int k,
+  int maxGap,
+  int threads,
+  Pointer<Int32> rowToCols,
+  Pointer<Int64> totalCosts,
+  Pointer<Int32> count,
+);
+
+/// native signature of belegium_solve_transportation
+typedef _SolveTransportationNative = Int32 Function(
+  Pointer<Int64> costs,
+  Int32 m,
+  Int32 n,
+  Pointer<Int32> rowCapacities,
+  Pointer<Int32> columnCapacities,
+  Pointer<Int32> rows,
+  Pointer<Int32> columns,
+  Pointer<Int32> assignmentCount,
+  Pointer<Int64> totalCost,
+);
+
+/// dart signature of belegium_solve_transportation
+typedef SolveTransportation = int Function(
+  Pointer<Int64> costs,
+  int m,
+  int n,
+  Pointer<Int32> rowCapacities,
+  Pointer<Int32> columnCapacities,
+  Pointer<Int32> rows,
+  Pointer<Int32> columns,
+  Pointer<Int32> assignmentCount,
+  Pointer<Int64> totalCost,
+);
+
+/// native signature of belegium_solve_sparse
+typedef _SolveSparseNative = Int32 Function(
+  Pointer<Int32> rowOffsets,
+  Pointer<Int32> columns,
+  Pointer<Int64> costs,
+  Int32 m,
+  Int32 n,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> unassigned,
+);
+
+/// dart signature of belegium_solve_sparse
+typedef SolveSparse = int Function(
+  Pointer<Int32> rowOffsets,
+  Pointer<Int32> columns,
+  Pointer<Int64> costs,
+  int m,
+  int n,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> unassigned,
+);
+
+/// signature of belegium_incremental_solver_create
+typedef IncrementalSolverCreate = Pointer<BelegiumIncrementalSolver>
+    Function();
+
+/// native signature of belegium_incremental_solver_free
+typedef _IncrementalSolverFreeNative = Void Function(
+  Pointer<BelegiumIncrementalSolver> solver,
+);
+
+/// dart signature of belegium_incremental_solver_free
+typedef IncrementalSolverFree = void Function(
+  Pointer<BelegiumIncrementalSolver> solver,
+);
+
+/// native signature of belegium_incremental_solve_i32
+typedef _IncrementalSolveI32Native = Int32 Function(
+  Pointer<BelegiumIncrementalSolver> solver,
+  Pointer<Int32> costs,
+  Int32 n,
+  Int32 stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> repaired,
+);
+
+/// dart signature of belegium_incremental_solve_i32
+typedef IncrementalSolveI32 = int Function(
+  Pointer<BelegiumIncrementalSolver> solver,
+  Pointer<Int32> costs,
+  int n,
+  int stride,
+  Pointer<Int32> rowToCol,
+  Pointer<Int64> totalCost,
+  Pointer<Int32> repaired,
+);
+
+/// native signature of belegium_load_input and belegium_take_preloaded_input
+typedef _LoadInputNative = Int32 Function(
+  Pointer<Utf8> path,
+  Pointer<Pointer<BelegiumInput>> input,
+);
+
+/// dart signature of belegium_load_input and belegium_take_preloaded_input
+typedef LoadInput = int Function(
+  Pointer<Utf8> path,
+  Pointer<Pointer<BelegiumInput>> input,
+);
+
+/// native signature of belegium_input_free
+typedef _InputFreeNative = Void Function(Pointer<BelegiumInput> input);
+
+/// dart signature of belegium_input_free
+typedef InputFree = void Function(Pointer<BelegiumInput> input);
+
+/// native signature of belegium_input_wg_count and belegium_input_person_count
+typedef _InputCountNative = Int32 Function(Pointer<BelegiumInput> input);
+
+/// dart signature of belegium_input_wg_count and belegium_input_person_count
+typedef InputCount = int Function(Pointer<BelegiumInput> input);
+
+/// native signature of belegium_input_wg and belegium_input_person
+typedef _InputNameNative = Pointer<Utf8> Function(
+  Pointer<BelegiumInput> input,
+  Int32 index,
+);
+
+/// dart signature of belegium_input_wg and belegium_input_person
+typedef InputName = Pointer<Utf8> Function(
+  Pointer<BelegiumInput> input,
+  int index,
+);
+
+/// signature of belegium_input_ratings_a and belegium_input_ratings_b
+typedef InputRatings = Pointer<Int64> Function(Pointer<BelegiumInput> input);
+
+/// signature of belegium_input_error_message
+typedef InputErrorMessage = Pointer<Utf8> Function(
+  Pointer<BelegiumInput> input,
+);
+
+/// native signature of belegium_input_error_position
+typedef _InputErrorPositionNative = Int32 Function(
+  Pointer<BelegiumInput> input,
+  Pointer<Int32> row,
+  Pointer<Int32> column,
+  Pointer<Int32> rowOffset,
+);
+
+/// dart signature of belegium_input_error_position
+typedef InputErrorPosition = int Function(
+  Pointer<BelegiumInput> input,
+  Pointer<Int32> row,
+  Pointer<Int32> column,
+  Pointer<Int32> rowOffset,
+);
+
+/// bindings to the native matching core (libbelegium_core)
+class NativeCore {
+  /// file name of the shared library
+  static const String libraryName = "libbelegium_core.so";
+
+  /// status code for successful calls
+  static const int ok = 0;
+
+  /// status code for invalid arguments
+  static const int errorInvalidArgument = 1;
+
+  /// status code for missing or invalid input files
+  static const int errorInvalidInput = 2;
+
+  /// status code for problems where some rows cannot be assigned
+  static const int errorInfeasible = 3;
+
+  /// status code for cancelled solve jobs
+  static const int errorCancelled = 4;
+
+  /// status code for input files that were not preloaded
+  static const int errorNotFound = 5;
+
+  /// loaded core, null if the library is not available on this platform
+  static final NativeCore? instance = _open();
+
+  /// internal handle of the loaded library
+  final DynamicLibrary _library;
+
+  /// solve a square minimization problem
+  late final SolveAssignment solveAssignment =
+      _library.lookupFunction<_SolveAssignmentNative, SolveAssignment>(
+    "belegium_solve_assignment",
+  );
+
+  /// solve a square minimization problem stored as 32 bit integers
+  late final SolveAssignmentI32 solveAssignmentI32 =
+      _library.lookupFunction<_SolveAssignmentI32Native, SolveAssignmentI32>(
+    "belegium_solve_assignment_i32",
+  );
+
+  /// solve a square minimization problem stored as 32 bit integers and get
+  /// its optimal dual potentials
+  late final SolveAssignmentDualsI32 solveAssignmentDualsI32 =
+      _library.lookupFunction<_SolveAssignmentDualsI32Native,
+          SolveAssignmentDualsI32>(
+    "belegium_solve_assignment_duals_i32",
+  );
+
+  /// margins of every cell of a solved square minimization problem stored as
+  /// 32 bit integers
+  late final SensitivityI32 sensitivityI32 =
+      _library.lookupFunction<_SensitivityI32Native, SensitivityI32>(
+    "belegium_sensitivity_i32",
+  );
+
+  /// solve a rectangular minimization problem stored as 32 bit integers
+  /// without padding it
+  late final SolveRectangularI32 solveRectangularI32 =
+      _library.lookupFunction<_SolveRectangularI32Native, SolveRectangularI32>(
+    "belegium_solve_rectangular_i32",
+  );
+
+  /// solve a square minimization problem stored as 32 bit integers with the
+  /// multithreaded auction algorithm
+  late final SolveAssignmentAuctionI32 solveAssignmentAuctionI32 =
+      _library.lookupFunction<_SolveAssignmentAuctionI32Native,
+          SolveAssignmentAuctionI32>(
+    "belegium_solve_assignment_auction_i32",
+  );
+
+  /// solve a square minimization problem stored as 32 bit integers split
+  /// into the components of its cells below the largest cost
+  late final SolveComponentsI32 solveComponentsI32 =
+      _library.lookupFunction<_SolveComponentsI32Native, SolveComponentsI32>(
+    "belegium_solve_components_i32",
+  );
+
+  /// k cheapest assignments of a square minimization problem
+  late final SolveKBestI32 solveKBestI32 =
+      _library.lookupFunction<_SolveKBestI32Native, SolveKBestI32>(
+    "belegium_solve_k_best_i32",
+  );
+
+  /// solve a rectangular minimization problem with capacities
+  late final SolveTransportation solveTransportation = _library
+      .lookupFunction<_SolveTransportationNative, SolveTransportation>(
+    "belegium_solve_transportation",
+  );
+
+  /// solve a rectangular minimization problem of the allowed pairs only
+  late final SolveSparse solveSparse =
+      _library.lookupFunction<_SolveSparseNative, SolveSparse>(
+    "belegium_solve_sparse",
+  );
+
+  /// create a solver for similar problems, it must be released with
+  /// [incrementalSolverFree]
+  late final IncrementalSolverCreate incrementalSolverCreate = _library
+      .lookupFunction<IncrementalSolverCreate, IncrementalSolverCreate>(
+    "belegium_incremental_solver_create",
+  );
+
+  /// release a solver created with [incrementalSolverCreate]
+  late final IncrementalSolverFree incrementalSolverFree = _library
+      .lookupFunction<_IncrementalSolverFreeNative, IncrementalSolverFree>(
+    "belegium_incremental_solver_free",
+  );
+
+  /// solve a square problem stored as 32 bit integers, starting from the
+  /// state of the last solve of the solver
+  late final IncrementalSolveI32 incrementalSolveI32 = _library
+      .lookupFunction<_IncrementalSolveI32Native, IncrementalSolveI32>(
+    "belegium_incremental_solve_i32",
+  );
+
+  /// work counters of the last solve on the calling thread
+  late final LastSolverStats lastSolverStats =
+      _library.lookupFunction<_LastSolverStatsNative, LastSolverStats>(
+    "belegium_last_solver_stats",
+  );
+
+  /// load an input file, the handle must be released with [inputFree]
+  late final LoadInput loadInput =
+      _library.lookupFunction<_LoadInputNative, LoadInput>(
+    "belegium_load_input",
+  );
+
+  /// take an input file the runner started loading before the engine, the
+  /// handle must be released with [inputFree]
+  late final LoadInput takePreloadedInput =
+      _library.lookupFunction<_LoadInputNative, LoadInput>(
+    "belegium_take_preloaded_input",
+  );
+
+  /// release an input file handle
+  late final InputFree inputFree =
+      _library.lookupFunction<_InputFreeNative, InputFree>(
+    "belegium_input_free",
+  );
+
+  /// number of wgs of a loaded input file
+  late final InputCount inputWgCount =
+      _library.lookupFunction<_InputCountNative, InputCount>(
+    "belegium_input_wg_count",
+  );
+
+  /// number of persons of a loaded input file
+  late final InputCount inputPersonCount =
+      _library.lookupFunction<_InputCountNative, InputCount>(
+    "belegium_input_person_count",
+  );
+
+  /// name of a wg of a loaded input file
+  late final InputName inputWg =
+      _library.lookupFunction<_InputNameNative, InputName>(
+    "belegium_input_wg",
+  );
+
+  /// name of a person of a loaded input file
+  late final InputName inputPerson =
+      _library.lookupFunction<_InputNameNative, InputName>(
+    "belegium_input_person",
+  );
+
+  /// ratings of the first table (persons x wgs) of a loaded input file
+  late final InputRatings inputRatingsA =
+      _library.lookupFunction<InputRatings, InputRatings>(
+    "belegium_input_ratings_a",
+  );
+
+  /// ratings of the second table (wgs x persons) of a loaded input file
+  late final InputRatings inputRatingsB =
+      _library.lookupFunction<InputRatings, InputRatings>(
+    "belegium_input_ratings_b",
+  );
+
+  /// message of a failed load
+  late final InputErrorMessage inputErrorMessage =
+      _library.lookupFunction<InputErrorMessage, InputErrorMessage>(
+    "belegium_input_error_message",
+  );
+
+  /// position of a failed load, returns 0 if there is none
+  late final InputErrorPosition inputErrorPosition = _library
+      .lookupFunction<_InputErrorPositionNative, InputErrorPosition>(
+    "belegium_input_error_position",
+  );
+
+  NativeCore._(this._library);
+
+  /// get the work counters of the last solve, it must be called on the
+  /// isolate that solved right after the solve
+  SolverCounters lastSolverCounters() {
+    Pointer<BelegiumSolverStats> stats = calloc<BelegiumSolverStats>();
+
+    try {
+      lastSolverStats(stats);
+      return SolverCounters()
+        ..augmentations = stats.ref.augmentations
+        ..dualUpdates = stats.ref.dualUpdates
+        ..scanned = stats.ref.scanned
+        ..pathLength = stats.ref.pathLength;
+    } finally {
+      calloc.free(stats);
+    }
+  }
+
+  /// internal method to open the library, it is only built for linux
+  static NativeCore? _open() {
+    if (!Platform.isLinux) return null;
+
+    try {
+      return NativeCore._(
+        DynamicLibrary.open(libraryName),
+      );
+    } on ArgumentError {
+      return null;
+    }
+  }
+}
@@ -0,0 +1,221 @@
+import 'dart:ffi';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+import 'hungarian.dart';
+import 'native_core.dart';
+
+/// margins of every pair of a solved quadratic min problem, computed from the
+/// optimal dual potentials instead of solving the problem again per pair
+///
+/// the margin of an unassigned pair is how much its costs must fall, which
+/// is how much its score must rise, until an optimal assignment contains it.
+/// forcing the row onto the column frees the column of the row, so the margin
+/// is the reduced cost of the pair plus the shortest alternating path back to
+/// the freed column, one shortest path tree per row gives the margins of the
+/// whole row. the margin of an assigned pair is how much its costs may rise
+/// while the assignment stays optimal. a margin of 0 marks a tie with
+/// another optimal assignment. the native core searches the trees on several
+/// threads, without it they are searched in dart
+class SensitivityAnalysis {
+  /// margin of the pair of a 1 x 1 problem, which is assigned whatever its
+  /// costs
+  static const int unbounded = -1;
+
+  /// number of search threads of the native core, one per hardware thread if
+  /// it is < 1
+  final int threads;
+
+  const SensitivityAnalysis({this.threads = 0});
+
+  /// compute the margins of the assignment of [result] to its problem. the
+  /// potentials of [result] are used if the solver reported them, otherwise
+  /// the problem is solved once more for them, as optimal duals fit every
+  /// optimal assignment
+  Matrix<int> analyze(AssignmentResult result) {
+    Matrix<int>? problem = result.problem;
+    if (problem == null ||
+        !problem.dimension.isQuadratic ||
+        result.assignments.length != problem.dimension.n) {
+      throw ArgumentError("Only solved quadratic problems can be analyzed.");
+    }
+
+    // the pair of a 1 x 1 problem has no alternative
+    int n = problem.dimension.n;
+    if (n == 1) return Matrix.square(1, fillValue: unbounded);
+
+    List<int> rowToCol = List.filled(n, -1);
+    for (MapEntry<int, int> assignment in result.assignments) {
+      rowToCol[assignment.key] = assignment.value;
+    }
+
+    // the native core reads 32 bit costs, larger ones are analyzed in dart
+    FlatMatrix? costs =
+        NativeCore.instance != null ? FlatMatrix.tryFromMatrix(problem) : null;
+
+    return costs != null
+        ? _analyzeNative(problem, costs, rowToCol, result)
+        : _analyzeDart(problem, rowToCol, result);
+  }
+
+  /// internal method to search the trees in the native core, [costs] is the
+  /// flat copy of [problem]
+  Matrix<int> _analyzeNative(
+    Matrix<int> problem,
+    FlatMatrix costs,
+    List<int> rowToCol,
+    AssignmentResult result,
+  ) {
+    NativeCore core = NativeCore.instance!;
+    int n = problem.dimension.n;
+
+    Pointer<Int32> assignment = calloc<Int32>(n);
+    Pointer<Int32> dualAssignment = calloc<Int32>(n);
+    Pointer<Int64> rowPotentials = calloc<Int64>(n);
+    Pointer<Int64> columnPotentials = calloc<Int64>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+    Pointer<Int64> margins = calloc<Int64>(n * n);
+
+    try {
+      assignment.asTypedList(n).setAll(0, rowToCol);
+
+      List<int>? reportedRows = result.rowPotentials;
+      List<int>? reportedColumns = result.columnPotentials;
+      if (reportedRows != null && reportedColumns != null) {
+        rowPotentials.asTypedList(n).setAll(0, reportedRows);
+        columnPotentials.asTypedList(n).setAll(0, reportedColumns);
+      } else {
+        int dualStatus = core.solveAssignmentDualsI32(
+          costs.address,
+          n,
+          costs.stride,
+          dualAssignment,
+          rowPotentials,
+          columnPotentials,
+          totalCost,
+        );
+        if (dualStatus != NativeCore.ok) {
+          throw StateError("Native solver failed with status $dualStatus.");
+        }
+      }
+
+      int status = core.sensitivityI32(
+        costs.address,
+        n,
+        costs.stride,
+        assignment,
+        rowPotentials,
+        columnPotentials,
+        threads,
+        margins,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native sensitivity failed with status $status.");
+      }
+
+      Int64List cells = Int64List.fromList(margins.asTypedList(n * n));
+      return Matrix<int>.fromRows(
+        problem.dimension,
+        [
+          for (int i = 0; i < n; i++)
+            Int64List.sublistView(cells, i * n, (i + 1) * n),
+        ],
+      );
+    } finally {
+      calloc.free(assignment);
+      calloc.free(dualAssignment);
+      calloc.free(rowPotentials);
+      calloc.free(columnPotentials);
+      calloc.free(totalCost);
+      calloc.free(margins);
+    }
+  }
+
+  /// internal method to search the trees in dart, the same way as the native
+  /// core without its threads
+  static Matrix<int> _analyzeDart(
+    Matrix<int> problem,
+    List<int> rowToCol,
+    AssignmentResult result,
+  ) {
+    int n = problem.dimension.n;
+
+    List<int>? rowPotentials = result.rowPotentials;
+    List<int>? columnPotentials = result.columnPotentials;
+    if (rowPotentials == null || columnPotentials == null) {
+      AssignmentResult dual = HungarianSolver().solve(problem);
+      rowPotentials = dual.rowPotentials!;
+      columnPotentials = dual.columnPotentials!;
+    }
+
+    // reduced costs stored transposed, so the reduced costs of all rows
+    // towards a column are contiguous
+    List<int> colToRow = List.filled(n, -1);
+    Int64List reduced = Int64List(n * n);
+    for (int i = 0; i < n; i++) {
+      colToRow[rowToCol[i]] = i;
+      for (int j = 0; j < n; j++) {
+        int cost = problem[i][j] - rowPotentials[i] - columnPotentials[j];
+        if (cost < 0 || (j == rowToCol[i] && cost != 0)) {
+          throw StateError("The assignment is not optimal.");
+        }
+        reduced[j * n + i] = cost;
+      }
+    }
+
+    Matrix<int> margins = Matrix(problem.dimension);
+    Int64List distance = Int64List(n);
+    List<bool> settled = List.filled(n, false);
+    for (int row = 0; row < n; row++) {
+      // distance of every row to the column of [row] along alternating paths
+      int target = rowToCol[row];
+      distance.setRange(0, n, reduced, target * n);
+      settled.fillRange(0, n, false);
+
+      for (int step = 0; step < n; step++) {
+        int closest = -1;
+        for (int k = 0; k < n; k++) {
+          if (settled[k]) continue;
+          if (closest < 0 || distance[k] < distance[closest]) closest = k;
+        }
+        settled[closest] = true;
+
+        // every other row can reach [closest] through its column
+        int column = rowToCol[closest];
+        if (column == target) continue;
+
+        for (int k = 0; k < n; k++) {
+          distance[k] = min(
+            distance[k],
+            reduced[column * n + k] + distance[closest],
+          );
+        }
+      }
+
+      // taking column j moves its row onto a path back to the freed column
+      for (int j = 0; j < n; j++) {
+        if (j != target) {
+          margins[row][j] = reduced[j * n + row] + distance[colToRow[j]];
+        }
+      }
+    }
+
+    // an assigned pair may rise until the cheapest other pair of its row ties
+    for (int i = 0; i < n; i++) {
+      int? tolerance;
+      for (int j = 0; j < n; j++) {
+        if (j != rowToCol[i]) {
+          tolerance = min(tolerance ?? margins[i][j], margins[i][j]);
+        }
+      }
+      margins[i][rowToCol[i]] = tolerance ?? unbounded;
+    }
+
+    return margins;
+  }
+}
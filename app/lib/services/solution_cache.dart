@@ -0,0 +1,243 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import '../model/dimension.dart';
+import '../model/fingerprint.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+
+/// assignment of a solved problem without the problem itself
+class CachedSolution {
+  /// assigned pairs of rows and columns, one after the other
+  final Int32List assignments;
+
+  /// rows that could not be assigned
+  final Int32List unassignedRows;
+
+  /// rows and columns of a problem that is not quadratic left without a match
+  final Int32List unmatchedRows;
+  final Int32List unmatchedColumns;
+
+  /// costs of the assignment
+  final int costs;
+
+  /// next best assignments ordered by costs
+  final List<CachedSolution> alternatives;
+
+  const CachedSolution._(
+    this.assignments,
+    this.unassignedRows,
+    this.unmatchedRows,
+    this.unmatchedColumns,
+    this.costs,
+    this.alternatives,
+  );
+
+  /// constructor to keep the assignment of [result]
+  CachedSolution.of(AssignmentResult result)
+      : assignments = Int32List.fromList([
+          for (MapEntry<int, int> assignment in result.assignments) ...[
+            assignment.key,
+            assignment.value,
+          ],
+        ]),
+        unassignedRows = Int32List.fromList(result.unassignedRows),
+        unmatchedRows = Int32List.fromList(result.unmatchedRows),
+        unmatchedColumns = Int32List.fromList(result.unmatchedColumns),
+        costs = result.costs,
+        alternatives = [
+          for (AssignmentResult alternative in result.alternatives)
+            CachedSolution.of(alternative),
+        ];
+
+  /// parse a solution written by [toJson], null if [json] is not one
+  static CachedSolution? fromJson(Object? json) {
+    if (json
+        case {
+          "assignments": List<dynamic> assignments,
+          "unassigned": List<dynamic> unassignedRows,
+          "unmatchedRows": List<dynamic> unmatchedRows,
+          "unmatchedColumns": List<dynamic> unmatchedColumns,
+          "costs": int costs,
+          "alternatives": List<dynamic> alternatives,
+        }) {
+      if (assignments.length.isOdd ||
+          !assignments.every((value) => value is int) ||
+          !unassignedRows.every((value) => value is int) ||
+          !unmatchedRows.every((value) => value is int) ||
+          !unmatchedColumns.every((value) => value is int)) {
+        return null;
+      }
+
+      List<CachedSolution> parsedAlternatives = [];
+      for (Object? alternative in alternatives) {
+        CachedSolution? parsed = fromJson(alternative);
+        if (parsed == null) return null;
+        parsedAlternatives.add(parsed);
+      }
+
+      return CachedSolution._(
+        Int32List.fromList(assignments.cast<int>()),
+        Int32List.fromList(unassignedRows.cast<int>()),
+        Int32List.fromList(unmatchedRows.cast<int>()),
+        Int32List.fromList(unmatchedColumns.cast<int>()),
+        costs,
+        parsedAlternatives,
+      );
+    }
+
+    return null;
+  }
+
+  Map<String, dynamic> toJson() => {
+        "assignments": assignments,
+        "unassigned": unassignedRows,
+        "unmatchedRows": unmatchedRows,
+        "unmatchedColumns": unmatchedColumns,
+        "costs": costs,
+        "alternatives": [
+          for (CachedSolution alternative in alternatives) alternative.toJson(),
+        ],
+      };
+
+  /// flag wether all rows and columns lie within [dimension]
+  bool fits(Dimension dimension) {
+    for (int k = 0; k < assignments.length; k += 2) {
+      if (assignments[k] < 0 ||
+          assignments[k] >= dimension.m ||
+          assignments[k + 1] < 0 ||
+          assignments[k + 1] >= dimension.n) {
+        return false;
+      }
+    }
+
+    return unassignedRows.every((row) => row >= 0 && row < dimension.m) &&
+        unmatchedRows.every((row) => row >= 0 && row < dimension.m) &&
+        unmatchedColumns
+            .every((column) => column >= 0 && column < dimension.n) &&
+        alternatives.every((alternative) => alternative.fits(dimension));
+  }
+
+  /// create the result of this assignment of [problem], the solver counters
+  /// are left at 0 as nothing was solved
+  AssignmentResult toResult(Matrix<int>? problem) {
+    AssignmentResult result = AssignmentResult(problem);
+    result.costs = costs;
+    result.unassignedRows.addAll(unassignedRows);
+    result.unmatchedRows.addAll(unmatchedRows);
+    result.unmatchedColumns.addAll(unmatchedColumns);
+    for (int k = 0; k < assignments.length; k += 2) {
+      result.assignments.add(
+        MapEntry<int, int>(assignments[k], assignments[k + 1]),
+      );
+    }
+    for (CachedSolution alternative in alternatives) {
+      result.alternatives.add(alternative.toResult(problem));
+    }
+
+    return result;
+  }
+}
+
+/// cache of the solutions of problems by the [Fingerprint] of their input
+///
+/// the solutions of the [capacity] most recently used problems are kept in
+/// memory. if a [directory] is set, every solution is also written there as
+/// a small json file named after its fingerprint, so they are found again
+/// after a restart. only the assignments are stored, the problems are
+/// rebuilt from the input on a hit
+class SolutionCache {
+  /// version of the files, files of other versions are ignored and replaced
+  static const int version = 2;
+
+  /// largest number of solutions kept in memory
+  final int capacity;
+
+  /// directory of the persistent solutions, null keeps them in memory only
+  final String? directory;
+
+  /// solutions in order of their last use, the oldest first
+  final Map<int, CachedSolution> _solutions = {};
+
+  SolutionCache({this.capacity = 64, this.directory});
+
+  /// get the solution stored for [fingerprint], null if it is unknown
+  Future<CachedSolution?> lookup(int fingerprint) async {
+    CachedSolution? solution = _solutions.remove(fingerprint);
+    solution ??= await _read(fingerprint);
+    if (solution != null) _remember(fingerprint, solution);
+
+    return solution;
+  }
+
+  /// store the assignment of [result] for [fingerprint]
+  Future<void> store(int fingerprint, AssignmentResult result) async {
+    CachedSolution solution = CachedSolution.of(result);
+    _solutions.remove(fingerprint);
+    _remember(fingerprint, solution);
+    await _write(fingerprint, solution);
+  }
+
+  /// remove all solutions from memory, the files are kept
+  void clear() => _solutions.clear();
+
+  /// internal method to add [solution] as the most recently used one and to
+  /// drop the least recently used ones beyond [capacity]
+  void _remember(int fingerprint, CachedSolution solution) {
+    _solutions[fingerprint] = solution;
+    while (_solutions.length > capacity) {
+      _solutions.remove(_solutions.keys.first);
+    }
+  }
+
+  /// internal method to get the file of [fingerprint]
+  File _file(int fingerprint) =>
+      File("$directory/${Fingerprint(fingerprint)}.json");
+
+  /// internal method to read the solution of [fingerprint] from [directory],
+  /// missing, stale and damaged files are ignored
+  Future<CachedSolution?> _read(int fingerprint) async {
+    if (directory == null) return null;
+
+    try {
+      Object? json = jsonDecode(await _file(fingerprint).readAsString());
+      if (json
+          case {
+            "version": version,
+            "fingerprint": String stored,
+            "solution": Object solution,
+          } when stored == "${Fingerprint(fingerprint)}") {
+        return CachedSolution.fromJson(solution);
+      }
+    } on FileSystemException {
+      // not stored yet
+    } on FormatException {
+      // damaged, it is replaced by the next store
+    }
+
+    return null;
+  }
+
+  /// internal method to write [solution] into [directory], the file is
+  /// written under another name first, so readers never see a partial file
+  Future<void> _write(int fingerprint, CachedSolution solution) async {
+    if (directory == null) return;
+
+    File file = _file(fingerprint);
+    File temporary = File("${file.path}.$pid.tmp");
+    try {
+      await Directory(directory!).create(recursive: true);
+      await temporary.writeAsString(
+        jsonEncode({
+          "version": version,
+          "fingerprint": "${Fingerprint(fingerprint)}",
+          "solution": solution.toJson(),
+        }),
+      );
+      await temporary.rename(file.path);
+    } on FileSystemException {
+      // the cache only saves time, the solution is still kept in memory
+    }
+  }
+}
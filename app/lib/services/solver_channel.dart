@@ -0,0 +1,113 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+import '../model/cancelled_exception.dart';
+import '../model/dimension.dart';
+import '../model/matrix.dart';
+import '../model/profile.dart';
+import '../model/result.dart';
+import '../model/solve_progress.dart';
+
+/// solver running native solve jobs of the linux runner via platform channels
+///
+/// the problems are solved by the shortest augmenting path method on worker
+/// threads of the runner, so the ui stays responsive during big solves. each
+/// job streams its progress and can be cancelled. the runner keeps the state
+/// of the last solve of every problem key like the [WarmStartSolver], so
+/// solving a slightly changed problem again only repairs the changed parts
+/// and a cancelled solve is completed by the next one
+class ChannelSolver {
+  /// channel of the solve and cancel methods
+  static const MethodChannel _methods =
+      MethodChannel("belegium_matcher/solver");
+
+  /// channel of the progress events of all jobs
+  static const EventChannel _events =
+      EventChannel("belegium_matcher/solver/progress");
+
+  /// progress of all jobs, shared by all solvers
+  static final Stream<SolveProgress> _progress =
+      _events.receiveBroadcastStream().map(SolveProgress.fromEvent);
+
+  /// id of the next job
+  static int _nextJob = 0;
+
+  /// flag whether the channels are available, only the linux runner
+  /// registers them
+  static bool get isAvailable => Platform.isLinux;
+
+  /// ids of the running jobs by problem key
+  final Map<String, int> _jobs = {};
+
+  /// flag whether any job of this solver is running
+  bool get running => _jobs.isNotEmpty;
+
+  /// solve the [n]x[n] min problem stored row-major in [costs] on a worker
+  /// thread and call [onProgress] with its progress, a
+  /// [MatchCancelledException] is thrown if it was cancelled
+  Future<AssignmentResult> solve(
+    Int32List costs,
+    int n, {
+    String key = "",
+    void Function(SolveProgress progress)? onProgress,
+  }) async {
+    if (n < 1 || costs.length != n * n) {
+      throw ArgumentError("Invalid problem size (${Dimension(n, n)}).");
+    }
+
+    int job = _nextJob++;
+    StreamSubscription<SolveProgress>? subscription = onProgress == null
+        ? null
+        : _progress.where((progress) => progress.job == job).listen(onProgress);
+    _jobs[key] = job;
+
+    try {
+      Map<String, Object?> response =
+          (await _methods.invokeMapMethod<String, Object?>(
+        "solve",
+        {"job": job, "key": key, "n": n, "costs": costs},
+      ))!;
+
+      // the result reads the rows of the problem without copying them
+      AssignmentResult result = AssignmentResult(
+        Matrix<int>.fromRows(
+          Dimension(n, n),
+          [
+            for (int i = 0; i < n; i++)
+              Int32List.sublistView(costs, i * n, (i + 1) * n),
+          ],
+        ),
+      );
+      result.costs = response["total_cost"] as int;
+      result.counters = SolverCounters()
+        ..augmentations = response["augmentations"] as int
+        ..scanned = response["scanned"] as int
+        ..dualUpdates = response["dual_updates"] as int
+        ..pathLength = response["path_length"] as int;
+
+      Int32List rowToCol = response["row_to_col"] as Int32List;
+      for (int i = 0; i < n; i++) {
+        result.assignments.add(MapEntry<int, int>(i, rowToCol[i]));
+      }
+
+      return result;
+    } on PlatformException catch (e) {
+      if (e.code == "cancelled") throw MatchCancelledException(key);
+      rethrow;
+    } finally {
+      _jobs.remove(key);
+      await subscription?.cancel();
+    }
+  }
+
+  /// cancel all running jobs of this solver, their [solve] calls throw a
+  /// [MatchCancelledException]
+  Future<void> cancel() async {
+    for (int job in _jobs.values.toList()) {
+      await _methods.invokeMethod<void>("cancel", {"job": job});
+    }
+  }
+}
@@ -0,0 +1,88 @@
+import 'dart:ffi';
+import 'dart:math';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/result.dart';
+import '../model/solver.dart';
+import '../model/sparse_matrix.dart';
+import 'native_core.dart';
+
+/// solver using the native sparse shortest augmenting path method
+///
+/// only the set cells of the problem are allowed pairs, so vetoes can be left
+/// out instead of being matched with a bad score. the problem may be
+/// rectangular. as many rows as possible are assigned with minimal costs, the
+/// rows left over are listed in [AssignmentResult.unassignedRows] instead of
+/// being matched anyway. the solver only looks up the native core when
+/// solving, so it can be sent to background isolates
+class SparseShortestPathSolver implements SparseAssignmentSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  @override
+  AssignmentResult solveSparse(SparseMatrix problem) {
+    int m = problem.dimension.m;
+    int n = problem.dimension.n;
+
+    if (m < 1 || n < 1) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+
+    Pointer<Int32> rowOffsets = calloc<Int32>(m + 1);
+    Pointer<Int32> columns = calloc<Int32>(max(problem.length, 1));
+    Pointer<Int64> costs = calloc<Int64>(max(problem.length, 1));
+    Pointer<Int32> rowToCol = calloc<Int32>(m);
+    Pointer<Int64> totalCost = calloc<Int64>();
+    Pointer<Int32> unassigned = calloc<Int32>();
+
+    try {
+      // copy the problem into native buffers
+      rowOffsets.asTypedList(m + 1).setAll(0, problem.rowOffsets);
+      columns.asTypedList(problem.length).setAll(0, problem.columns);
+      costs.asTypedList(problem.length).setAll(0, problem.values);
+
+      int status = core.solveSparse(
+        rowOffsets,
+        columns,
+        costs,
+        m,
+        n,
+        rowToCol,
+        totalCost,
+        unassigned,
+      );
+      if (status == NativeCore.errorInvalidArgument) {
+        throw ArgumentError("The costs are too large to be solved.");
+      }
+      if (status != NativeCore.ok && status != NativeCore.errorInfeasible) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(null);
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int i = 0; i < m; i++) {
+        if (rowToCol[i] < 0) {
+          result.unassignedRows.add(i);
+        } else {
+          result.assignments.add(
+            MapEntry<int, int>(i, rowToCol[i]),
+          );
+        }
+      }
+
+      return result;
+    } finally {
+      calloc.free(rowOffsets);
+      calloc.free(columns);
+      calloc.free(costs);
+      calloc.free(rowToCol);
+      calloc.free(totalCost);
+      calloc.free(unassigned);
+    }
+  }
+}
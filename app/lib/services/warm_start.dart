@@ -0,0 +1,88 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../model/flat_matrix.dart';
+import '../model/matrix.dart';
+import '../model/result.dart';
+import '../model/solver.dart';
+import 'native_core.dart';
+
+/// solver keeping the dual potentials and the assignment of its last solve
+///
+/// the next problem is compared against the last one and only the rows or
+/// columns with changed costs are solved again, which makes re-solving after
+/// a few edited ratings almost free. if too much changed the problem is
+/// solved from scratch. the solver only holds the address of its native
+/// state, so it can be sent to background isolates, but it must not solve
+/// two problems at once and must be released with [dispose]
+class WarmStartSolver extends AssignmentSolver<int>
+    implements FlatAssignmentSolver {
+  /// flag whether the native core can be loaded
+  static bool get isAvailable => NativeCore.instance != null;
+
+  /// address of the native solver state
+  final int _address;
+
+  /// constructor to create the native solver state
+  WarmStartSolver()
+      : _address = NativeCore.instance!.incrementalSolverCreate().address;
+
+  /// internal getter for the native solver state
+  Pointer<BelegiumIncrementalSolver> get _solver =>
+      Pointer<BelegiumIncrementalSolver>.fromAddress(_address);
+
+  @override
+  AssignmentResult solve(Matrix<int> problem) =>
+      solveFlat(FlatMatrix.fromMatrix(problem));
+
+  @override
+  AssignmentResult solveFlat(FlatMatrix problem) {
+    if (!problem.dimension.isQuadratic || problem.dimension.n < 2) {
+      throw ArgumentError("Invalid problem size (${problem.dimension}).");
+    }
+
+    NativeCore core = NativeCore.instance!;
+    int n = problem.dimension.n;
+
+    Pointer<Int32> rowToCol = calloc<Int32>(n);
+    Pointer<Int64> totalCost = calloc<Int64>();
+    Pointer<Int32> repaired = calloc<Int32>();
+
+    try {
+      int status = core.incrementalSolveI32(
+        _solver,
+        problem.address,
+        n,
+        problem.stride,
+        rowToCol,
+        totalCost,
+        repaired,
+      );
+      if (status != NativeCore.ok) {
+        throw StateError("Native solver failed with status $status.");
+      }
+
+      AssignmentResult result = AssignmentResult(problem.asMatrix());
+      result.costs = totalCost.value;
+      result.counters = core.lastSolverCounters();
+
+      for (int i = 0; i < n; i++) {
+        result.assignments.add(
+          MapEntry<int, int>(i, rowToCol[i]),
+        );
+      }
+
+      return result;
+    } finally {
+      calloc.free(rowToCol);
+      calloc.free(totalCost);
+      calloc.free(repaired);
+    }
+  }
+
+  /// method to release the native solver state
+  void dispose() {
+    NativeCore.instance!.incrementalSolverFree(_solver);
+  }
+}
@@ -2,10 +2,14 @@ import 'package:flutter/material.dart';
 import 'package:input_quantity/input_quantity.dart';
 
 import '../../constants.dart';
+import '../../model/matrix.dart';
+import '../../model/result.dart';
+import '../../model/solve_progress.dart';
 import '../../model/table_position.dart';
 import '../../services/match.dart';
 import '../widgets/assignment.dart';
 import '../widgets/matrix.dart';
+import '../widgets/profile.dart';
 import '../widgets/section.dart';
 import '../widgets/table.dart';
 
@@ -16,10 +20,14 @@ class FlowScreen extends StatefulWidget {
   /// flag to show / hide matrices
   final bool showMatrices;
 
+  /// flag to show the profile of the last run above the flow
+  final bool showProfile;
+
   const FlowScreen({
     super.key,
     required this.service,
     this.showMatrices = false,
+    this.showProfile = false,
   });
 
   @override
@@ -60,6 +68,138 @@ class _FlowScreenState extends State<FlowScreen> {
     }
   }
 
+  /// get the solution of the [i]th strategy, null while it is solved
+  AssignmentResult? solution(int i) => widget.service.solutionOf(
+        widget.service.combinationFunctionDescriptions.elementAt(i),
+      );
+
+  /// build the status of the [i]th strategy while it is not solved
+  Widget solveStatus(int i) {
+    // a cancelled problem is solved again by the next run
+    if (!widget.service.running) {
+      return IconButton(
+        icon: const Icon(Icons.replay),
+        tooltip: "match again",
+        onPressed: widget.service.run,
+      );
+    }
+
+    SolveProgress? progress = widget.service.progress[
+        widget.service.combinationFunctionDescriptions.elementAt(i)];
+    if (progress == null) return const CircularProgressIndicator();
+
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      children: [
+        Text(
+          "${progress.assigned} / ${progress.n} assigned, "
+          "costs >= ${progress.dualObjective}",
+        ),
+        const SizedBox(width: 8),
+        CircularProgressIndicator(value: progress.fraction),
+        IconButton(
+          icon: const Icon(Icons.cancel_outlined),
+          tooltip: "cancel",
+          onPressed: widget.service.cancellable ? widget.service.cancel : null,
+        ),
+      ],
+    );
+  }
+
+  /// describe the matches of [alternative] that differ from [best]
+  String changes(AssignmentResult best, AssignmentResult alternative) {
+    List<String> persons = widget.service.matrixRowHeaderB;
+    List<String> wgs = widget.service.matrixRowHeaderA;
+
+    List<String> changed = [];
+    for (int k = 0; k < alternative.assignments.length; k++) {
+      MapEntry<int, int> assignment = alternative.assignments[k];
+      if (assignment.key >= persons.length ||
+          assignment.value == best.assignments[k].value) {
+        continue;
+      }
+
+      // a padding column leaves the person without a match
+      String wg = assignment.value < wgs.length ? wgs[assignment.value] : "-";
+      changed.add("${persons[assignment.key]} <-> $wg");
+    }
+
+    return changed.join(", ");
+  }
+
+  /// strategies whose sensitivity is shown
+  final Set<String> shownSensitivities = {};
+
+  /// build the button to show the sensitivity of the [i]th strategy and,
+  /// once it is shown, its margins with the assigned pairs highlighted
+  Widget sensitivityView(int i) {
+    String description =
+        widget.service.combinationFunctionDescriptions.elementAt(i);
+    bool shown = shownSensitivities.contains(description);
+
+    return Column(
+      mainAxisSize: MainAxisSize.min,
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        TextButton.icon(
+          icon: Icon(shown ? Icons.expand_less : Icons.tune),
+          label: const Text("sensitivity"),
+          onPressed: () => setState(() {
+            if (!shownSensitivities.remove(description)) {
+              shownSensitivities.add(description);
+            }
+          }),
+        ),
+        if (shown)
+          FutureBuilder<Matrix<int>>(
+            future: widget.service.sensitivityOf(description),
+            builder: (context, snapshot) {
+              if (snapshot.hasError) {
+                return Text(
+                  "${snapshot.error}",
+                  style: const TextStyle(color: Colors.red),
+                );
+              }
+              if (!snapshot.hasData) return const CircularProgressIndicator();
+
+              return Column(
+                mainAxisSize: MainAxisSize.min,
+                crossAxisAlignment: CrossAxisAlignment.start,
+                children: [
+                  const Padding(
+                    padding: EdgeInsets.all(8.0),
+                    child: Text(
+                      "how much the score of a pair must rise to be matched, "
+                      "highlighted matches: how much it may fall before the "
+                      "matches change, 0: tied with other matches",
+                    ),
+                  ),
+                  SingleChildScrollView(
+                    scrollDirection: Axis.horizontal,
+                    child: Row(
+                      mainAxisSize: MainAxisSize.min,
+                      children: [
+                        const Text("S = "),
+                        MatrixWidget(
+                          snapshot.data!,
+                          highlightPoints: solution(i)!.assignments,
+                        ),
+                      ],
+                    ),
+                  ),
+                ],
+              );
+            },
+          ),
+      ],
+    );
+  }
+
+  /// get the problems [max, min] of the [i]th strategy
+  MapEntry<Matrix<int>, Matrix<int>>? problem(int i) =>
+      widget.service.problems[
+          widget.service.combinationFunctionDescriptions.elementAt(i)];
+
   @override
   void dispose() {
     widget.service.removeListener(listener);
@@ -67,7 +207,20 @@ class _FlowScreenState extends State<FlowScreen> {
   }
 
   @override
-  Widget build(BuildContext context) => Material(
+  Widget build(BuildContext context) => Stack(
+        children: [
+          _buildFlow(context),
+          if (widget.showProfile && widget.service.profile.stages.isNotEmpty)
+            Positioned(
+              top: 8.0,
+              right: 8.0,
+              child: ProfileWidget(widget.service.profile),
+            ),
+        ],
+      );
+
+  /// internal method to build the steps of the match
+  Widget _buildFlow(BuildContext context) => Material(
         child: SingleChildScrollView(
           child: Column(
             mainAxisSize: MainAxisSize.min,
@@ -330,149 +483,182 @@ class _FlowScreenState extends State<FlowScreen> {
                           SectionWidget(
                             title:
                                 "5.${i + 1}) ${widget.service.combinationFunctionDescriptions.elementAt(i)}",
-                            titleStaus: Text(
-                              widget.service.solutions
-                                  .elementAt(i)
-                                  .costs
-                                  .toString(),
-                            ),
-                            child: Row(
-                              children: [
-                                const SizedBox(
-                                  width: 16.0,
-                                ),
-                                Expanded(
-                                  child: Column(
-                                    mainAxisSize: MainAxisSize.min,
-                                    crossAxisAlignment:
-                                        CrossAxisAlignment.start,
-                                    children: [
-                                      if (widget.showMatrices)
-                                        SingleChildScrollView(
-                                          scrollDirection: Axis.horizontal,
-                                          child: Row(
-                                            mainAxisSize: MainAxisSize.min,
-                                            children: [
-                                              const Text("M = "),
-                                              MatrixWidget(
-                                                widget.service.problems[i].key,
-                                                highlightPoints: widget
-                                                        .service.solutions
-                                                        .elementAtOrNull(i)
-                                                        ?.assignments ??
-                                                    const [],
-                                              ),
-                                              Center(
-                                                child: Padding(
-                                                  padding: const EdgeInsets
-                                                      .symmetric(
-                                                    horizontal: 16.0,
+                            titleStaus: solution(i) != null
+                                ? Text(
+                                    solution(i)!.costs.toString(),
+                                  )
+                                : solveStatus(i),
+                            child: solution(i) == null
+                                ? null
+                                : Row(
+                                  children: [
+                                    const SizedBox(
+                                      width: 16.0,
+                                    ),
+                                    Expanded(
+                                      child: Column(
+                                        mainAxisSize: MainAxisSize.min,
+                                        crossAxisAlignment:
+                                            CrossAxisAlignment.start,
+                                        children: [
+                                          if (widget.showMatrices)
+                                            SingleChildScrollView(
+                                              scrollDirection: Axis.horizontal,
+                                              child: Row(
+                                                mainAxisSize: MainAxisSize.min,
+                                                children: [
+                                                  const Text("M = "),
+                                                  MatrixWidget(
+                                                    problem(i)!.key,
+                                                    highlightPoints:
+                                                        solution(i)!.assignments,
                                                   ),
-                                                  child: Column(
-                                                    mainAxisSize:
-                                                        MainAxisSize.min,
-                                                    children: [
-                                                      const Row(
+                                                  Center(
+                                                    child: Padding(
+                                                      padding: const EdgeInsets
+                                                          .symmetric(
+                                                        horizontal: 16.0,
+                                                      ),
+                                                      child: Column(
                                                         mainAxisSize:
                                                             MainAxisSize.min,
                                                         children: [
-                                                          Text("max"),
+                                                          const Row(
+                                                            mainAxisSize:
+                                                                MainAxisSize.min,
+                                                            children: [
+                                                              Text("max"),
+                                                              Icon(
+                                                                  Icons.swap_horiz),
+                                                              Text("min"),
+                                                            ],
+                                                          ),
                                                           Icon(
-                                                              Icons.swap_horiz),
-                                                          Text("min"),
+                                                            Icons.trending_flat,
+                                                            size: Theme.of(context)
+                                                                .textTheme
+                                                                .headlineLarge
+                                                                ?.fontSize,
+                                                          ),
                                                         ],
                                                       ),
-                                                      Icon(
-                                                        Icons.trending_flat,
-                                                        size: Theme.of(context)
-                                                            .textTheme
-                                                            .headlineLarge
-                                                            ?.fontSize,
-                                                      ),
-                                                    ],
+                                                    ),
                                                   ),
-                                                ),
-                                              ),
-                                              const Text("W = "),
-                                              MatrixWidget(
-                                                widget
-                                                    .service.problems[i].value,
-                                                highlightPoints: widget
-                                                        .service.solutions
-                                                        .elementAtOrNull(i)
-                                                        ?.assignments ??
-                                                    const [],
+                                                  const Text("W = "),
+                                                  MatrixWidget(
+                                                    problem(i)!.value,
+                                                    highlightPoints:
+                                                        solution(i)!.assignments,
+                                                  ),
+                                                ],
                                               ),
-                                            ],
-                                          ),
-                                        ),
-                                      if (widget.showMatrices)
-                                        const SizedBox(
-                                          height: 8.0,
-                                        ),
-                                      Wrap(
-                                        children: [
-                                          for (MapEntry<int, int> assignment
-                                              in widget.service.solutions[i]
-                                                  .assignments)
-                                            if (assignment.key <
-                                                    widget
-                                                        .service
-                                                        .matrixRowHeaderB
-                                                        .length &&
-                                                assignment.value <
-                                                    widget
-                                                        .service
-                                                        .matrixRowHeaderA
-                                                        .length)
-                                              Padding(
-                                                padding:
-                                                    const EdgeInsets.all(8.0),
-                                                child: Container(
-                                                  decoration: BoxDecoration(
-                                                    border: Border.all(
-                                                      color: widget.service
-                                                                          .matrixA![
+                                            ),
+                                          if (widget.showMatrices)
+                                            const SizedBox(
+                                              height: 8.0,
+                                            ),
+                                          Wrap(
+                                            children: [
+                                              for (MapEntry<int, int> assignment
+                                                  in solution(i)!.assignments)
+                                                if (assignment.key <
+                                                        widget
+                                                            .service
+                                                            .matrixRowHeaderB
+                                                            .length &&
+                                                    assignment.value <
+                                                        widget
+                                                            .service
+                                                            .matrixRowHeaderA
+                                                            .length)
+                                                  Padding(
+                                                    padding:
+                                                        const EdgeInsets.all(8.0),
+                                                    child: Container(
+                                                      decoration: BoxDecoration(
+                                                        border: Border.all(
+                                                          color: widget.service
+                                                                              .matrixA![
+                                                                          assignment
+                                                                              .key][
                                                                       assignment
-                                                                          .key][
-                                                                  assignment
-                                                                      .value] <
-                                                              0
-                                                          ? Colors.red
-                                                          : Colors.black,
+                                                                          .value] <
+                                                                  0
+                                                              ? Colors.red
+                                                              : Colors.black,
+                                                        ),
+                                                        borderRadius:
+                                                            BorderRadius.circular(
+                                                                10),
+                                                      ),
+                                                      padding:
+                                                          const EdgeInsets.all(8.0),
+                                                      child: AssignmentWidget(
+                                                        a: widget.service
+                                                                .matrixRowHeaderB[
+                                                            assignment.key],
+                                                        b: widget.service
+                                                                .matrixRowHeaderA[
+                                                            assignment.value],
+                                                        aScore:
+                                                            widget.service.matrixA![
+                                                                    assignment.key]
+                                                                [assignment.value],
+                                                        bScore:
+                                                            widget.service.matrixB![
+                                                                    assignment
+                                                                        .value]
+                                                                [assignment.key],
+                                                      ),
                                                     ),
-                                                    borderRadius:
-                                                        BorderRadius.circular(
-                                                            10),
-                                                  ),
-                                                  padding:
-                                                      const EdgeInsets.all(8.0),
-                                                  child: AssignmentWidget(
-                                                    a: widget.service
-                                                            .matrixRowHeaderB[
-                                                        assignment.key],
-                                                    b: widget.service
-                                                            .matrixRowHeaderA[
-                                                        assignment.value],
-                                                    aScore:
-                                                        widget.service.matrixA![
-                                                                assignment.key]
-                                                            [assignment.value],
-                                                    bScore:
-                                                        widget.service.matrixB![
-                                                                assignment
-                                                                    .value]
-                                                            [assignment.key],
                                                   ),
+                                            ],
+                                          ),
+                                          if (!solution(i)!.feasible)
+                                            Padding(
+                                              padding: const EdgeInsets.all(8.0),
+                                              child: Text(
+                                                "No match without veto: ${solution(i)!.unassignedRows.map((row) => widget.service.matrixRowHeaderB[row]).join(", ")}",
+                                                style: const TextStyle(
+                                                  color: Colors.red,
                                                 ),
                                               ),
+                                            ),
+                                          if (solution(i)!
+                                              .unmatchedRows.isNotEmpty)
+                                            Padding(
+                                              padding: const EdgeInsets.all(8.0),
+                                              child: Text(
+                                                "Without a wg: ${solution(i)!.unmatchedRows.map((row) => widget.service.matrixRowHeaderB[row]).join(", ")}",
+                                              ),
+                                            ),
+                                          if (solution(i)!
+                                              .unmatchedColumns.isNotEmpty)
+                                            Padding(
+                                              padding: const EdgeInsets.all(8.0),
+                                              child: Text(
+                                                "Free seats: ${solution(i)!.unmatchedColumns.map((column) => widget.service.matrixRowHeaderA[column]).join(", ")}",
+                                              ),
+                                            ),
+                                          for (final (int k, AssignmentResult alternative)
+                                              in solution(i)!.alternatives.indexed)
+                                            Padding(
+                                              padding: const EdgeInsets.all(8.0),
+                                              child: Text(
+                                                "${k + 2}. best (+${alternative.costs - solution(i)!.costs}): ${changes(solution(i)!, alternative)}",
+                                              ),
+                                            ),
+                                          if (widget.service.hasSensitivity(
+                                            widget.service
+                                                .combinationFunctionDescriptions
+                                                .elementAt(i),
+                                          ))
+                                            sensitivityView(i),
                                         ],
                                       ),
-                                    ],
-                                  ),
+                                    ),
+                                  ],
                                 ),
-                              ],
-                            ),
                           ),
                         ],
                       ),
@@ -1,11 +1,16 @@
 import 'dart:math';
+import 'dart:typed_data';
 
 import 'package:flutter/material.dart';
 
 import '../../model/matrix.dart';
+import 'scroll_grid.dart';
 
 /// widget to display a matrix
-class MatrixWidget extends StatelessWidget {
+///
+/// the entries are painted by a [ScrollGrid], so only the visible part of
+/// large matrices is drawn and a heatmap gives an overview of the rest
+class MatrixWidget extends StatefulWidget {
   final Matrix matrix;
   final List<MapEntry<int, int>> highlightPoints;
   final Color? highlightColor;
@@ -19,54 +24,216 @@ class MatrixWidget extends StatelessWidget {
     this.inactiveColor,
   });
 
+  @override
+  State<MatrixWidget> createState() => _MatrixWidgetState();
+}
+
+class _MatrixWidgetState extends State<MatrixWidget> {
+  /// cells of the matrix, kept as long as the matrix and its style do not
+  /// change, so rebuilds of the screen do not measure it again
+  _MatrixGrid? _grid;
+
   @override
   Widget build(BuildContext context) {
-    double fontSize = Theme.of(context).textTheme.bodyMedium?.fontSize ?? 14;
-    num maxChars = log(matrix.largestEntry()) / log(10) + 1;
+    ThemeData theme = Theme.of(context);
+    TextStyle style = theme.textTheme.bodyMedium ?? const TextStyle();
+    Color highlightColor = widget.highlightColor ?? theme.highlightColor;
+    Color inactiveColor = widget.inactiveColor ?? theme.disabledColor;
+
+    _MatrixGrid? grid = _grid;
+    if (grid == null ||
+        !identical(grid.matrix, widget.matrix) ||
+        !identical(grid.highlightPoints, widget.highlightPoints) ||
+        grid.style != style ||
+        grid.highlightColor != highlightColor ||
+        grid.inactiveColor != inactiveColor) {
+      grid = _grid = _MatrixGrid(
+        widget.matrix,
+        widget.highlightPoints,
+        style,
+        highlightColor,
+        inactiveColor,
+        theme.colorScheme.surfaceContainerHighest,
+        theme.colorScheme.primary,
+      );
+    }
 
     return Container(
-      width: fontSize * maxChars * (matrix.dimension.m + 1),
       decoration: const BoxDecoration(
         border: Border(
           left: BorderSide(color: Colors.black, width: 2),
           right: BorderSide(color: Colors.black, width: 2),
         ),
       ),
-      child: Table(
-        children: [
-          for (int i = 0; i < matrix.dimension.m; i++)
-            TableRow(
-              children: [
-                for (int j = 0; j < matrix.dimension.n; j++)
-                  Builder(
-                    builder: (context) {
-                      Color? hightLight;
-
-                      for (var entry in highlightPoints) {
-                        if (entry.key == i && entry.value == j) {
-                          hightLight = highlightColor ??
-                              Theme.of(context).highlightColor;
-                          break;
-                        }
-                      }
-
-                      return Text(
-                        matrix[i][j].toString(),
-                        textAlign: TextAlign.center,
-                        style: TextStyle(
-                          color: highlightPoints.isEmpty
-                              ? null
-                              : hightLight ??
-                                  inactiveColor ??
-                                  Theme.of(context).disabledColor,
-                        ),
-                      );
-                    },
-                  ),
-              ],
-            ),
-        ],
-      ),
+      child: ScrollGrid(grid: grid),
     );
   }
 }
+
+/// cells of a [MatrixWidget]
+class _MatrixGrid extends GridPainter {
+  /// largest number of heatmap cells along each side
+  static const int _heatmapResolution = 160;
+
+  final Matrix matrix;
+  final List<MapEntry<int, int>> highlightPoints;
+  final TextStyle style;
+  final Color highlightColor;
+  final Color inactiveColor;
+
+  /// colors of the smallest and the largest entries in the heatmap
+  final Color lowColor;
+  final Color highColor;
+
+  /// highlighted cells as row * n + column, looked up in constant time
+  late final Set<int> _highlights = {
+    for (MapEntry<int, int> point in highlightPoints)
+      point.key * matrix.dimension.n + point.value,
+  };
+
+  /// smallest and largest entry
+  late final num _smallest = matrix.smallestEntry();
+  late final num _largest = matrix.largestEntry();
+
+  /// size of every cell, wide enough for the longest entry
+  late final Size _cell = () {
+    int chars = max(
+      _smallest.toString().length,
+      _largest.toString().length,
+    );
+    TextPainter painter = _layout("0" * chars, style);
+    Size cell = Size(painter.width + 8.0, painter.height + 4.0);
+    painter.dispose();
+    return cell;
+  }();
+
+  /// laid out entries by value, one cache per color
+  final Map<num, TextPainter> _plain = {};
+  final Map<num, TextPainter> _highlighted = {};
+  final Map<num, TextPainter> _inactive = {};
+
+  _MatrixGrid(
+    this.matrix,
+    this.highlightPoints,
+    this.style,
+    this.highlightColor,
+    this.inactiveColor,
+    this.lowColor,
+    this.highColor,
+  );
+
+  @override
+  Size get size => Size(
+        _cell.width * matrix.dimension.n,
+        _cell.height * matrix.dimension.m,
+      );
+
+  @override
+  void paintVisible(Canvas canvas, Rect visible) {
+    int firstRow = max(0, visible.top ~/ _cell.height);
+    int lastRow =
+        min(matrix.dimension.m, (visible.bottom / _cell.height).ceil());
+    int firstColumn = max(0, visible.left ~/ _cell.width);
+    int lastColumn =
+        min(matrix.dimension.n, (visible.right / _cell.width).ceil());
+
+    for (int i = firstRow; i < lastRow; i++) {
+      for (int j = firstColumn; j < lastColumn; j++) {
+        num value = matrix[i][j];
+        TextPainter painter = highlightPoints.isEmpty
+            ? _plain.putIfAbsent(value, () => _layout("$value", style))
+            : _highlights.contains(i * matrix.dimension.n + j)
+                ? _highlighted.putIfAbsent(
+                    value,
+                    () => _layout(
+                      "$value",
+                      style.copyWith(color: highlightColor),
+                    ),
+                  )
+                : _inactive.putIfAbsent(
+                    value,
+                    () => _layout(
+                      "$value",
+                      style.copyWith(color: inactiveColor),
+                    ),
+                  );
+
+        // entries are centered in their cell
+        painter.paint(
+          canvas,
+          Offset(
+            (j + 0.5) * _cell.width - painter.width / 2,
+            (i + 0.5) * _cell.height - painter.height / 2,
+          ),
+        );
+      }
+    }
+  }
+
+  @override
+  bool get hasOverview => true;
+
+  /// paint a heatmap of the mean entries of blocks of cells and mark the
+  /// highlighted cells
+  @override
+  void paintOverview(Canvas canvas, Size size) {
+    int m = matrix.dimension.m;
+    int n = matrix.dimension.n;
+    int rows = min(m, _heatmapResolution);
+    int columns = min(n, _heatmapResolution);
+
+    Float64List sums = Float64List(rows * columns);
+    Int32List counts = Int32List(rows * columns);
+    for (int i = 0; i < m; i++) {
+      int row = i * rows ~/ m;
+      for (int j = 0; j < n; j++) {
+        int block = row * columns + j * columns ~/ n;
+        sums[block] += matrix[i][j];
+        counts[block]++;
+      }
+    }
+
+    double width = size.width / columns;
+    double height = size.height / rows;
+    num range = max(1, _largest - _smallest);
+    Paint paint = Paint();
+    for (int row = 0; row < rows; row++) {
+      for (int column = 0; column < columns; column++) {
+        int block = row * columns + column;
+        double mean = sums[block] / counts[block];
+        paint.color = Color.lerp(
+          lowColor,
+          highColor,
+          ((mean - _smallest) / range).clamp(0.0, 1.0),
+        )!;
+        canvas.drawRect(
+          Rect.fromLTWH(column * width, row * height, width, height),
+          paint,
+        );
+      }
+    }
+
+    // highlighted cells are drawn at least one pixel large
+    paint.color = highlightColor;
+    double pointWidth = max(1.0, size.width / n);
+    double pointHeight = max(1.0, size.height / m);
+    for (MapEntry<int, int> point in highlightPoints) {
+      canvas.drawRect(
+        Rect.fromLTWH(
+          point.value * size.width / n,
+          point.key * size.height / m,
+          pointWidth,
+          pointHeight,
+        ),
+        paint,
+      );
+    }
+  }
+
+  /// internal helper to lay out [text] in one line
+  static TextPainter _layout(String text, TextStyle style) => TextPainter(
+        text: TextSpan(text: text, style: style),
+        textDirection: TextDirection.ltr,
+        maxLines: 1,
+      )..layout();
+}
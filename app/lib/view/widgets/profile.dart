@@ -0,0 +1,73 @@
+import 'package:flutter/material.dart';
+
+import '../../model/profile.dart';
+
+class ProfileWidget extends StatelessWidget {
+  /// stages and solver counters to display
+  final MatchProfile profile;
+
+  const ProfileWidget(this.profile, {super.key});
+
+  /// format [bytes] with a binary unit
+  static String _formatBytes(int bytes) {
+    if (bytes.abs() < 1024) return "$bytes B";
+    if (bytes.abs() < 1024 * 1024) {
+      return "${(bytes / 1024).toStringAsFixed(1)} KiB";
+    }
+    return "${(bytes / (1024 * 1024)).toStringAsFixed(1)} MiB";
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    TextStyle? style = Theme.of(context).textTheme.labelSmall;
+
+    return Card(
+      child: Padding(
+        padding: const EdgeInsets.all(8.0),
+        child: Column(
+          mainAxisSize: MainAxisSize.min,
+          crossAxisAlignment: CrossAxisAlignment.start,
+          children: [
+            Text(
+              "profile",
+              style: Theme.of(context).textTheme.titleSmall,
+            ),
+            Table(
+              defaultColumnWidth: const IntrinsicColumnWidth(),
+              children: [
+                for (StageProfile stage in profile.stages)
+                  TableRow(
+                    children: [
+                      Text(stage.name, style: style),
+                      const SizedBox(width: 8),
+                      Text(
+                        "${(stage.elapsed.inMicroseconds / 1000).toStringAsFixed(2)} ms",
+                        style: style,
+                        textAlign: TextAlign.right,
+                      ),
+                      const SizedBox(width: 8),
+                      Text(
+                        _formatBytes(stage.allocated),
+                        style: style,
+                        textAlign: TextAlign.right,
+                      ),
+                    ],
+                  ),
+              ],
+            ),
+            const SizedBox(height: 4),
+            for (MapEntry<String, SolverCounters> entry
+                in profile.counters.entries)
+              Text(
+                "${entry.key}: ${entry.value.augmentations} augmentations, "
+                "${entry.value.dualUpdates} dual updates, "
+                "${entry.value.scanned} scanned, "
+                "path length ${entry.value.pathLength}",
+                style: style,
+              ),
+          ],
+        ),
+      ),
+    );
+  }
+}
@@ -0,0 +1,223 @@
+import 'dart:math';
+
+import 'package:flutter/material.dart';
+
+/// cells of a [ScrollGrid], they are painted instead of built as widgets
+abstract class GridPainter {
+  /// size of the whole grid
+  Size get size;
+
+  /// paint the cells of the grid intersecting [visible], both in the
+  /// coordinates of the whole grid
+  void paintVisible(Canvas canvas, Rect visible);
+
+  /// flag wether [paintOverview] draws an overview of the grid
+  bool get hasOverview => false;
+
+  /// paint the whole grid scaled down to [size]
+  void paintOverview(Canvas canvas, Size size) {}
+}
+
+/// widget showing a [grid] of any size in a box of at most [maxWidth] x
+/// [maxHeight] that scrolls in both directions
+///
+/// only the cells within the box are painted, so the costs of building and
+/// scrolling do not depend on the size of the grid. grids larger than the
+/// box get an overview next to it that marks the visible part and scrolls
+/// to the tapped position
+class ScrollGrid extends StatefulWidget {
+  /// cells to show
+  final GridPainter grid;
+
+  /// largest size of the box
+  final double maxWidth;
+  final double maxHeight;
+
+  /// largest size of the overview
+  final double overviewExtent;
+
+  const ScrollGrid({
+    super.key,
+    required this.grid,
+    this.maxWidth = 640,
+    this.maxHeight = 480,
+    this.overviewExtent = 160,
+  });
+
+  @override
+  State<ScrollGrid> createState() => _ScrollGridState();
+}
+
+class _ScrollGridState extends State<ScrollGrid> {
+  final ScrollController _horizontal = ScrollController();
+  final ScrollController _vertical = ScrollController();
+
+  @override
+  void dispose() {
+    _horizontal.dispose();
+    _vertical.dispose();
+    super.dispose();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    Size size = widget.grid.size;
+    bool scrolls =
+        size.width > widget.maxWidth || size.height > widget.maxHeight;
+
+    Widget box = SizedBox(
+      width: min(size.width, widget.maxWidth),
+      height: min(size.height, widget.maxHeight),
+      child: Scrollbar(
+        controller: _vertical,
+        child: Scrollbar(
+          controller: _horizontal,
+          notificationPredicate: (notification) => notification.depth == 1,
+          child: SingleChildScrollView(
+            controller: _vertical,
+            child: SingleChildScrollView(
+              controller: _horizontal,
+              scrollDirection: Axis.horizontal,
+              child: CustomPaint(
+                size: size,
+                painter: _VisiblePainter(widget.grid, _horizontal, _vertical),
+              ),
+            ),
+          ),
+        ),
+      ),
+    );
+
+    if (!scrolls || !widget.grid.hasOverview) return box;
+
+    // the overview keeps the aspect ratio of the grid
+    double scale = widget.overviewExtent / max(size.width, size.height);
+    Size overviewSize = Size(size.width * scale, size.height * scale);
+
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        box,
+        const SizedBox(width: 8.0),
+        GestureDetector(
+          onTapDown: (details) => _scrollTo(details.localPosition / scale),
+          onPanUpdate: (details) => _scrollTo(details.localPosition / scale),
+          child: Stack(
+            children: [
+              // the cells of the overview are only painted once
+              RepaintBoundary(
+                child: CustomPaint(
+                  size: overviewSize,
+                  painter: _OverviewPainter(widget.grid),
+                ),
+              ),
+              CustomPaint(
+                size: overviewSize,
+                painter: _WindowPainter(
+                  scale,
+                  _horizontal,
+                  _vertical,
+                  Theme.of(context).colorScheme.onSurface,
+                ),
+              ),
+            ],
+          ),
+        ),
+      ],
+    );
+  }
+
+  /// internal method to center the box on [position] of the grid
+  void _scrollTo(Offset position) {
+    for (var (controller, center) in [
+      (_horizontal, position.dx),
+      (_vertical, position.dy),
+    ]) {
+      if (!controller.hasClients) continue;
+
+      ScrollPosition scroll = controller.position;
+      controller.jumpTo(
+        (center - scroll.viewportDimension / 2)
+            .clamp(scroll.minScrollExtent, scroll.maxScrollExtent),
+      );
+    }
+  }
+}
+
+/// internal helper to get the part of the grid scrolled into view
+Rect _visibleRect(
+  ScrollController horizontal,
+  ScrollController vertical,
+  Size size,
+) =>
+    Rect.fromLTWH(
+      horizontal.hasClients ? horizontal.offset : 0,
+      vertical.hasClients ? vertical.offset : 0,
+      horizontal.hasClients
+          ? horizontal.position.viewportDimension
+          : size.width,
+      vertical.hasClients ? vertical.position.viewportDimension : size.height,
+    );
+
+/// painter of the visible cells, repainted while scrolling
+class _VisiblePainter extends CustomPainter {
+  final GridPainter grid;
+  final ScrollController horizontal;
+  final ScrollController vertical;
+
+  _VisiblePainter(this.grid, this.horizontal, this.vertical)
+      : super(repaint: Listenable.merge([horizontal, vertical]));
+
+  @override
+  void paint(Canvas canvas, Size size) =>
+      grid.paintVisible(canvas, _visibleRect(horizontal, vertical, size));
+
+  @override
+  bool shouldRepaint(_VisiblePainter oldDelegate) => oldDelegate.grid != grid;
+}
+
+/// painter of the overview of a grid
+class _OverviewPainter extends CustomPainter {
+  final GridPainter grid;
+
+  _OverviewPainter(this.grid);
+
+  @override
+  void paint(Canvas canvas, Size size) => grid.paintOverview(canvas, size);
+
+  @override
+  bool shouldRepaint(_OverviewPainter oldDelegate) => oldDelegate.grid != grid;
+}
+
+/// painter of the frame of the visible part on the overview
+class _WindowPainter extends CustomPainter {
+  final double scale;
+  final ScrollController horizontal;
+  final ScrollController vertical;
+  final Color color;
+
+  _WindowPainter(this.scale, this.horizontal, this.vertical, this.color)
+      : super(repaint: Listenable.merge([horizontal, vertical]));
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    Rect visible = _visibleRect(horizontal, vertical, size / scale);
+    canvas.drawRect(
+      Rect.fromLTRB(
+        visible.left * scale,
+        visible.top * scale,
+        visible.right * scale,
+        visible.bottom * scale,
+      ),
+      Paint()
+        ..color = color
+        ..style = PaintingStyle.stroke
+        ..strokeWidth = 1.5,
+    );
+  }
+
+  @override
+  bool shouldRepaint(_WindowPainter oldDelegate) =>
+      oldDelegate.scale != scale || oldDelegate.color != color;
+}
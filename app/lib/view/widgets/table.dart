@@ -4,9 +4,13 @@ import 'package:flutter/material.dart';
 
 import '../../model/matrix_storage.dart';
 import '../../model/table_position.dart';
+import 'scroll_grid.dart';
 
 /// widget to display the input table and hightlight errors
-class TableWidget extends StatelessWidget {
+///
+/// the cells are painted by a [ScrollGrid], so only the visible part of
+/// large tables is drawn
+class TableWidget extends StatefulWidget {
   /// table containig data to display
   final MatrixStorage<String> table;
 
@@ -25,47 +29,169 @@ class TableWidget extends StatelessWidget {
   });
 
   @override
-  Widget build(BuildContext context) => Table(
-        border: TableBorder.all(
-          color: Theme.of(context).dividerColor,
-        ),
-        children: [
-          for (int i = 0; i < table.length; i++)
-            TableRow(
-              children: [
-                for (int j = 0; j < table[i].length; j++)
-                  Container(
-                    color: (highlightPosition?.row == i &&
-                                highlightPosition?.column == null) ||
-                            (highlightPosition?.row == null &&
-                                (highlightPosition?.rowOffset ?? 0) <= i &&
-                                highlightPosition?.column == j) ||
-                            (highlightPosition?.row == i &&
-                                highlightPosition?.column == j)
-                        ? highlightColor ?? Theme.of(context).colorScheme.error
-                        : null,
-                    child: Padding(
-                      padding: const EdgeInsets.all(8.0),
-                      child: Text(
-                        table[i][j],
-                      ),
-                    ),
-                  ),
-                for (int j = table[i].length; j < tableWidth(); j++)
-                  const SizedBox(),
-              ],
-            ),
-        ],
+  State<TableWidget> createState() => _TableWidgetState();
+}
+
+class _TableWidgetState extends State<TableWidget> {
+  /// cells of the table, kept as long as the table and its style do not
+  /// change, so rebuilds of the screen do not measure it again
+  _TableGrid? _grid;
+
+  @override
+  Widget build(BuildContext context) {
+    ThemeData theme = Theme.of(context);
+    TextStyle style = theme.textTheme.bodyMedium ?? const TextStyle();
+    Color highlightColor = widget.highlightColor ?? theme.colorScheme.error;
+
+    _TableGrid? grid = _grid;
+    if (grid == null ||
+        !identical(grid.table, widget.table) ||
+        grid.highlightPosition != widget.highlightPosition ||
+        grid.style != style ||
+        grid.borderColor != theme.dividerColor ||
+        grid.highlightColor != highlightColor) {
+      grid = _grid = _TableGrid(
+        widget.table,
+        widget.highlightPosition,
+        style,
+        theme.dividerColor,
+        highlightColor,
       );
+    }
+
+    return ScrollGrid(grid: grid, maxWidth: double.infinity);
+  }
+}
 
-  /// internal method to calculate table width
-  int tableWidth() {
-    int width = 0;
+/// cells of a [TableWidget]
+class _TableGrid extends GridPainter {
+  /// space around the text of each cell
+  static const double _padding = 8.0;
 
-    for (List<String> row in table) {
-      width = max(width, row.length);
+  final MatrixStorage<String> table;
+  final TablePosition? highlightPosition;
+  final TextStyle style;
+  final Color borderColor;
+  final Color highlightColor;
+
+  /// number of columns of the longest row
+  late final int _columns =
+      table.fold<int>(0, (width, row) => max(width, row.length));
+
+  /// left edge of every column and the right edge of the last one, each
+  /// column is as wide as its longest text
+  late final List<double> _edges = () {
+    List<double> edges = [0];
+    for (int j = 0; j < _columns; j++) {
+      String longest = "";
+      for (List<String> row in table) {
+        if (j < row.length && row[j].length > longest.length) {
+          longest = row[j];
+        }
+      }
+
+      TextPainter painter = _layout(longest);
+      edges.add(edges.last + painter.width + 2 * _padding);
+      painter.dispose();
     }
+    return edges;
+  }();
+
+  /// height of every row
+  late final double _rowHeight = () {
+    TextPainter painter = _layout("");
+    double height = painter.height + 2 * _padding;
+    painter.dispose();
+    return height;
+  }();
+
+  _TableGrid(
+    this.table,
+    this.highlightPosition,
+    this.style,
+    this.borderColor,
+    this.highlightColor,
+  );
 
-    return width;
+  @override
+  Size get size => Size(_edges.last, _rowHeight * table.length);
+
+  @override
+  void paintVisible(Canvas canvas, Rect visible) {
+    int firstRow = max(0, visible.top ~/ _rowHeight);
+    int lastRow = min(table.length, (visible.bottom / _rowHeight).ceil());
+
+    // the edges are sorted, so the visible columns are found by bisection
+    int firstColumn = max(0, _upperBound(visible.left) - 1);
+    int lastColumn = min(_columns, _upperBound(visible.right));
+
+    Paint highlight = Paint()..color = highlightColor;
+    for (int i = firstRow; i < lastRow; i++) {
+      for (int j = firstColumn; j < min(lastColumn, table[i].length); j++) {
+        Rect cell = Rect.fromLTRB(
+          _edges[j],
+          i * _rowHeight,
+          _edges[j + 1],
+          (i + 1) * _rowHeight,
+        );
+        if (_highlighted(i, j)) canvas.drawRect(cell, highlight);
+
+        TextPainter painter = _layout(table[i][j], cell.width - 2 * _padding);
+        painter.paint(canvas, cell.topLeft.translate(_padding, _padding));
+        painter.dispose();
+      }
+    }
+
+    // grid lines of the visible part
+    Paint border = Paint()..color = borderColor;
+    double top = firstRow * _rowHeight;
+    double bottom = lastRow * _rowHeight;
+    for (int i = firstRow; i <= lastRow; i++) {
+      canvas.drawLine(
+        Offset(_edges[firstColumn], i * _rowHeight),
+        Offset(_edges[lastColumn], i * _rowHeight),
+        border,
+      );
+    }
+    for (int j = firstColumn; j <= lastColumn; j++) {
+      canvas.drawLine(
+        Offset(_edges[j], top),
+        Offset(_edges[j], bottom),
+        border,
+      );
+    }
+  }
+
+  /// internal method to check wether the cell at row [i] and column [j] is
+  /// part of [highlightPosition]
+  bool _highlighted(int i, int j) =>
+      (highlightPosition?.row == i && highlightPosition?.column == null) ||
+      (highlightPosition?.row == null &&
+          (highlightPosition?.rowOffset ?? 0) <= i &&
+          highlightPosition?.column == j) ||
+      (highlightPosition?.row == i && highlightPosition?.column == j);
+
+  /// internal method to get the number of column edges at or left of [x]
+  int _upperBound(double x) {
+    int low = 0;
+    int high = _edges.length;
+    while (low < high) {
+      int middle = (low + high) ~/ 2;
+      if (_edges[middle] <= x) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
   }
+
+  /// internal helper to lay out [text] in one line of at most [width]
+  TextPainter _layout(String text, [double width = double.infinity]) =>
+      TextPainter(
+        text: TextSpan(text: text, style: style),
+        textDirection: TextDirection.ltr,
+        maxLines: 1,
+        ellipsis: "…",
+      )..layout(maxWidth: width);
 }
@@ -0,0 +1,866 @@
+// Benchmark of the native matching pipeline. It generates a seeded synthetic
+// input file, runs every stage of the pipeline for each solver and reports the
+// timings as json, so runs on different machines or versions can be compared.
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auction_solver.h"
+#include "component_solver.h"
+#include "cost_width.h"
+#include "incremental_solver.h"
+#include "input_cache.h"
+#include "input_file.h"
+#include "lap_solver.h"
+#include "matching.h"
+#include "simd_kernels.h"
+#include "solver_stats.h"
+#include "sparse_lap_solver.h"
+#include "transportation_solver.h"
+
+namespace {
+
+// rating given to tied pairs
+constexpr int64_t kTieRating = 8;
+
+struct Options {
+  int persons = 200;
+
+  // 0 selects as many wgs as needed to seat every person
+  int wgs = 0;
+  int seats = 1;
+  double veto_density = 0.1;
+  double tie_density = 0.0;
+  int64_t seed = 1;
+  int repeat = 3;
+  int64_t direct_match_bonus = belegium::kDefaultDirectMatchBonus;
+
+  // threads of the auction and component solvers, 0 selects one per hardware
+  // thread
+  int threads = 0;
+
+  // instruction set of the kernels, lowered to the best supported one
+  belegium::SimdLevel simd = belegium::SupportedSimdLevel();
+
+  // the generated file is kept if set
+  std::string csv_path;
+
+  // the report is written to stdout if empty
+  std::string output_path;
+};
+
+void PrintUsage() {
+  std::printf(
+      "Usage:\n"
+      "\n"
+      "  belegium_matcher_bench [OPTIONS]\n"
+      "\n"
+      "Options:\n"
+      "  --help                Show this usage information.\n"
+      "  --persons <number>    Number of persons (default: 200).\n"
+      "  --wgs <number>        Number of wgs (default: enough to seat every "
+      "person).\n"
+      "  --seats <number>      Seats of every wg (default: 1).\n"
+      "  --veto-density <x>    Share of vetoed ratings (default: 0.1).\n"
+      "  --tie-density <x>     Share of ratings set to %lld to create ties "
+      "(default: 0).\n"
+      "  --seed <number>       Seed of the instance generator (default: 1).\n"
+      "  --repeat <number>     Number of timed runs (default: 3).\n"
+      "  --extra <number>      Specify an optional number of extra points for "
+      "direct match (default: 10).\n"
+      "  --threads <number>    Threads of the auction and component solvers "
+      "(default: one per hardware thread).\n"
+      "  --simd <level>        Kernels to use: scalar, sse4 or avx2 "
+      "(default: best supported).\n"
+      "  --csv <file>          Keep the generated input file at this path.\n"
+      "  --output <file>       Write the report to this file instead of "
+      "stdout.\n",
+      static_cast<long long>(kTieRating));
+}
+
+// Parses |text| as a whole number into |value|.
+bool ParseNumber(const char* text, int64_t* value) {
+  char* end = nullptr;
+  long long parsed = std::strtoll(text, &end, 10);
+  if (end == text || *end != '\0') return false;
+  *value = parsed;
+  return true;
+}
+
+// Parses |text| as a whole number in [|min|, |max|] into |value|.
+bool ParseCount(const char* text, int min, int max, int* value) {
+  int64_t parsed = 0;
+  if (!ParseNumber(text, &parsed) || parsed < min || parsed > max) {
+    return false;
+  }
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+// Parses |text| as a share in [0, 1] into |value|.
+bool ParseDensity(const char* text, double* value) {
+  char* end = nullptr;
+  double parsed = std::strtod(text, &end);
+  if (end == text || *end != '\0' || !(parsed >= 0.0 && parsed <= 1.0)) {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+// Parses |text| as the name of a SimdLevel into |level|.
+bool ParseSimdLevel(const char* text, belegium::SimdLevel* level) {
+  for (belegium::SimdLevel candidate :
+       {belegium::SimdLevel::kScalar, belegium::SimdLevel::kSse4,
+        belegium::SimdLevel::kAvx2}) {
+    if (std::strcmp(text, belegium::SimdLevelName(candidate)) == 0) {
+      *level = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Matches argv[*i] against the option |name| given as "--name value" or
+// "--name=value". On a match |value| points to the value or is null if it is
+// missing.
+bool MatchOption(int argc,
+                 char** argv,
+                 int* i,
+                 const char* name,
+                 const char** value) {
+  const char* arg = argv[*i];
+  size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) != 0) return false;
+
+  if (arg[length] == '=') {
+    *value = arg + length + 1;
+    return true;
+  }
+
+  if (arg[length] != '\0') return false;
+
+  *value = *i + 1 < argc ? argv[++*i] : nullptr;
+  return true;
+}
+
+// Returns false if the command line is invalid.
+bool ParseOptions(int argc, char** argv, Options* options, bool* help) {
+  for (int i = 1; i < argc; i++) {
+    const char* value = nullptr;
+    bool valid = true;
+
+    if (std::strcmp(argv[i], "--help") == 0) {
+      *help = true;
+    } else if (MatchOption(argc, argv, &i, "--persons", &value)) {
+      valid = value && ParseCount(value, 1, 1 << 20, &options->persons);
+    } else if (MatchOption(argc, argv, &i, "--wgs", &value)) {
+      valid = value && ParseCount(value, 1, 1 << 20, &options->wgs);
+    } else if (MatchOption(argc, argv, &i, "--seats", &value)) {
+      valid = value && ParseCount(value, 1, 1 << 20, &options->seats);
+    } else if (MatchOption(argc, argv, &i, "--veto-density", &value)) {
+      valid = value && ParseDensity(value, &options->veto_density);
+    } else if (MatchOption(argc, argv, &i, "--tie-density", &value)) {
+      valid = value && ParseDensity(value, &options->tie_density);
+    } else if (MatchOption(argc, argv, &i, "--seed", &value)) {
+      valid = value && ParseNumber(value, &options->seed);
+    } else if (MatchOption(argc, argv, &i, "--repeat", &value)) {
+      valid = value && ParseCount(value, 1, 1 << 20, &options->repeat);
+    } else if (MatchOption(argc, argv, &i, "--extra", &value)) {
+      valid = value && ParseNumber(value, &options->direct_match_bonus);
+    } else if (MatchOption(argc, argv, &i, "--threads", &value)) {
+      valid = value && ParseCount(value, 0, 1 << 10, &options->threads);
+    } else if (MatchOption(argc, argv, &i, "--simd", &value)) {
+      valid = value && ParseSimdLevel(value, &options->simd);
+    } else if (MatchOption(argc, argv, &i, "--csv", &value)) {
+      valid = value != nullptr;
+      if (valid) options->csv_path = value;
+    } else if (MatchOption(argc, argv, &i, "--output", &value)) {
+      valid = value != nullptr;
+      if (valid) options->output_path = value;
+    } else {
+      valid = false;
+    }
+
+    if (!valid) return false;
+  }
+
+  if (options->veto_density + options->tie_density > 1.0) return false;
+
+  if (options->wgs == 0) {
+    options->wgs = (options->persons + options->seats - 1) / options->seats;
+  }
+
+  return true;
+}
+
+// Returns a uniformly distributed number in [0, 1). Unlike the distributions
+// of <random> it gives the same sequence with every standard library.
+double Uniform(std::mt19937_64* random) {
+  return static_cast<double>((*random)() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Returns the next generated rating in [0, kPerfectRating].
+int64_t Rating(const Options& options, std::mt19937_64* random) {
+  double x = Uniform(random);
+  if (x < options.veto_density) return belegium::kVetoRating;
+  if (x < options.veto_density + options.tie_density) return kTieRating;
+  return 1 + static_cast<int64_t>((*random)() % belegium::kPerfectRating);
+}
+
+// Writes one table of ratings with |rows| x |columns| entries.
+void WriteTable(FILE* file,
+                const char* row_prefix,
+                int rows,
+                const char* column_prefix,
+                int columns,
+                const Options& options,
+                std::mt19937_64* random) {
+  for (int j = 0; j < columns; j++) {
+    std::fprintf(file, ";%s%d", column_prefix, j);
+  }
+  std::fprintf(file, "\n");
+
+  for (int i = 0; i < rows; i++) {
+    std::fprintf(file, "%s%d", row_prefix, i);
+    for (int j = 0; j < columns; j++) {
+      std::fprintf(file, ";%lld",
+                   static_cast<long long>(Rating(options, random)));
+    }
+    std::fprintf(file, "\n");
+  }
+}
+
+// Writes the seeded instance of |options| in the input file format to |file|.
+void WriteInstance(FILE* file, const Options& options) {
+  std::mt19937_64 random(static_cast<uint64_t>(options.seed));
+
+  WriteTable(file, "p", options.persons, "w", options.wgs, options, &random);
+  for (int j = 0; j < std::max(options.persons, options.wgs); j++) {
+    std::fprintf(file, ";");
+  }
+  std::fprintf(file, "\n");
+  WriteTable(file, "w", options.wgs, "p", options.persons, options, &random);
+}
+
+class Stopwatch {
+ public:
+  // Returns the milliseconds since the construction or the last call.
+  double Lap() {
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    double elapsed =
+        std::chrono::duration<double, std::milli>(now - start_).count();
+    start_ = now;
+    return elapsed;
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_ =
+      std::chrono::steady_clock::now();
+};
+
+// Timings of one stage over all runs.
+struct Samples {
+  std::vector<double> milliseconds;
+
+  void Add(double value) { milliseconds.push_back(value); }
+};
+
+// Results of one combination function with one solver.
+struct ProblemReport {
+  belegium::Combination combination;
+  int rows = 0;
+  int columns = 0;
+  int64_t costs = 0;
+
+  // rows left unassigned because of vetoes or missing columns
+  int unassigned = 0;
+
+  // type the costs were solved in
+  belegium::CostWidth cost_width = belegium::CostWidth::kInt64;
+  belegium::SolverStats stats;
+  Samples combine;
+  Samples invert;
+  Samples solve;
+};
+
+struct SolverReport {
+  const char* name;
+  Samples wall;
+
+  // copying the columns of wgs with several seats and padding
+  Samples expand;
+  std::vector<ProblemReport> problems;
+};
+
+// Copies every wg |seats| times like MatchService._copyColumns.
+void CopySeats(const belegium::Matrix& a,
+               const belegium::Matrix& b,
+               int seats,
+               belegium::Matrix* copied_a,
+               belegium::Matrix* copied_b) {
+  *copied_a = belegium::Matrix(a.m, a.n * seats);
+  for (int i = 0; i < copied_a->m; i++) {
+    for (int k = 0; k < copied_a->n; k++) (*copied_a)[i][k] = a[i][k % a.n];
+  }
+
+  *copied_b = belegium::Matrix(b.m * seats, b.n);
+  for (int k = 0; k < copied_b->m; k++) {
+    std::copy(b[k % b.m], b[k % b.m] + b.n, (*copied_b)[k]);
+  }
+}
+
+// Copies the seats like CopySeats and pads both matrices to the square size.
+void ExpandSeats(const belegium::Matrix& a,
+                 const belegium::Matrix& b,
+                 int seats,
+                 belegium::Matrix* square_a,
+                 belegium::Matrix* square_b) {
+  belegium::Matrix copied_a;
+  belegium::Matrix copied_b;
+  CopySeats(a, b, seats, &copied_a, &copied_b);
+
+  *square_a = belegium::Quadratic(copied_a, belegium::kVetoScore);
+  *square_b = belegium::Quadratic(copied_b, belegium::kVetoScore);
+}
+
+// Runs all combinations with the Jonker-Volgenant solver on the expanded
+// square problem, the way MatchService does without the native flow solver.
+void RunJonkerVolgenant(const belegium::InputTables& tables,
+                        int seats,
+                        SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  ExpandSeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  belegium::LapSolver solver;
+  std::vector<int32_t> row_to_col(a.n);
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    // the costs are built in the narrowest integer type holding them
+    belegium::CostMatrix inverse = belegium::InvertProblemCosts(costs);
+    problem.invert.Add(stage.Lap());
+
+    problem.costs = inverse.Solve([&](const auto* cells, int stride) {
+      return solver.Solve(cells, inverse.n(), stride, row_to_col.data());
+    });
+    problem.solve.Add(stage.Lap());
+    problem.cost_width = inverse.width();
+
+    problem.rows = inverse.m();
+    problem.columns = inverse.n();
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the Jonker-Volgenant solver on the problem with
+// copied seats, which is solved without padding it to a square one.
+void RunRectangular(const belegium::InputTables& tables,
+                    int seats,
+                    SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  CopySeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  belegium::LapSolver solver;
+  std::vector<int32_t> row_to_col(a.m);
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::CostMatrix inverse = belegium::InvertProblemCosts(costs);
+    problem.invert.Add(stage.Lap());
+
+    problem.costs = inverse.Solve([&](const auto* cells, int stride) {
+      return solver.SolveRectangular(cells, inverse.m(), inverse.n(), stride,
+                                     row_to_col.data());
+    });
+    problem.solve.Add(stage.Lap());
+    problem.cost_width = inverse.width();
+
+    problem.rows = inverse.m();
+    problem.columns = inverse.n();
+    problem.unassigned = static_cast<int>(
+        std::count(row_to_col.begin(), row_to_col.end(), -1));
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the auction solver on the expanded square
+// problem.
+void RunAuction(const belegium::InputTables& tables,
+                int seats,
+                int threads,
+                SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  ExpandSeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  belegium::AuctionSolver solver(threads);
+  std::vector<int32_t> row_to_col(a.n);
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::CostMatrix inverse = belegium::InvertProblemCosts(costs);
+    problem.invert.Add(stage.Lap());
+
+    problem.costs = inverse.Solve([&](const auto* cells, int stride) {
+      return solver.Solve(cells, inverse.n(), stride, row_to_col.data());
+    });
+    problem.solve.Add(stage.Lap());
+    problem.cost_width = inverse.width();
+
+    problem.rows = inverse.m();
+    problem.columns = inverse.n();
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the component solver on the expanded square
+// problem, whose vetoes and padding can split it into independent ones.
+void RunComponents(const belegium::InputTables& tables,
+                   int seats,
+                   int threads,
+                   SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  ExpandSeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  belegium::ComponentSolver solver(threads);
+  std::vector<int32_t> row_to_col(a.n);
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::CostMatrix inverse = belegium::InvertProblemCosts(costs);
+    problem.invert.Add(stage.Lap());
+
+    problem.costs = inverse.Solve([&](const auto* cells, int stride) {
+      return solver.Solve(cells, inverse.n(), stride, row_to_col.data());
+    });
+    problem.solve.Add(stage.Lap());
+    problem.cost_width = inverse.width();
+
+    problem.rows = inverse.m();
+    problem.columns = inverse.n();
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the incremental solver on the expanded square
+// problem. Each problem is solved once, then the cost of a single pair is
+// changed and only the re-solve is timed.
+void RunIncremental(const belegium::InputTables& tables,
+                    int seats,
+                    SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  ExpandSeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  std::vector<int32_t> row_to_col(a.n);
+
+  for (ProblemReport& problem : report->problems) {
+    belegium::IncrementalSolver solver;
+
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::Matrix inverse = belegium::InvertProblem(costs);
+    problem.invert.Add(stage.Lap());
+
+    solver.Solve(inverse.data.data(), inverse.n, inverse.n,
+                 row_to_col.data());
+    inverse[0][0] += 1;
+
+    stage.Lap();
+    problem.costs = solver.Solve(inverse.data.data(), inverse.n, inverse.n,
+                                 row_to_col.data());
+    problem.solve.Add(stage.Lap());
+
+    problem.rows = inverse.m;
+    problem.columns = inverse.n;
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the transportation solver on the rectangular
+// problem, the seats are passed as column capacities.
+void RunTransportation(const belegium::InputTables& tables,
+                       int seats,
+                       SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  std::vector<int32_t> row_capacities(tables.a.m, 1);
+  std::vector<int32_t> column_capacities(tables.a.n, seats);
+  report->expand.Add(stage.Lap());
+
+  belegium::TransportationSolver solver;
+  std::vector<int32_t> rows;
+  std::vector<int32_t> columns;
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(tables.a, tables.b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::Matrix inverse = belegium::InvertProblem(costs);
+    problem.invert.Add(stage.Lap());
+
+    rows.clear();
+    columns.clear();
+    problem.costs =
+        solver.Solve(inverse.data.data(), inverse.m, inverse.n,
+                     row_capacities.data(), column_capacities.data(), &rows,
+                     &columns);
+    problem.solve.Add(stage.Lap());
+
+    problem.rows = inverse.m;
+    problem.columns = inverse.n;
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Runs all combinations with the sparse solver on the problem with copied
+// seats but without padding. Vetoes are left out as forbidden pairs, the
+// number of persons that cannot be placed is reported.
+void RunSparse(const belegium::InputTables& tables,
+               int seats,
+               SolverReport* report) {
+  Stopwatch total;
+  Stopwatch stage;
+
+  belegium::Matrix a;
+  belegium::Matrix b;
+  CopySeats(tables.a, tables.b, seats, &a, &b);
+  report->expand.Add(stage.Lap());
+
+  belegium::SparseLapSolver solver;
+  std::vector<int32_t> row_to_col(a.m);
+
+  for (ProblemReport& problem : report->problems) {
+    stage.Lap();
+    belegium::Matrix costs =
+        belegium::CombineProblem(a, b, problem.combination);
+    problem.combine.Add(stage.Lap());
+
+    belegium::SparseProblem inverse =
+        belegium::AllowedPairs(belegium::InvertProblem(costs), a);
+    problem.invert.Add(stage.Lap());
+
+    problem.costs = solver.Solve(inverse, row_to_col.data());
+    problem.solve.Add(stage.Lap());
+
+    problem.rows = inverse.m;
+    problem.columns = inverse.n;
+    problem.unassigned = static_cast<int>(solver.unassigned_rows().size());
+    problem.stats = solver.stats();
+  }
+
+  report->wall.Add(total.Lap());
+}
+
+// Returns the peak resident set size of the process in kilobytes.
+long PeakRssKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  return usage.ru_maxrss;
+}
+
+void PrintSamples(FILE* out, const char* name, const Samples& samples) {
+  const std::vector<double>& values = samples.milliseconds;
+  double sum = 0;
+  for (double value : values) sum += value;
+
+  std::fprintf(out,
+               "\"%s\": {\"min_ms\": %.3f, \"mean_ms\": %.3f, "
+               "\"max_ms\": %.3f}",
+               name, *std::min_element(values.begin(), values.end()),
+               sum / values.size(),
+               *std::max_element(values.begin(), values.end()));
+}
+
+void PrintReport(FILE* out,
+                 const Options& options,
+                 long file_bytes,
+                 int64_t vetoes,
+                 const Samples& generate,
+                 const Samples& load,
+                 const Samples& load_cached,
+                 const Samples& extrema,
+                 const std::vector<SolverReport>& solvers,
+                 double wall_ms) {
+  std::fprintf(out, "{\n");
+  std::fprintf(out,
+               "  \"config\": {\"persons\": %d, \"wgs\": %d, \"seats\": %d, "
+               "\"veto_density\": %g, \"tie_density\": %g, \"seed\": %lld, "
+               "\"repeat\": %d, \"extra\": %lld, \"threads\": %d, "
+               "\"simd\": \"%s\"},\n",
+               options.persons, options.wgs, options.seats,
+               options.veto_density, options.tie_density,
+               static_cast<long long>(options.seed), options.repeat,
+               static_cast<long long>(options.direct_match_bonus),
+               options.threads, belegium::SimdLevelName(options.simd));
+  std::fprintf(out,
+               "  \"instance\": {\"bytes\": %ld, \"cells\": %lld, "
+               "\"vetoes\": %lld},\n",
+               file_bytes,
+               2LL * options.persons * options.wgs,
+               static_cast<long long>(vetoes));
+
+  std::fprintf(out, "  \"stages\": {\n    ");
+  PrintSamples(out, "generate", generate);
+  std::fprintf(out, ",\n    ");
+  PrintSamples(out, "load", load);
+  std::fprintf(out, ",\n    ");
+  PrintSamples(out, "load_cached", load_cached);
+  std::fprintf(out, ",\n    ");
+  PrintSamples(out, "extrema", extrema);
+  std::fprintf(out, "\n  },\n");
+
+  std::fprintf(out, "  \"solvers\": [\n");
+  for (size_t s = 0; s < solvers.size(); s++) {
+    const SolverReport& solver = solvers[s];
+    std::fprintf(out, "    {\n      \"name\": \"%s\",\n      ", solver.name);
+    PrintSamples(out, "wall", solver.wall);
+    std::fprintf(out, ",\n      \"stages\": {");
+    PrintSamples(out, "expand", solver.expand);
+    std::fprintf(out, "},\n      \"problems\": [\n");
+
+    for (size_t k = 0; k < solver.problems.size(); k++) {
+      const ProblemReport& problem = solver.problems[k];
+      std::fprintf(out,
+                   "        {\"combination\": \"%s\", \"rows\": %d, "
+                   "\"columns\": %d, \"costs\": %lld, "
+                   "\"unassigned\": %d, \"cost_width\": \"%s\", "
+                   "\"augmentations\": %lld, \"scanned\": %lld, "
+                   "\"dual_updates\": %lld, \"path_length\": %lld,\n"
+                   "         \"stages\": {",
+                   belegium::CombinationDescription(problem.combination),
+                   problem.rows, problem.columns,
+                   static_cast<long long>(problem.costs), problem.unassigned,
+                   belegium::CostWidthName(problem.cost_width),
+                   static_cast<long long>(problem.stats.augmentations),
+                   static_cast<long long>(problem.stats.scanned),
+                   static_cast<long long>(problem.stats.dual_updates),
+                   static_cast<long long>(problem.stats.path_length));
+      PrintSamples(out, "combine", problem.combine);
+      std::fprintf(out, ", ");
+      PrintSamples(out, "invert", problem.invert);
+      std::fprintf(out, ", ");
+      PrintSamples(out, "solve", problem.solve);
+      std::fprintf(out, "}}%s\n", k + 1 < solver.problems.size() ? "," : "");
+    }
+
+    std::fprintf(out, "      ]\n    }%s\n", s + 1 < solvers.size() ? "," : "");
+  }
+  std::fprintf(out, "  ],\n");
+
+  std::fprintf(out, "  \"wall_ms\": %.3f,\n", wall_ms);
+  std::fprintf(out, "  \"peak_rss_kb\": %ld\n", PeakRssKilobytes());
+  std::fprintf(out, "}\n");
+}
+
+// Removes |directory| and the files in it.
+void RemoveDirectory(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) return;
+  while (struct dirent* entry = readdir(dir)) {
+    if (std::strcmp(entry->d_name, ".") == 0 ||
+        std::strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    unlink((directory + "/" + entry->d_name).c_str());
+  }
+  closedir(dir);
+  rmdir(directory.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  bool help = false;
+  if (!ParseOptions(argc, argv, &options, &help)) {
+    PrintUsage();
+    return 1;
+  }
+  if (help) {
+    PrintUsage();
+    return 0;
+  }
+  options.simd = belegium::SelectSimdLevel(options.simd);
+
+  Stopwatch wall;
+  Stopwatch stage;
+
+  // write the instance to the requested or a temporary file
+  std::string path = options.csv_path;
+  FILE* file = nullptr;
+  if (path.empty()) {
+    const char* directory = std::getenv("TMPDIR");
+    path = std::string(directory ? directory : "/tmp") +
+           "/belegium_bench_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd >= 0) file = fdopen(fd, "w");
+  } else {
+    file = std::fopen(path.c_str(), "w");
+  }
+
+  if (file == nullptr) {
+    std::fprintf(stderr, "error: Could not create %s\n", path.c_str());
+    return 1;
+  }
+
+  Samples generate;
+  WriteInstance(file, options);
+  long file_bytes = std::ftell(file);
+  std::fclose(file);
+  generate.Add(stage.Lap());
+
+  // the cache of the parsed instance is kept in a temporary directory, it is
+  // written once before the runs, so they only read it
+  std::string cache_directory = "/tmp/belegium_bench_cache_XXXXXX";
+  if (mkdtemp(&cache_directory[0]) == nullptr) cache_directory.clear();
+  {
+    belegium::InputTables tables;
+    belegium::InputError error;
+    belegium::LoadInputFileCached(path, cache_directory, &tables, &error);
+  }
+  stage.Lap();
+
+  Samples load;
+  Samples load_cached;
+  Samples extrema;
+  int64_t vetoes = 0;
+
+  std::vector<SolverReport> solvers = {
+      {"jonker_volgenant", {}, {}, {}},
+      {"transportation", {}, {}, {}},
+      {"incremental", {}, {}, {}},
+      {"sparse", {}, {}, {}},
+      {"auction", {}, {}, {}},
+      {"rectangular", {}, {}, {}},
+      {"components", {}, {}, {}},
+  };
+  for (SolverReport& solver : solvers) {
+    for (int k = 0; k < belegium::kCombinationCount; k++) {
+      solver.problems.push_back(ProblemReport());
+      solver.problems.back().combination = belegium::CombinationAt(k);
+    }
+  }
+
+  int status = 0;
+  for (int run = 0; run < options.repeat; run++) {
+    stage.Lap();
+    belegium::InputTables tables;
+    belegium::InputError error;
+    if (!belegium::LoadInputFile(path, &tables, &error)) {
+      std::fprintf(stderr, "error: %s\n", error.message.c_str());
+      status = 1;
+      break;
+    }
+    load.Add(stage.Lap());
+
+    {
+      belegium::InputTables cached;
+      belegium::LoadInputFileCached(path, cache_directory, &cached, &error);
+      load_cached.Add(stage.Lap());
+    }
+
+    belegium::ProcessExtrema(&tables.a, &tables.b, options.direct_match_bonus);
+    extrema.Add(stage.Lap());
+
+    vetoes = std::count(tables.a.data.begin(), tables.a.data.end(),
+                        belegium::kVetoScore);
+
+    RunJonkerVolgenant(tables, options.seats, &solvers[0]);
+    RunTransportation(tables, options.seats, &solvers[1]);
+    RunIncremental(tables, options.seats, &solvers[2]);
+    RunSparse(tables, options.seats, &solvers[3]);
+    RunAuction(tables, options.seats, options.threads, &solvers[4]);
+    RunRectangular(tables, options.seats, &solvers[5]);
+    RunComponents(tables, options.seats, options.threads, &solvers[6]);
+  }
+
+  if (options.csv_path.empty()) unlink(path.c_str());
+  RemoveDirectory(cache_directory);
+  if (status != 0) return status;
+
+  FILE* out = stdout;
+  if (!options.output_path.empty()) {
+    out = std::fopen(options.output_path.c_str(), "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "error: Could not create %s\n",
+                   options.output_path.c_str());
+      return 1;
+    }
+  }
+
+  PrintReport(out, options, file_bytes, vetoes, generate, load, load_cached,
+              extrema, solvers, wall.Lap());
+
+  if (out != stdout) std::fclose(out);
+  return 0;
+}
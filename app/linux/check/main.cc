@@ -0,0 +1,906 @@
+// Brute-force cross-check of the native matching core. It generates seeded
+// small problems, solves them with every solver at every supported
+// instruction set and cost width and compares the results with references
+// that enumerate all assignments, so a faster solver or kernel that breaks an
+// edge case is caught before it reaches the app. Exits with status 1 if a
+// result differs.
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "auction_solver.h"
+#include "component_solver.h"
+#include "cost_width.h"
+#include "incremental_solver.h"
+#include "input_cache.h"
+#include "input_file.h"
+#include "k_best_solver.h"
+#include "lap_solver.h"
+#include "matching.h"
+#include "score_expression.h"
+#include "sensitivity.h"
+#include "simd_kernels.h"
+#include "sparse_lap_solver.h"
+#include "transportation_solver.h"
+
+namespace {
+
+// largest side of the problems, the references enumerate up to 6! matchings
+constexpr int kMaxSize = 6;
+
+// threads of the solvers that split their work, more than one so the
+// deterministic merging of the threads is checked as well
+constexpr int kThreads = 3;
+
+// ranges of the generated costs, from many ties to costs needing 64 bits
+const int64_t kCostRanges[][2] = {
+    {0, 3},
+    {-50, 50},
+    {-32768, 32767},
+    {-(int64_t{1} << 20), int64_t{1} << 20},
+    {0, int64_t{1} << 40},
+};
+
+struct Options {
+  int64_t seed = 1;
+
+  // problems per check and instruction set
+  int rounds = 300;
+};
+
+void PrintUsage() {
+  std::printf(
+      "Usage:\n"
+      "\n"
+      "  belegium_matcher_check [OPTIONS]\n"
+      "\n"
+      "Options:\n"
+      "  --help                Show this usage information.\n"
+      "  --seed <number>       Seed of the problem generator (default: 1).\n"
+      "  --rounds <number>     Problems per check and instruction set "
+      "(default: 300).\n");
+}
+
+// Parses |text| as a whole number into |value|.
+bool ParseNumber(const char* text, int64_t* value) {
+  char* end = nullptr;
+  long long parsed = std::strtoll(text, &end, 10);
+  if (end == text || *end != '\0') return false;
+  *value = parsed;
+  return true;
+}
+
+// Parses |text| as a whole number in [|min|, |max|] into |value|.
+bool ParseCount(const char* text, int min, int max, int* value) {
+  int64_t parsed = 0;
+  if (!ParseNumber(text, &parsed) || parsed < min || parsed > max) {
+    return false;
+  }
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+// Matches argv[*i] against the option |name| given as "--name value" or
+// "--name=value". On a match |value| points to the value or is null if it is
+// missing.
+bool MatchOption(int argc,
+                 char** argv,
+                 int* i,
+                 const char* name,
+                 const char** value) {
+  const char* arg = argv[*i];
+  size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) != 0) return false;
+
+  if (arg[length] == '=') {
+    *value = arg + length + 1;
+    return true;
+  }
+
+  if (arg[length] != '\0') return false;
+
+  *value = *i + 1 < argc ? argv[++*i] : nullptr;
+  return true;
+}
+
+// Returns false if the command line is invalid.
+bool ParseOptions(int argc, char** argv, Options* options, bool* help) {
+  for (int i = 1; i < argc; i++) {
+    const char* value = nullptr;
+    bool valid = true;
+
+    if (std::strcmp(argv[i], "--help") == 0) {
+      *help = true;
+    } else if (MatchOption(argc, argv, &i, "--seed", &value)) {
+      valid = value && ParseNumber(value, &options->seed);
+    } else if (MatchOption(argc, argv, &i, "--rounds", &value)) {
+      valid = value && ParseCount(value, 1, 1 << 20, &options->rounds);
+    } else {
+      valid = false;
+    }
+
+    if (!valid) return false;
+  }
+
+  return true;
+}
+
+// Counts the compared results and reports the ones that differ.
+class Checker {
+ public:
+  belegium::SimdLevel level() const { return level_; }
+  void set_level(belegium::SimdLevel level) { level_ = level; }
+
+  // Records the result of |check| for the problem of |round|.
+  void Expect(bool passed, const char* check, int round) {
+    checks_++;
+    if (passed) return;
+
+    failures_++;
+    std::printf("FAILED %s (simd %s, round %d)\n", check,
+                belegium::SimdLevelName(level_), round);
+  }
+
+  int checks() const { return checks_; }
+  int failures() const { return failures_; }
+
+ private:
+  belegium::SimdLevel level_ = belegium::SimdLevel::kScalar;
+  int checks_ = 0;
+  int failures_ = 0;
+};
+
+// Returns a number drawn uniformly from [|low|, |high|].
+int64_t Uniform(int64_t low, int64_t high, std::mt19937_64* random) {
+  return std::uniform_int_distribution<int64_t>(low, high)(*random);
+}
+
+// Returns an m x n matrix of costs drawn from the range of |round|.
+belegium::Matrix RandomCosts(int m,
+                             int n,
+                             int round,
+                             std::mt19937_64* random) {
+  const int64_t* range = kCostRanges[round % 5];
+  belegium::Matrix costs(m, n);
+  for (int64_t& cost : costs.data) cost = Uniform(range[0], range[1], random);
+  return costs;
+}
+
+// Returns the costs of |costs| as |Cost| cells whose rows are n + 1 cells
+// apart, the extra cell of each row must never be read.
+template <typename Cost>
+std::vector<Cost> StridedCopy(const belegium::Matrix& costs) {
+  std::vector<Cost> cells(static_cast<size_t>(costs.m) * (costs.n + 1),
+                          std::numeric_limits<Cost>::min());
+  for (int i = 0; i < costs.m; i++) {
+    std::copy(costs[i], costs[i] + costs.n,
+              cells.begin() + static_cast<size_t>(i) * (costs.n + 1));
+  }
+  return cells;
+}
+
+// Calls |solve|(cells, stride) with |costs| in every integer type holding
+// them, so each instantiation of a solver is checked.
+template <typename Solve>
+void ForEachWidth(const belegium::Matrix& costs, Solve solve) {
+  belegium::CostBounds bounds = belegium::FindCostBounds(
+      costs.data.data(), costs.m, costs.n, costs.n);
+  belegium::CostWidth width = belegium::NarrowestCostWidth(bounds);
+
+  if (width == belegium::CostWidth::kInt16) {
+    solve(StridedCopy<int16_t>(costs).data(), costs.n + 1);
+  }
+  if (width != belegium::CostWidth::kInt64) {
+    solve(StridedCopy<int32_t>(costs).data(), costs.n + 1);
+  }
+  solve(StridedCopy<int64_t>(costs).data(), costs.n + 1);
+}
+
+// Matching of the reference enumeration.
+struct Matching {
+  int assigned = 0;
+  int64_t cost = 0;
+};
+
+// Calls |visit|(matching, row_to_col) for every matching of the rows of
+// |costs| to distinct columns. Rows may stay unassigned (-1) if |partial| is
+// set, pairs whose entry in |allowed| is false are never matched.
+template <typename Visit>
+void ForEachMatching(const belegium::Matrix& costs,
+                     const std::vector<char>* allowed,
+                     bool partial,
+                     Visit visit) {
+  std::vector<int32_t> row_to_col(costs.m, -1);
+  std::vector<char> used(costs.n, 0);
+  Matching matching;
+
+  // iterates over the choices of |row| and the rows below it
+  struct Search {
+    const belegium::Matrix& costs;
+    const std::vector<char>* allowed;
+    bool partial;
+    Visit& visit;
+    std::vector<int32_t>& row_to_col;
+    std::vector<char>& used;
+    Matching& matching;
+
+    void Run(int row) {
+      if (row == costs.m) {
+        visit(matching, row_to_col);
+        return;
+      }
+
+      if (partial) Run(row + 1);
+
+      for (int j = 0; j < costs.n; j++) {
+        if (used[j]) continue;
+        if (allowed && !(*allowed)[static_cast<size_t>(row) * costs.n + j]) {
+          continue;
+        }
+
+        used[j] = 1;
+        row_to_col[row] = j;
+        matching.assigned++;
+        matching.cost += costs[row][j];
+        Run(row + 1);
+        matching.cost -= costs[row][j];
+        matching.assigned--;
+        row_to_col[row] = -1;
+        used[j] = 0;
+      }
+    }
+  };
+
+  Search{costs, allowed, partial, visit, row_to_col, used, matching}.Run(0);
+}
+
+// Returns the cheapest matching assigning min(m, n) pairs of |costs|.
+int64_t ReferenceCost(const belegium::Matrix& costs) {
+  int size = std::min(costs.m, costs.n);
+  int64_t best = std::numeric_limits<int64_t>::max();
+  ForEachMatching(costs, nullptr, costs.m > costs.n,
+                  [&](const Matching& matching, const std::vector<int32_t>&) {
+                    if (matching.assigned == size) {
+                      best = std::min(best, matching.cost);
+                    }
+                  });
+  return best;
+}
+
+// Returns the cheapest assignment of the square |costs| using the pair of
+// |row| and |column|.
+int64_t ReferenceCostWith(const belegium::Matrix& costs, int row, int column) {
+  int64_t best = std::numeric_limits<int64_t>::max();
+  ForEachMatching(costs, nullptr, false,
+                  [&](const Matching& matching,
+                      const std::vector<int32_t>& row_to_col) {
+                    if (row_to_col[row] == column) {
+                      best = std::min(best, matching.cost);
+                    }
+                  });
+  return best;
+}
+
+// Whether |row_to_col| assigns |assigned| rows of |costs| to distinct
+// columns for a total of |cost|.
+bool IsMatching(const belegium::Matrix& costs,
+                const int32_t* row_to_col,
+                int assigned,
+                int64_t cost) {
+  std::vector<char> used(costs.n, 0);
+  int count = 0;
+  int64_t sum = 0;
+  for (int i = 0; i < costs.m; i++) {
+    int j = row_to_col[i];
+    if (j == -1) continue;
+    if (j < 0 || j >= costs.n || used[j]) return false;
+
+    used[j] = 1;
+    count++;
+    sum += costs[i][j];
+  }
+  return count == assigned && sum == cost;
+}
+
+void CheckJonkerVolgenant(int round,
+                          std::mt19937_64* random,
+                          Checker* checker) {
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(n, n, round, random);
+  int64_t expected = ReferenceCost(costs);
+
+  belegium::LapSolver solver;
+  std::vector<int32_t> row_to_col(n);
+  ForEachWidth(costs, [&](const auto* cells, int stride) {
+    int64_t cost = solver.Solve(cells, n, stride, row_to_col.data());
+    checker->Expect(cost == expected &&
+                        IsMatching(costs, row_to_col.data(), n, cost),
+                    "jonker_volgenant", round);
+  });
+}
+
+void CheckRectangular(int round, std::mt19937_64* random, Checker* checker) {
+  int m = static_cast<int>(Uniform(1, kMaxSize, random));
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(m, n, round, random);
+  int64_t expected = ReferenceCost(costs);
+
+  belegium::LapSolver solver;
+  std::vector<int32_t> row_to_col(m);
+  ForEachWidth(costs, [&](const auto* cells, int stride) {
+    int64_t cost =
+        solver.SolveRectangular(cells, m, n, stride, row_to_col.data());
+    checker->Expect(cost == expected && IsMatching(costs, row_to_col.data(),
+                                                   std::min(m, n), cost),
+                    "rectangular", round);
+  });
+}
+
+void CheckAuction(int round, std::mt19937_64* random, Checker* checker) {
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(n, n, round, random);
+  int64_t expected = ReferenceCost(costs);
+
+  belegium::AuctionSolver solver(kThreads);
+  std::vector<int32_t> row_to_col(n);
+  ForEachWidth(costs, [&](const auto* cells, int stride) {
+    int64_t cost = solver.Solve(cells, n, stride, row_to_col.data());
+    checker->Expect(cost == expected &&
+                        IsMatching(costs, row_to_col.data(), n, cost),
+                    "auction", round);
+  });
+}
+
+void CheckComponents(int round, std::mt19937_64* random, Checker* checker) {
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(n, n, round, random);
+
+  // cells of the largest cost, like vetoes and padding, split the problem
+  int64_t largest = *std::max_element(costs.data.begin(), costs.data.end());
+  for (int64_t& cost : costs.data) {
+    if (Uniform(0, 2, random) != 0) cost = largest;
+  }
+  int64_t expected = ReferenceCost(costs);
+
+  belegium::ComponentSolver solver(kThreads);
+  std::vector<int32_t> row_to_col(n);
+  ForEachWidth(costs, [&](const auto* cells, int stride) {
+    int64_t cost = solver.Solve(cells, n, stride, row_to_col.data());
+    checker->Expect(cost == expected &&
+                        IsMatching(costs, row_to_col.data(), n, cost),
+                    "components", round);
+  });
+}
+
+void CheckIncremental(int round, std::mt19937_64* random, Checker* checker) {
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  const int64_t* range = kCostRanges[round % 5];
+
+  // the problems are solved one after another: random costs, a few changed
+  // cells and all costs changed by the same amount
+  belegium::Matrix problems = RandomCosts(3 * n, n, round, random);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) problems[n + i][j] = problems[i][j];
+  }
+  for (int k = static_cast<int>(Uniform(1, 3, random)); k > 0; k--) {
+    problems[n + Uniform(0, n - 1, random)][Uniform(0, n - 1, random)] =
+        Uniform(range[0], range[1], random);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) problems[2 * n + i][j] = problems[n + i][j] + 1;
+  }
+
+  ForEachWidth(problems, [&](const auto* cells, int stride) {
+    belegium::IncrementalSolver solver;
+    std::vector<int32_t> row_to_col(n);
+    for (int p = 0; p < 3; p++) {
+      belegium::Matrix problem(n, n);
+      for (int i = 0; i < n; i++) {
+        std::copy(problems[p * n + i], problems[p * n + i] + n, problem[i]);
+      }
+
+      int64_t cost =
+          solver.Solve(cells + static_cast<size_t>(p) * n * stride, n, stride,
+                       row_to_col.data());
+      checker->Expect(cost == ReferenceCost(problem) &&
+                          IsMatching(problem, row_to_col.data(), n, cost),
+                      "incremental", round);
+    }
+  });
+}
+
+void CheckKBest(int round, std::mt19937_64* random, Checker* checker) {
+  int n = static_cast<int>(Uniform(1, 5, random));
+  int k = static_cast<int>(Uniform(1, 8, random));
+  int64_t max_gap = Uniform(0, 1, random) ? -1 : Uniform(0, 3, random);
+  belegium::Matrix costs = RandomCosts(n, n, round, random);
+
+  std::vector<int64_t> expected;
+  ForEachMatching(costs, nullptr, false,
+                  [&](const Matching& matching, const std::vector<int32_t>&) {
+                    expected.push_back(matching.cost);
+                  });
+  std::sort(expected.begin(), expected.end());
+  if (max_gap >= 0) {
+    expected.erase(std::upper_bound(expected.begin(), expected.end(),
+                                    expected.front() + max_gap),
+                   expected.end());
+  }
+  if (static_cast<int>(expected.size()) > k) expected.resize(k);
+
+  belegium::KBestSolver solver(kThreads);
+  ForEachWidth(costs, [&](const auto* cells, int stride) {
+    std::vector<belegium::RankedAssignment> results;
+    solver.Solve(cells, n, stride, k, max_gap, &results);
+
+    bool passed = results.size() == expected.size();
+    std::set<std::vector<int32_t>> distinct;
+    for (size_t r = 0; passed && r < results.size(); r++) {
+      passed = results[r].cost == expected[r] &&
+               IsMatching(costs, results[r].row_to_col.data(), n,
+                          results[r].cost) &&
+               distinct.insert(results[r].row_to_col).second;
+    }
+    checker->Expect(passed, "k_best", round);
+  });
+}
+
+void CheckSensitivity(int round, std::mt19937_64* random, Checker* checker) {
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(n, n, round, random);
+  int64_t optimum = ReferenceCost(costs);
+
+  belegium::LapSolver solver;
+  std::vector<int32_t> row_to_col(n);
+  solver.Solve(costs.data.data(), n, n, row_to_col.data());
+
+  // the margin of a free cell is the rise of the optimum when it is forced
+  // into the assignment, the margin of an assigned cell is the smallest
+  // margin of the other cells of its row
+  std::vector<int64_t> expected(static_cast<size_t>(n) * n);
+  for (int i = 0; i < n; i++) {
+    int64_t smallest = belegium::SensitivityAnalysis::kUnbounded;
+    for (int j = 0; j < n; j++) {
+      if (j == row_to_col[i]) continue;
+      int64_t margin = ReferenceCostWith(costs, i, j) - optimum;
+      expected[static_cast<size_t>(i) * n + j] = margin;
+      if (smallest < 0 || margin < smallest) smallest = margin;
+    }
+    expected[static_cast<size_t>(i) * n + row_to_col[i]] = smallest;
+  }
+
+  belegium::SensitivityAnalysis analysis(kThreads);
+  std::vector<int64_t> margins(static_cast<size_t>(n) * n);
+  bool analyzed = analysis.Analyze(
+      costs.data.data(), n, n, row_to_col.data(),
+      solver.row_potentials().data(), solver.column_potentials().data(),
+      margins.data());
+  checker->Expect(analyzed && margins == expected, "sensitivity", round);
+
+  // the 32 bit instantiation, if the costs fit
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs.data.data(), n, n, n);
+  if (belegium::NarrowestCostWidth(bounds) != belegium::CostWidth::kInt64) {
+    std::vector<int32_t> cells = StridedCopy<int32_t>(costs);
+    std::fill(margins.begin(), margins.end(), 0);
+    analyzed = analysis.Analyze(
+        cells.data(), n, n + 1, row_to_col.data(),
+        solver.row_potentials().data(), solver.column_potentials().data(),
+        margins.data());
+    checker->Expect(analyzed && margins == expected, "sensitivity", round);
+  }
+}
+
+void CheckSparse(int round, std::mt19937_64* random, Checker* checker) {
+  int m = static_cast<int>(Uniform(1, kMaxSize, random));
+  int n = static_cast<int>(Uniform(1, kMaxSize, random));
+  belegium::Matrix costs = RandomCosts(m, n, round, random);
+
+  // forbid up to about half of the pairs, some rows cannot be assigned
+  int64_t forbidden = Uniform(0, 5, random);
+  std::vector<char> allowed(static_cast<size_t>(m) * n);
+  belegium::SparseProblem problem;
+  problem.m = m;
+  problem.n = n;
+  problem.row_offsets.push_back(0);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      allowed[static_cast<size_t>(i) * n + j] =
+          Uniform(0, 9, random) >= forbidden;
+      if (!allowed[static_cast<size_t>(i) * n + j]) continue;
+
+      problem.columns.push_back(j);
+      problem.costs.push_back(costs[i][j]);
+    }
+    problem.row_offsets.push_back(static_cast<int32_t>(problem.columns.size()));
+  }
+
+  // as many rows as possible are assigned, then the costs are minimal
+  Matching expected;
+  expected.cost = std::numeric_limits<int64_t>::max();
+  ForEachMatching(costs, &allowed, true,
+                  [&](const Matching& matching, const std::vector<int32_t>&) {
+                    if (matching.assigned > expected.assigned ||
+                        (matching.assigned == expected.assigned &&
+                         matching.cost < expected.cost)) {
+                      expected = matching;
+                    }
+                  });
+
+  belegium::SparseLapSolver solver;
+  std::vector<int32_t> row_to_col(m);
+  int64_t cost = solver.Solve(problem, row_to_col.data());
+
+  bool passed = cost == expected.cost &&
+                IsMatching(costs, row_to_col.data(), expected.assigned, cost) &&
+                static_cast<int>(solver.unassigned_rows().size()) ==
+                    m - expected.assigned;
+  for (int i = 0; passed && i < m; i++) {
+    int j = row_to_col[i];
+    passed = j == -1 || allowed[static_cast<size_t>(i) * n + j];
+  }
+  checker->Expect(passed, "sparse", round);
+}
+
+void CheckTransportation(int round,
+                         std::mt19937_64* random,
+                         Checker* checker) {
+  int m = static_cast<int>(Uniform(1, 3, random));
+  int n = static_cast<int>(Uniform(1, 3, random));
+  belegium::Matrix costs = RandomCosts(m, n, round, random);
+
+  std::vector<int32_t> row_capacities(m);
+  std::vector<int32_t> column_capacities(n);
+  std::vector<int> unit_rows;
+  std::vector<int> unit_columns;
+  for (int i = 0; i < m; i++) {
+    row_capacities[i] = static_cast<int32_t>(Uniform(0, 2, random));
+    unit_rows.insert(unit_rows.end(), row_capacities[i], i);
+  }
+  for (int j = 0; j < n; j++) {
+    column_capacities[j] = static_cast<int32_t>(Uniform(0, 2, random));
+    unit_columns.insert(unit_columns.end(), column_capacities[j], j);
+  }
+
+  // the reference matches the copies of the rows and columns, one per unit
+  int units = static_cast<int>(std::min(unit_rows.size(), unit_columns.size()));
+  int64_t expected = 0;
+  if (units > 0) {
+    belegium::Matrix copies(static_cast<int>(unit_rows.size()),
+                            static_cast<int>(unit_columns.size()));
+    for (int a = 0; a < copies.m; a++) {
+      for (int b = 0; b < copies.n; b++) {
+        copies[a][b] = costs[unit_rows[a]][unit_columns[b]];
+      }
+    }
+    expected = ReferenceCost(copies);
+  }
+
+  belegium::TransportationSolver solver;
+  std::vector<int32_t> rows;
+  std::vector<int32_t> columns;
+  int64_t cost = solver.Solve(costs.data.data(), m, n, row_capacities.data(),
+                              column_capacities.data(), &rows, &columns);
+
+  bool passed = cost == expected && static_cast<int>(rows.size()) == units &&
+                rows.size() == columns.size();
+  int64_t sum = 0;
+  for (size_t k = 0; passed && k < rows.size(); k++) {
+    passed = rows[k] >= 0 && rows[k] < m && columns[k] >= 0 &&
+             columns[k] < n && --row_capacities[rows[k]] >= 0 &&
+             --column_capacities[columns[k]] >= 0;
+    if (passed) sum += costs[rows[k]][columns[k]];
+  }
+  checker->Expect(passed && sum == cost, "transportation", round);
+}
+
+// Compares the kernels of the selected level with the scalar ones.
+void CheckKernels(int round, std::mt19937_64* random, Checker* checker) {
+  const belegium::SimdKernels& kernels = belegium::Kernels();
+  const belegium::SimdKernels& scalar = *belegium::ScalarKernels();
+
+  // long enough for the vector loops and their remainders
+  int n = static_cast<int>(Uniform(1, 40, random));
+  belegium::Matrix row = RandomCosts(1, n, round, random);
+  std::vector<int64_t> v(n);
+  std::vector<char> visited(n);
+  for (int j = 0; j < n; j++) {
+    v[j] = Uniform(-50, 50, random);
+    visited[j] = Uniform(0, 3, random) == 0;
+  }
+  int64_t u = Uniform(-50, 50, random);
+
+  // the scalar results are computed with the scalar kernels selected
+  ForEachWidth(row, [&](const auto* cells, int) {
+    std::vector<int64_t> minima(n, 10);
+    std::vector<int32_t> min_rows(n, -1);
+    std::vector<int64_t> scalar_minima = minima;
+    std::vector<int32_t> scalar_min_rows = min_rows;
+    belegium::ColumnMinima(cells, n, 7, minima.data(), min_rows.data());
+    belegium::SelectSimdLevel(belegium::SimdLevel::kScalar);
+    belegium::ColumnMinima(cells, n, 7, scalar_minima.data(),
+                           scalar_min_rows.data());
+    belegium::SelectSimdLevel(checker->level());
+    checker->Expect(minima == scalar_minima && min_rows == scalar_min_rows,
+                    "kernel column_minima", round);
+  });
+
+  ForEachWidth(row, [&](const auto* cells, int) {
+    std::vector<int64_t> slack(n, std::numeric_limits<int64_t>::max() / 4);
+    std::vector<int32_t> predecessor(n, -1);
+    std::vector<int64_t> scalar_slack = slack;
+    std::vector<int32_t> scalar_predecessor = predecessor;
+    int32_t column = -1;
+    int32_t scalar_column = -1;
+    int64_t smallest =
+        belegium::RelaxRow(cells, n, u, v.data(), visited.data(), 3,
+                           slack.data(), predecessor.data(), &column);
+    belegium::SelectSimdLevel(belegium::SimdLevel::kScalar);
+    int64_t scalar_smallest = belegium::RelaxRow(
+        cells, n, u, v.data(), visited.data(), 3, scalar_slack.data(),
+        scalar_predecessor.data(), &scalar_column);
+    belegium::SelectSimdLevel(checker->level());
+    checker->Expect(smallest == scalar_smallest && column == scalar_column &&
+                        slack == scalar_slack &&
+                        predecessor == scalar_predecessor,
+                    "kernel relax_row", round);
+  });
+
+  std::vector<int64_t> values = row.data;
+  std::vector<int64_t> scalar_values = row.data;
+  kernels.subtract(values.data(), n, u);
+  scalar.subtract(scalar_values.data(), n, u);
+  checker->Expect(values == scalar_values, "kernel subtract", round);
+}
+
+// Compares the combined problems of the built-in strategies and of score
+// expressions with the scores of single pairs.
+void CheckCombine(int round, std::mt19937_64* random, Checker* checker) {
+  int m = static_cast<int>(Uniform(1, 20, random));
+  int n = static_cast<int>(Uniform(1, 40, random));
+  belegium::Matrix a(m, n);
+  belegium::Matrix b(n, m);
+  for (int64_t& rating : a.data) rating = Uniform(-100, 25, random);
+  for (int64_t& rating : b.data) rating = Uniform(-100, 25, random);
+
+  for (int k = 0; k < belegium::kCombinationCount; k++) {
+    belegium::Combination combination = belegium::CombinationAt(k);
+    belegium::Matrix problem = belegium::CombineProblem(a, b, combination);
+
+    bool passed = true;
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        passed = passed && problem[i][j] == belegium::Combine(combination,
+                                                              a[i][j], b[j][i]);
+      }
+    }
+    checker->Expect(passed, "combine", round);
+  }
+
+  // expressions with their evaluation in double precision, the score is
+  // truncated towards zero and a division by zero gives 0
+  struct Expression {
+    const char* text;
+    double (*score)(double a, double b);
+  };
+  const Expression expressions[] = {
+      {"a * b - abs(a - b) / 3",
+       [](double a, double b) { return a * b - std::fabs(a - b) / 3; }},
+      {"min(a, b) * 2 + max(a, b)",
+       [](double a, double b) {
+         return std::min(a, b) * 2 + std::max(a, b);
+       }},
+      {"sign(a - b) * (a + b) / 2",
+       [](double a, double b) {
+         return ((a > b) - (a < b)) * (a + b) / 2;
+       }},
+      {"(a + 1) / b - 7 / 3",
+       [](double a, double b) { return (b == 0 ? 0 : (a + 1) / b) - 7.0 / 3; }},
+  };
+
+  for (const Expression& expression : expressions) {
+    belegium::ScoreExpression score;
+    std::string error;
+    if (!belegium::ScoreExpression::Parse(expression.text, &score, &error)) {
+      checker->Expect(false, "score expression", round);
+      continue;
+    }
+
+    belegium::Matrix problem = belegium::CombineProblem(a, b, score);
+    bool passed = true;
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        double value = expression.score(static_cast<double>(a[i][j]),
+                                        static_cast<double>(b[j][i]));
+        passed = passed && problem[i][j] == static_cast<int64_t>(value);
+      }
+    }
+    checker->Expect(passed, "score expression", round);
+  }
+}
+
+// Removes the files of |directory| and the directory itself.
+void RemoveDirectory(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) return;
+
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') continue;
+    unlink((directory + "/" + entry->d_name).c_str());
+  }
+  closedir(dir);
+  rmdir(directory.c_str());
+}
+
+// Writes a file with unsorted names and random ratings into |directory| and
+// compares the tables of the loader and of both paths of the input cache
+// with the generated ones.
+void CheckInputFiles(int round,
+                     const std::string& directory,
+                     std::mt19937_64* random,
+                     Checker* checker) {
+  int persons = static_cast<int>(Uniform(1, kMaxSize, random));
+  int wgs = static_cast<int>(Uniform(1, kMaxSize, random));
+
+  // the names are shuffled, the loaded tables are sorted by name
+  std::vector<std::string> person_names;
+  std::vector<std::string> wg_names;
+  for (int i = 0; i < persons; i++) {
+    person_names.push_back("person " + std::to_string(i));
+  }
+  for (int j = 0; j < wgs; j++) wg_names.push_back("wg " + std::to_string(j));
+  std::shuffle(person_names.begin(), person_names.end(), *random);
+  std::shuffle(wg_names.begin(), wg_names.end(), *random);
+
+  belegium::InputTables expected;
+  expected.persons = person_names;
+  expected.wgs = wg_names;
+  std::sort(expected.persons.begin(), expected.persons.end());
+  std::sort(expected.wgs.begin(), expected.wgs.end());
+  expected.a = belegium::Matrix(persons, wgs);
+  expected.b = belegium::Matrix(wgs, persons);
+  for (int64_t& rating : expected.a.data) rating = Uniform(0, 15, random);
+  for (int64_t& rating : expected.b.data) rating = Uniform(0, 15, random);
+
+  auto index = [](const std::vector<std::string>& sorted,
+                  const std::string& name) {
+    return static_cast<int>(
+        std::lower_bound(sorted.begin(), sorted.end(), name) - sorted.begin());
+  };
+
+  std::string path = directory + "/input.csv";
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    checker->Expect(false, "input file", round);
+    return;
+  }
+
+  for (const std::string& wg : wg_names) std::fprintf(file, ";%s", wg.c_str());
+  std::fprintf(file, "\n");
+  for (const std::string& person : person_names) {
+    std::fprintf(file, "%s", person.c_str());
+    for (const std::string& wg : wg_names) {
+      std::fprintf(file, ";%lld",
+                   static_cast<long long>(
+                       expected.a[index(expected.persons, person)]
+                                 [index(expected.wgs, wg)]));
+    }
+    std::fprintf(file, "\n");
+  }
+  std::fprintf(file, ";\n");
+  for (const std::string& person : person_names) {
+    std::fprintf(file, ";%s", person.c_str());
+  }
+  std::fprintf(file, "\n");
+  for (const std::string& wg : wg_names) {
+    std::fprintf(file, "%s", wg.c_str());
+    for (const std::string& person : person_names) {
+      std::fprintf(file, ";%lld",
+                   static_cast<long long>(
+                       expected.b[index(expected.wgs, wg)]
+                                 [index(expected.persons, person)]));
+    }
+    std::fprintf(file, "\n");
+  }
+  std::fclose(file);
+
+  auto equal = [&](const belegium::InputTables& tables) {
+    return tables.persons == expected.persons && tables.wgs == expected.wgs &&
+           tables.a.m == persons && tables.a.n == wgs &&
+           tables.a.data == expected.a.data && tables.b.m == wgs &&
+           tables.b.n == persons && tables.b.data == expected.b.data;
+  };
+
+  belegium::InputTables tables;
+  belegium::InputError error;
+  checker->Expect(belegium::LoadInputFile(path, &tables, &error) &&
+                      equal(tables),
+                  "input file", round);
+
+  // the first load writes the cache, the second one reads it
+  std::string cache_directory = directory + "/cache";
+  for (bool hit : {false, true}) {
+    belegium::InputTables cached;
+    bool cache_hit = !hit;
+    checker->Expect(belegium::LoadInputFileCached(path, cache_directory,
+                                                  &cached, &error,
+                                                  &cache_hit) &&
+                        cache_hit == hit && equal(cached),
+                    "input cache", round);
+  }
+
+  RemoveDirectory(cache_directory);
+  unlink(path.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  bool help = false;
+  if (!ParseOptions(argc, argv, &options, &help)) {
+    PrintUsage();
+    return 1;
+  }
+  if (help) {
+    PrintUsage();
+    return 0;
+  }
+
+  Checker checker;
+  std::mt19937_64 random(static_cast<uint64_t>(options.seed));
+
+  // every solver runs on the kernels of each supported level
+  belegium::SimdLevel supported = belegium::SupportedSimdLevel();
+  for (belegium::SimdLevel level :
+       {belegium::SimdLevel::kScalar, belegium::SimdLevel::kSse4,
+        belegium::SimdLevel::kAvx2}) {
+    if (level > supported) break;
+    belegium::SelectSimdLevel(level);
+    checker.set_level(level);
+
+    for (int round = 0; round < options.rounds; round++) {
+      CheckJonkerVolgenant(round, &random, &checker);
+      CheckRectangular(round, &random, &checker);
+      CheckAuction(round, &random, &checker);
+      CheckComponents(round, &random, &checker);
+      CheckIncremental(round, &random, &checker);
+      CheckKBest(round, &random, &checker);
+      CheckSensitivity(round, &random, &checker);
+      CheckSparse(round, &random, &checker);
+      CheckTransportation(round, &random, &checker);
+      CheckCombine(round, &random, &checker);
+      if (level != belegium::SimdLevel::kScalar) {
+        CheckKernels(round, &random, &checker);
+      }
+    }
+  }
+  belegium::SelectSimdLevel(supported);
+
+  // the loaders do not depend on the kernels
+  const char* temporary = std::getenv("TMPDIR");
+  std::string directory =
+      std::string(temporary ? temporary : "/tmp") + "/belegium_check_XXXXXX";
+  if (mkdtemp(&directory[0]) == nullptr) {
+    std::fprintf(stderr, "error: Could not create %s\n", directory.c_str());
+    return 1;
+  }
+  for (int round = 0; round < options.rounds; round++) {
+    CheckInputFiles(round, directory, &random, &checker);
+  }
+  RemoveDirectory(directory);
+
+  std::printf("%d checks, %d failed\n", checker.checks(), checker.failures());
+  return checker.failures() == 0 ? 0 : 1;
+}
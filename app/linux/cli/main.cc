@@ -0,0 +1,678 @@
+// Headless command line version of the matcher. It runs the same pipeline as
+// `belegium_matcher --ff` but without GTK or the Flutter engine. Several files
+// or directories of files are matched in one process and can be summarized
+// in a single json or csv report.
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "component_solver.h"
+#include "cost_width.h"
+#include "input_cache.h"
+#include "input_file.h"
+#include "k_best_solver.h"
+#include "matching.h"
+#include "score_expression.h"
+#include "sparse_lap_solver.h"
+#include "thread_pool.h"
+
+namespace {
+
+// shown instead of the matches of a problem whose costs could overflow
+constexpr char kTooLargeMessage[] = "not solved, the scores are too large";
+
+void PrintUsage() {
+  std::printf(
+      "Usage:\n"
+      "\n"
+      "  belegium_matcher_cli [OPTIONS] FILE...\n"
+      "\n"
+      "Options:\n"
+      "  --help                Show this usage information.\n"
+      "  --extra <number>      Specify an optional number of extra points for "
+      "direct match (default: 10).\n"
+      "  --matrix              Print the matrices of each problem.\n"
+      "  --jobs <number>       Number of problems solved concurrently "
+      "(default: one per hardware thread).\n"
+      "  --sparse              Never match vetoes, report persons that cannot "
+      "be matched otherwise.\n"
+      "  --score <expression>  Also solve the problem scored by this "
+      "expression of the ratings a\n"
+      "                        and b, e.g. \"a * b - abs(a - b) / 3\". May be "
+      "repeated.\n"
+      "  --k-best <number>     List the next best matchings of each problem "
+      "up to this many in\n"
+      "                        total (default: 1).\n"
+      "  --max-gap <number>    Only list matchings costing at most this much "
+      "more than the best one,\n"
+      "                        0 lists the matchings tied with the best "
+      "one.\n"
+      "  --report <file>       Write the matches of all files to this report, "
+      "as csv if it ends\n"
+      "                        with .csv and as json otherwise.\n"
+      "  --no-cache            Parse every file instead of reading unchanged "
+      "files from the cache\n"
+      "                        of parsed inputs.\n"
+      "  --ff                  Accepted for compatibility, the command line "
+      "tool always runs in fast mode.\n"
+      "\n"
+      "Arguments:\n"
+      "  FILE                  The file to be used with the program. Several "
+      "files may be given,\n"
+      "                        directories are replaced by the csv files they "
+      "contain.\n");
+}
+
+void PrintMatrix(const char* name, const belegium::Matrix& matrix) {
+  std::printf("%s =\n", name);
+  for (int i = 0; i < matrix.m; i++) {
+    for (int j = 0; j < matrix.n; j++) {
+      std::printf("\t%lld", static_cast<long long>(matrix[i][j]));
+    }
+    std::printf("\n");
+  }
+}
+
+// Returns the message of a failed load including its position.
+std::string ErrorMessage(const belegium::InputError& error) {
+  std::string message = error.message;
+  if (error.has_position) {
+    const belegium::TablePosition& position = error.position;
+    message += " (row " +
+               (position.row >= 0 ? std::to_string(position.row) : "-");
+    if (position.row_offset >= 0) {
+      message += " +" + std::to_string(position.row_offset);
+    }
+    if (position.column >= 0) {
+      message += ", column " + std::to_string(position.column);
+    }
+    message += ")";
+  }
+  return message;
+}
+
+void PrintError(const belegium::InputError& error) {
+  std::fprintf(stderr, "error: %s\n", ErrorMessage(error).c_str());
+}
+
+// Solver buffers of one worker, they are reused for every problem the worker
+// solves.
+struct Workspace {
+  belegium::ComponentSolver solver;
+  belegium::SparseLapSolver sparse_solver;
+  belegium::KBestSolver k_best_solver;
+};
+
+// Result of one scoring expression.
+struct Solution {
+  // position of the expression, starting with the built-in combinations
+  int index = 0;
+  const belegium::ScoreExpression* score = nullptr;
+  belegium::Matrix problem;
+  std::vector<int32_t> row_to_col;
+  int64_t costs = 0;
+
+  // whether the costs are too large to be solved without overflow, nobody is
+  // matched then
+  bool too_large = false;
+
+  // persons that cannot be matched without a veto
+  std::vector<int32_t> unassigned;
+
+  // next best matchings ordered by costs, see --k-best
+  std::vector<belegium::RankedAssignment> alternatives;
+};
+
+// One input file and the solutions of all its problems.
+struct Cohort {
+  std::string path;
+
+  bool loaded = false;
+  belegium::InputError error;
+  belegium::InputTables tables;
+
+  // processed and possibly padded matrices the problems are built from
+  belegium::Matrix a;
+  belegium::Matrix b;
+
+  // solutions by expression, |remaining| counts the unsolved ones
+  std::vector<Solution> solutions;
+  int remaining = 0;
+};
+
+// Builds and solves the problem of |score| for the square matrices with the
+// buffers of |workspace|. If |sparse| is set the matrices may be rectangular
+// and vetoes are never matched. Otherwise up to |k_best| matchings costing at
+// most |max_gap| more than the best one are found, if it is not negative.
+Solution Solve(const belegium::Matrix& a,
+               const belegium::Matrix& b,
+               int index,
+               const belegium::ScoreExpression& score,
+               bool sparse,
+               int k_best,
+               int64_t max_gap,
+               Workspace* workspace) {
+  Solution solution;
+  solution.index = index;
+  solution.score = &score;
+  solution.problem = belegium::CombineProblem(a, b, score);
+  solution.row_to_col.assign(solution.problem.m, -1);
+
+  // the costs of the square problem are built in the narrowest integer type
+  // holding them
+  belegium::CostMatrix inverse = belegium::InvertProblemCosts(solution.problem);
+  if (!belegium::CostsFitSolvers(inverse.bounds(),
+                                 std::max(inverse.m(), inverse.n()))) {
+    solution.too_large = true;
+    return solution;
+  }
+
+  if (sparse) {
+    belegium::SparseLapSolver& solver = workspace->sparse_solver;
+    solution.costs = solver.Solve(
+        belegium::AllowedPairs(belegium::InvertProblem(solution.problem), a),
+        solution.row_to_col.data());
+    solution.unassigned = solver.unassigned_rows();
+    return solution;
+  }
+
+  if (k_best > 1) {
+    std::vector<belegium::RankedAssignment>& ranked = solution.alternatives;
+    inverse.Solve([&](const auto* costs, int stride) {
+      workspace->k_best_solver.Solve(costs, inverse.n(), stride, k_best,
+                                     max_gap, &ranked);
+    });
+    solution.row_to_col = std::move(ranked.front().row_to_col);
+    solution.costs = ranked.front().cost;
+    ranked.erase(ranked.begin());
+    return solution;
+  }
+
+  // cells of the largest cost, e.g. vetoes and padding, often split the
+  // problem into independent ones. The workers already solve several problems
+  // at once, so the components of one are solved on its worker
+  solution.costs = inverse.Solve([&](const auto* costs, int stride) {
+    return workspace->solver.Solve(costs, inverse.n(), stride,
+                                   solution.row_to_col.data());
+  });
+
+  return solution;
+}
+
+void PrintSolution(const Solution& solution,
+                   const belegium::InputTables& tables,
+                   bool show_matrices) {
+  if (solution.too_large) {
+    std::printf("%d) %s: %s\n", solution.index + 1,
+                solution.score->text().c_str(), kTooLargeMessage);
+    return;
+  }
+
+  std::printf("%d) %s: %lld\n", solution.index + 1,
+              solution.score->text().c_str(),
+              static_cast<long long>(solution.costs));
+
+  if (show_matrices) {
+    PrintMatrix("M", solution.problem);
+    PrintMatrix("W", belegium::InvertProblem(solution.problem));
+  }
+
+  // skip pseudo matches against padding rows and columns
+  for (int i = 0; i < static_cast<int>(tables.persons.size()); i++) {
+    int j = solution.row_to_col[i];
+    if (j < 0 || j >= static_cast<int>(tables.wgs.size())) continue;
+
+    std::printf("  %s <-> %s (%lld/%lld)\n", tables.persons[i].c_str(),
+                tables.wgs[j].c_str(), static_cast<long long>(tables.a[i][j]),
+                static_cast<long long>(tables.b[j][i]));
+  }
+
+  if (!solution.unassigned.empty()) {
+    std::printf("  infeasible, no match without veto for:");
+    for (int32_t i : solution.unassigned) {
+      std::printf(" %s", tables.persons[i].c_str());
+    }
+    std::printf("\n");
+  }
+
+  // alternatives only list the matches that differ from the best matching
+  for (size_t k = 0; k < solution.alternatives.size(); k++) {
+    const belegium::RankedAssignment& alternative = solution.alternatives[k];
+    std::printf("  %zu. best: %lld (+%lld)\n", k + 2,
+                static_cast<long long>(alternative.cost),
+                static_cast<long long>(alternative.cost - solution.costs));
+
+    for (int i = 0; i < static_cast<int>(tables.persons.size()); i++) {
+      int j = alternative.row_to_col[i];
+      if (j == solution.row_to_col[i]) continue;
+
+      // a padding column leaves the person without a match
+      if (j >= static_cast<int>(tables.wgs.size())) {
+        std::printf("    %s <-> -\n", tables.persons[i].c_str());
+        continue;
+      }
+
+      std::printf("    %s <-> %s (%lld/%lld)\n", tables.persons[i].c_str(),
+                  tables.wgs[j].c_str(),
+                  static_cast<long long>(tables.a[i][j]),
+                  static_cast<long long>(tables.b[j][i]));
+    }
+  }
+}
+
+// Prints all solutions of |cohort| and releases their matrices, only the
+// matches are kept for the report.
+void PrintCohort(Cohort* cohort, bool show_header, bool show_matrices) {
+  if (show_header) std::printf("== %s ==\n", cohort->path.c_str());
+
+  if (show_matrices) {
+    PrintMatrix("A", cohort->tables.a);
+    PrintMatrix("B", cohort->tables.b);
+    std::printf("\n");
+  }
+
+  for (Solution& solution : cohort->solutions) {
+    PrintSolution(solution, cohort->tables, show_matrices);
+    solution.problem = belegium::Matrix();
+  }
+
+  cohort->a = belegium::Matrix();
+  cohort->b = belegium::Matrix();
+}
+
+// Returns |text| as a quoted json string.
+std::string JsonString(const std::string& text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+// Returns |text| as a csv field, quoted if needed.
+std::string CsvField(const std::string& text) {
+  if (text.find_first_of(",\"\r\n") == std::string::npos) return text;
+
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+void WriteJsonReport(FILE* out, const std::vector<Cohort>& cohorts) {
+  std::fprintf(out, "{\n  \"files\": [");
+  for (size_t f = 0; f < cohorts.size(); f++) {
+    const Cohort& cohort = cohorts[f];
+    std::fprintf(out, "%s\n    {\"file\": %s, ", f > 0 ? "," : "",
+                 JsonString(cohort.path).c_str());
+
+    if (!cohort.loaded) {
+      std::fprintf(out, "\"error\": %s}",
+                   JsonString(ErrorMessage(cohort.error)).c_str());
+      continue;
+    }
+
+    const belegium::InputTables& tables = cohort.tables;
+    std::fprintf(out, "\"solutions\": [");
+    for (size_t k = 0; k < cohort.solutions.size(); k++) {
+      const Solution& solution = cohort.solutions[k];
+      if (solution.too_large) {
+        std::fprintf(out, "%s\n      {\"score\": %s, \"error\": %s}",
+                     k > 0 ? "," : "",
+                     JsonString(solution.score->text()).c_str(),
+                     JsonString(kTooLargeMessage).c_str());
+        continue;
+      }
+
+      std::fprintf(out,
+                   "%s\n      {\"score\": %s, \"costs\": %lld, "
+                   "\"feasible\": %s, \"matches\": [",
+                   k > 0 ? "," : "",
+                   JsonString(solution.score->text()).c_str(),
+                   static_cast<long long>(solution.costs),
+                   solution.unassigned.empty() ? "true" : "false");
+
+      bool first = true;
+      for (int i = 0; i < static_cast<int>(tables.persons.size()); i++) {
+        int j = solution.row_to_col[i];
+        if (j < 0 || j >= static_cast<int>(tables.wgs.size())) continue;
+
+        std::fprintf(out,
+                     "%s\n        {\"person\": %s, \"wg\": %s, \"a\": %lld, "
+                     "\"b\": %lld}",
+                     first ? "" : ",", JsonString(tables.persons[i]).c_str(),
+                     JsonString(tables.wgs[j]).c_str(),
+                     static_cast<long long>(tables.a[i][j]),
+                     static_cast<long long>(tables.b[j][i]));
+        first = false;
+      }
+
+      std::fprintf(out, "\n      ], \"unassigned\": [");
+      for (size_t u = 0; u < solution.unassigned.size(); u++) {
+        std::fprintf(
+            out, "%s%s", u > 0 ? ", " : "",
+            JsonString(tables.persons[solution.unassigned[u]]).c_str());
+      }
+      std::fprintf(out, "]}");
+    }
+    std::fprintf(out, "\n    ]}");
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+}
+
+// Writes one row per match, unassigned persons have no wg and files that
+// failed to load only an error.
+void WriteCsvReport(FILE* out, const std::vector<Cohort>& cohorts) {
+  std::fprintf(out, "file,score,costs,person,wg,a,b,error\n");
+  for (const Cohort& cohort : cohorts) {
+    std::string file = CsvField(cohort.path);
+    if (!cohort.loaded) {
+      std::fprintf(out, "%s,,,,,,,%s\n", file.c_str(),
+                   CsvField(ErrorMessage(cohort.error)).c_str());
+      continue;
+    }
+
+    const belegium::InputTables& tables = cohort.tables;
+    for (const Solution& solution : cohort.solutions) {
+      std::string score = CsvField(solution.score->text());
+      long long costs = static_cast<long long>(solution.costs);
+      if (solution.too_large) {
+        std::fprintf(out, "%s,%s,,,,,,%s\n", file.c_str(), score.c_str(),
+                     CsvField(kTooLargeMessage).c_str());
+        continue;
+      }
+
+      for (int i = 0; i < static_cast<int>(tables.persons.size()); i++) {
+        int j = solution.row_to_col[i];
+        if (j < 0 || j >= static_cast<int>(tables.wgs.size())) continue;
+
+        std::fprintf(out, "%s,%s,%lld,%s,%s,%lld,%lld,\n", file.c_str(),
+                     score.c_str(), costs,
+                     CsvField(tables.persons[i]).c_str(),
+                     CsvField(tables.wgs[j]).c_str(),
+                     static_cast<long long>(tables.a[i][j]),
+                     static_cast<long long>(tables.b[j][i]));
+      }
+
+      for (int32_t i : solution.unassigned) {
+        std::fprintf(out, "%s,%s,%lld,%s,,,,\n", file.c_str(), score.c_str(),
+                     costs, CsvField(tables.persons[i]).c_str());
+      }
+    }
+  }
+}
+
+// Appends |path| to |files|, or the csv files in it sorted by name if it is
+// a directory. Returns false if it cannot be read.
+bool CollectFiles(const std::string& path, std::vector<std::string>* files) {
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) {
+    // missing files are reported when they are loaded
+    files->push_back(path);
+    return true;
+  }
+
+  DIR* directory = opendir(path.c_str());
+  if (directory == nullptr) return false;
+
+  std::vector<std::string> found;
+  while (dirent* entry = readdir(directory)) {
+    std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) {
+      found.push_back(path + "/" + name);
+    }
+  }
+  closedir(directory);
+
+  std::sort(found.begin(), found.end());
+  files->insert(files->end(), found.begin(), found.end());
+  return true;
+}
+
+// Parses |text| as a whole number into |value|.
+bool ParseNumber(const char* text, int64_t* value) {
+  char* end = nullptr;
+  long long parsed = std::strtoll(text, &end, 10);
+  if (end == text || *end != '\0') return false;
+  *value = parsed;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t direct_match_bonus = belegium::kDefaultDirectMatchBonus;
+  bool show_matrices = false;
+  bool sparse = false;
+  int64_t jobs = 0;
+  int64_t k_best = 1;
+  int64_t max_gap = -1;
+  std::string report_path;
+  std::string cache_directory = belegium::DefaultInputCacheDirectory();
+  std::vector<std::string> rest;
+
+  // the built-in combinations come first, followed by the --score options
+  std::vector<belegium::ScoreExpression> scores;
+  for (int k = 0; k < belegium::kCombinationCount; k++) {
+    scores.push_back(
+        belegium::ScoreExpression::FromCombination(belegium::CombinationAt(k)));
+  }
+  std::vector<std::string> score_texts;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--help") == 0) {
+      PrintUsage();
+      return 0;
+    } else if (std::strcmp(arg, "--ff") == 0) {
+      // always fast forward
+    } else if (std::strcmp(arg, "--matrix") == 0) {
+      show_matrices = true;
+    } else if (std::strcmp(arg, "--sparse") == 0) {
+      sparse = true;
+    } else if (std::strcmp(arg, "--no-cache") == 0) {
+      cache_directory.clear();
+    } else if (std::strncmp(arg, "--extra=", 8) == 0) {
+      if (!ParseNumber(arg + 8, &direct_match_bonus)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(arg, "--extra") == 0) {
+      if (i + 1 >= argc || !ParseNumber(argv[++i], &direct_match_bonus)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strncmp(arg, "--jobs=", 7) == 0) {
+      if (!ParseNumber(arg + 7, &jobs)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(arg, "--jobs") == 0) {
+      if (i + 1 >= argc || !ParseNumber(argv[++i], &jobs)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strncmp(arg, "--k-best=", 9) == 0) {
+      if (!ParseNumber(arg + 9, &k_best) || k_best < 1) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(arg, "--k-best") == 0) {
+      if (i + 1 >= argc || !ParseNumber(argv[++i], &k_best) || k_best < 1) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strncmp(arg, "--max-gap=", 10) == 0) {
+      if (!ParseNumber(arg + 10, &max_gap)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(arg, "--max-gap") == 0) {
+      if (i + 1 >= argc || !ParseNumber(argv[++i], &max_gap)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strncmp(arg, "--score=", 8) == 0) {
+      score_texts.push_back(arg + 8);
+    } else if (std::strcmp(arg, "--score") == 0) {
+      if (i + 1 >= argc) {
+        PrintUsage();
+        return 1;
+      }
+      score_texts.push_back(argv[++i]);
+    } else if (std::strncmp(arg, "--report=", 9) == 0) {
+      report_path = arg + 9;
+    } else if (std::strcmp(arg, "--report") == 0) {
+      if (i + 1 >= argc) {
+        PrintUsage();
+        return 1;
+      }
+      report_path = argv[++i];
+    } else if (std::strncmp(arg, "--", 2) == 0) {
+      PrintUsage();
+      return 1;
+    } else {
+      rest.push_back(arg);
+    }
+  }
+
+  if (rest.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  if (sparse && k_best > 1) {
+    std::fprintf(stderr, "error: --k-best cannot be combined with --sparse\n");
+    return 1;
+  }
+
+  for (const std::string& text : score_texts) {
+    belegium::ScoreExpression score;
+    std::string message;
+    if (!belegium::ScoreExpression::Parse(text, &score, &message)) {
+      std::fprintf(stderr, "error: invalid score \"%s\": %s\n", text.c_str(),
+                   message.c_str());
+      return 1;
+    }
+    scores.push_back(std::move(score));
+  }
+
+  std::vector<std::string> files;
+  for (const std::string& path : rest) {
+    if (!CollectFiles(path, &files)) {
+      std::fprintf(stderr, "error: cannot read directory %s\n", path.c_str());
+      return 1;
+    }
+  }
+
+  // a single file is printed like before, several files get a header each
+  bool batch = rest.size() > 1 || files.size() != 1;
+  std::vector<Cohort> cohorts(files.size());
+  int count = static_cast<int>(scores.size());
+
+  // every file is loaded and transformed by one task, which then queues one
+  // task per problem on the same pool. each cohort is printed as soon as all
+  // of its problems are solved
+  std::mutex output_mutex;
+  {
+    int64_t threads = jobs > 0 ? jobs : belegium::ThreadPool::HardwareThreads();
+    int64_t tasks = static_cast<int64_t>(files.size()) * count;
+    belegium::ThreadPool pool(
+        static_cast<int>(std::max<int64_t>(1, std::min(threads, tasks))));
+    std::vector<Workspace> workspaces(pool.size());
+
+    for (size_t f = 0; f < files.size(); f++) {
+      Cohort* cohort = &cohorts[f];
+      cohort->path = files[f];
+
+      pool.Submit([&, cohort] {
+        cohort->loaded = belegium::LoadInputFileCached(
+            cohort->path, cache_directory, &cohort->tables, &cohort->error);
+        if (!cohort->loaded) {
+          std::lock_guard<std::mutex> lock(output_mutex);
+          if (batch) std::fprintf(stderr, "%s: ", cohort->path.c_str());
+          PrintError(cohort->error);
+          return;
+        }
+
+        // transform data
+        belegium::InputTables& tables = cohort->tables;
+        belegium::ProcessExtrema(&tables.a, &tables.b, direct_match_bonus);
+        // the sparse solver needs no padding
+        cohort->a = sparse ? tables.a
+                           : belegium::Quadratic(tables.a,
+                                                 belegium::kVetoScore);
+        cohort->b = sparse ? tables.b
+                           : belegium::Quadratic(tables.b,
+                                                 belegium::kVetoScore);
+
+        cohort->solutions.resize(count);
+        cohort->remaining = count;
+
+        // match, the independent problems are solved concurrently
+        for (int k = 0; k < count; k++) {
+          pool.Submit([&, cohort, k] {
+            Workspace* workspace =
+                &workspaces[belegium::ThreadPool::CurrentWorker()];
+            Solution solution =
+                Solve(cohort->a, cohort->b, k, scores[k], sparse,
+                      static_cast<int>(std::min<int64_t>(
+                          k_best, std::numeric_limits<int32_t>::max())),
+                      max_gap, workspace);
+
+            std::lock_guard<std::mutex> lock(output_mutex);
+            cohort->solutions[k] = std::move(solution);
+            if (--cohort->remaining == 0) {
+              PrintCohort(cohort, batch, show_matrices);
+            }
+          });
+        }
+      });
+    }
+
+    pool.Wait();
+  }
+
+  bool failed = std::any_of(cohorts.begin(), cohorts.end(),
+                            [](const Cohort& cohort) { return !cohort.loaded; });
+
+  if (!report_path.empty()) {
+    FILE* out = std::fopen(report_path.c_str(), "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "error: cannot write %s\n", report_path.c_str());
+      return 1;
+    }
+
+    bool csv = report_path.size() >= 4 &&
+               report_path.compare(report_path.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+      WriteCsvReport(out, cohorts);
+    } else {
+      WriteJsonReport(out, cohorts);
+    }
+    std::fclose(out);
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+#include "auction_solver.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+// epsilon is divided by this factor after each scaling phase
+constexpr int64_t kScalingFactor = 5;
+
+// minimal number of cells scanned by one bidding task, smaller rounds are not
+// worth waking up the workers
+constexpr int64_t kMinCellsPerTask = int64_t{1} << 15;
+
+}  // namespace
+
+constexpr int64_t AuctionSolver::kMaxScaledCost;
+
+AuctionSolver::AuctionSolver(int thread_count) {
+  if (thread_count < 1) thread_count = ThreadPool::HardwareThreads();
+  if (thread_count > 1) pool_.reset(new ThreadPool(thread_count));
+}
+
+template <typename Cost>
+int64_t AuctionSolver::Solve(const Cost* costs,
+                             int n,
+                             int stride,
+                             int32_t* row_to_col) {
+  stats_ = SolverStats();
+
+  if (n == 1) {
+    row_to_col[0] = 0;
+    return costs[0];
+  }
+
+  // scaled costs are multiples of n + 1, so n times the final epsilon of 1
+  // is less than the distance to any suboptimal assignment
+  scale_ = n + 1;
+  prices_.assign(n, 0);
+  bid_column_.assign(n, -1);
+  bid_price_.assign(n, 0);
+  winner_.assign(n, -1);
+
+  int64_t smallest = kInfinity;
+  int64_t largest = -kInfinity;
+  for (int i = 0; i < n; ++i) {
+    const Cost* cost_row = costs + static_cast<int64_t>(i) * stride;
+    for (int j = 0; j < n; ++j) {
+      smallest = std::min(smallest, static_cast<int64_t>(cost_row[j]));
+      largest = std::max(largest, static_cast<int64_t>(cost_row[j]));
+    }
+  }
+
+  int64_t epsilon = std::max<int64_t>(
+      1, (largest - smallest) * scale_ / kScalingFactor);
+  for (;;) {
+    stats_.augmentations++;
+    RunPhase(costs, n, stride, epsilon);
+    if (epsilon == 1) break;
+    epsilon = std::max<int64_t>(1, epsilon / kScalingFactor);
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < n; ++i) {
+    row_to_col[i] = row_to_col_[i];
+    total += costs[static_cast<int64_t>(i) * stride + row_to_col_[i]];
+  }
+
+  return total;
+}
+
+template <typename Cost>
+void AuctionSolver::RunPhase(const Cost* costs,
+                             int n,
+                             int stride,
+                             int64_t epsilon) {
+  // the prices are kept, but every row bids again
+  row_to_col_.assign(n, -1);
+  col_to_row_.assign(n, -1);
+  bidders_.resize(n);
+  for (int i = 0; i < n; ++i) bidders_[i] = n - 1 - i;
+
+  while (!bidders_.empty()) {
+    if (!pool_) {
+      // the next row bids on the prices raised by all previous bids
+      int row = bidders_.back();
+      bidders_.pop_back();
+
+      Bid(costs, n, stride, epsilon, row);
+      stats_.scanned++;
+      stats_.dual_updates++;
+      int column = bid_column_[row];
+      prices_[column] = bid_price_[row];
+
+      int previous = col_to_row_[column];
+      if (previous != -1) {
+        row_to_col_[previous] = -1;
+        bidders_.push_back(previous);
+      }
+      row_to_col_[row] = column;
+      col_to_row_[column] = row;
+      continue;
+    }
+
+    // all rows bid on the same prices, split into chunks for the workers
+    int64_t count = static_cast<int64_t>(bidders_.size());
+    stats_.scanned += count;
+    stats_.dual_updates += count;
+    int64_t tasks = std::min<int64_t>(
+        pool_->size(), std::max<int64_t>(1, count * n / kMinCellsPerTask));
+    if (tasks == 1) {
+      for (int32_t row : bidders_) Bid(costs, n, stride, epsilon, row);
+    } else {
+      for (int64_t task = 0; task < tasks; ++task) {
+        int64_t begin = count * task / tasks;
+        int64_t end = count * (task + 1) / tasks;
+        pool_->Submit([=] {
+          for (int64_t k = begin; k < end; ++k) {
+            Bid(costs, n, stride, epsilon, bidders_[k]);
+          }
+        });
+      }
+      pool_->Wait();
+    }
+
+    // the highest bid for each column wins, ties go to the first bidder
+    for (int32_t row : bidders_) {
+      int column = bid_column_[row];
+      int winner = winner_[column];
+      if (winner == -1) {
+        winner_[column] = row;
+        won_columns_.push_back(column);
+      } else if (bid_price_[row] > bid_price_[winner]) {
+        winner_[column] = row;
+      }
+    }
+
+    next_bidders_.clear();
+    for (int32_t row : bidders_) {
+      if (winner_[bid_column_[row]] != row) next_bidders_.push_back(row);
+    }
+
+    for (int32_t column : won_columns_) {
+      int row = winner_[column];
+      prices_[column] = bid_price_[row];
+
+      int previous = col_to_row_[column];
+      if (previous != -1) {
+        row_to_col_[previous] = -1;
+        next_bidders_.push_back(previous);
+      }
+      row_to_col_[row] = column;
+      col_to_row_[column] = row;
+      winner_[column] = -1;
+    }
+    won_columns_.clear();
+
+    std::swap(bidders_, next_bidders_);
+  }
+}
+
+template <typename Cost>
+void AuctionSolver::Bid(const Cost* costs,
+                        int n,
+                        int stride,
+                        int64_t epsilon,
+                        int row) {
+  const Cost* cost_row = costs + static_cast<int64_t>(row) * stride;
+
+  // find the cheapest and the second cheapest column including the prices
+  int best_column = -1;
+  int64_t best = kInfinity;
+  int64_t second = kInfinity;
+  for (int j = 0; j < n; ++j) {
+    int64_t value = static_cast<int64_t>(cost_row[j]) * scale_ + prices_[j];
+    if (value < best) {
+      second = best;
+      best = value;
+      best_column = j;
+    } else if (value < second) {
+      second = value;
+    }
+  }
+
+  // raise the price until the row is indifferent between both minus epsilon
+  bid_column_[row] = best_column;
+  bid_price_[row] = prices_[best_column] + second - best + epsilon;
+}
+
+template int64_t AuctionSolver::Solve<int16_t>(const int16_t*,
+                                              int,
+                                              int,
+                                              int32_t*);
+template int64_t AuctionSolver::Solve<int32_t>(const int32_t*,
+                                              int,
+                                              int,
+                                              int32_t*);
+template int64_t AuctionSolver::Solve<int64_t>(const int64_t*,
+                                              int,
+                                              int,
+                                              int32_t*);
+
+}  // namespace belegium
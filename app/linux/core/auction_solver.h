@@ -0,0 +1,84 @@
+#ifndef BELEGIUM_CORE_AUCTION_SOLVER_H_
+#define BELEGIUM_CORE_AUCTION_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "solver_stats.h"
+#include "thread_pool.h"
+
+namespace belegium {
+
+// Solves dense square linear assignment problems (minimization) with the
+// auction algorithm of Bertsekas and epsilon scaling.
+//
+// Unassigned rows bid for their cheapest column and raise its price by the
+// distance to the second cheapest one plus epsilon. Each scaling phase
+// reuses the prices of the previous one with a smaller epsilon. The costs
+// are multiplied by n + 1 internally, so the last phase with an epsilon of 1
+// yields an exactly optimal assignment for integer costs.
+//
+// With a single thread the rows bid one after another and see the prices
+// raised by the previous bids (Gauss-Seidel). With several threads all
+// unassigned rows bid at once on the same prices and the highest bid for each
+// column wins (Jacobi), the bids are split among the threads. The result does
+// not depend on the number of threads used for the Jacobi variant.
+class AuctionSolver {
+ public:
+  // Bids with |thread_count| threads, one per hardware thread if it is < 1.
+  explicit AuctionSolver(int thread_count = 1);
+
+  // Solves the n x n problem whose rows are |stride| cells apart and writes
+  // the column assigned to each row into |row_to_col|. Returns the total cost.
+  // The magnitude of every cost times n + 1 must stay below kMaxScaledCost.
+  // Instantiated for int16_t, int32_t and int64_t costs.
+  template <typename Cost>
+  int64_t Solve(const Cost* costs, int n, int stride, int32_t* row_to_col);
+
+  // Bound of the internally scaled costs, it leaves room for the prices.
+  static constexpr int64_t kMaxScaledCost = int64_t{1} << 52;
+
+  // Work counters of the last solve, |augmentations| counts the scaling
+  // phases and |scanned| the bids, each of which scans one row.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Runs one scaling phase with |epsilon| until every row is assigned.
+  template <typename Cost>
+  void RunPhase(const Cost* costs, int n, int stride, int64_t epsilon);
+
+  // Scans |row| and stores the column it bids for and the new price of that
+  // column in |bid_column_| and |bid_price_|.
+  template <typename Cost>
+  void Bid(const Cost* costs, int n, int stride, int64_t epsilon, int row);
+
+  // pool of the Jacobi variant, null for the Gauss-Seidel variant
+  std::unique_ptr<ThreadPool> pool_;
+
+  // scale of the costs and column prices
+  int64_t scale_ = 1;
+  std::vector<int64_t> prices_;
+
+  // assignment in both directions, -1 if unassigned
+  std::vector<int32_t> row_to_col_;
+  std::vector<int32_t> col_to_row_;
+
+  // bids of the current round by row
+  std::vector<int32_t> bid_column_;
+  std::vector<int64_t> bid_price_;
+
+  // rows bidding in the current and in the next round
+  std::vector<int32_t> bidders_;
+  std::vector<int32_t> next_bidders_;
+
+  // winning row of each column in the current round, -1 if none
+  std::vector<int32_t> winner_;
+  std::vector<int32_t> won_columns_;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_AUCTION_SOLVER_H_
@@ -0,0 +1,579 @@
+#include "belegium_core.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "auction_solver.h"
+#include "component_solver.h"
+#include "cost_width.h"
+#include "incremental_solver.h"
+#include "input_cache.h"
+#include "input_file.h"
+#include "input_preload.h"
+#include "k_best_solver.h"
+#include "lap_solver.h"
+#include "sensitivity.h"
+#include "solver_stats.h"
+#include "solve_job.h"
+#include "sparse_lap_solver.h"
+#include "transportation_solver.h"
+
+struct BelegiumInput {
+  belegium::InputTables tables;
+  belegium::InputError error;
+};
+
+struct BelegiumIncrementalSolver {
+  belegium::IncrementalSolver solver;
+};
+
+struct BelegiumSolveJob {
+  std::unique_ptr<belegium::SolveJob> job;
+};
+
+namespace {
+
+// counters of the last solve on this thread, see belegium_last_solver_stats
+thread_local belegium::SolverStats g_last_stats;
+
+// Returns the directory of the input cache, it is looked up once as the
+// environment does not change.
+const std::string& InputCacheDirectory() {
+  static const std::string directory = belegium::DefaultInputCacheDirectory();
+  return directory;
+}
+
+// Loads started by belegium_preload_input and not taken yet. They are never
+// destroyed, so loads still running at exit do not terminate the process.
+struct PreloadedInputs {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<belegium::InputPreload>> loads;
+};
+
+PreloadedInputs& GetPreloadedInputs() {
+  static PreloadedInputs* inputs = new PreloadedInputs();
+  return *inputs;
+}
+
+}  // namespace
+
+int32_t belegium_solve_assignment(const int64_t* costs,
+                                  int32_t n,
+                                  int32_t* row_to_col,
+                                  int64_t* total_cost) {
+  if (costs == nullptr || row_to_col == nullptr || total_cost == nullptr ||
+      n < 1) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds = belegium::FindCostBounds(costs, n, n, n);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::LapSolver solver;
+  *total_cost = solver.Solve(costs, n, row_to_col);
+  g_last_stats = solver.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_assignment_i32(const int32_t* costs,
+                                      int32_t n,
+                                      int32_t stride,
+                                      int32_t* row_to_col,
+                                      int64_t* total_cost) {
+  if (costs == nullptr || row_to_col == nullptr || total_cost == nullptr ||
+      n < 1 || stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::LapSolver solver;
+  *total_cost = solver.Solve(costs, n, stride, row_to_col);
+  g_last_stats = solver.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_assignment_duals_i32(const int32_t* costs,
+                                            int32_t n,
+                                            int32_t stride,
+                                            int32_t* row_to_col,
+                                            int64_t* row_potentials,
+                                            int64_t* column_potentials,
+                                            int64_t* total_cost) {
+  if (costs == nullptr || row_to_col == nullptr || row_potentials == nullptr ||
+      column_potentials == nullptr || total_cost == nullptr || n < 1 ||
+      stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::LapSolver solver;
+  *total_cost = solver.Solve(costs, n, stride, row_to_col);
+  g_last_stats = solver.stats();
+  std::copy(solver.row_potentials().begin(), solver.row_potentials().end(),
+            row_potentials);
+  std::copy(solver.column_potentials().begin(),
+            solver.column_potentials().end(), column_potentials);
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_sensitivity_i32(const int32_t* costs,
+                                 int32_t n,
+                                 int32_t stride,
+                                 const int32_t* row_to_col,
+                                 const int64_t* row_potentials,
+                                 const int64_t* column_potentials,
+                                 int32_t threads,
+                                 int64_t* margins) {
+  if (costs == nullptr || row_to_col == nullptr || row_potentials == nullptr ||
+      column_potentials == nullptr || margins == nullptr || n < 1 ||
+      stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::SensitivityAnalysis analysis(threads);
+  if (!analysis.Analyze(costs, n, stride, row_to_col, row_potentials,
+                        column_potentials, margins)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+  g_last_stats = analysis.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_rectangular_i32(const int32_t* costs,
+                                       int32_t m,
+                                       int32_t n,
+                                       int32_t stride,
+                                       int32_t* row_to_col,
+                                       int64_t* total_cost) {
+  if (costs == nullptr || row_to_col == nullptr || total_cost == nullptr ||
+      m < 1 || n < 1 || stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, m, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, std::max(m, n))) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::LapSolver solver;
+  *total_cost = solver.SolveRectangular(costs, m, n, stride, row_to_col);
+  g_last_stats = solver.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_assignment_auction_i32(const int32_t* costs,
+                                              int32_t n,
+                                              int32_t stride,
+                                              int32_t threads,
+                                              int32_t* row_to_col,
+                                              int64_t* total_cost) {
+  if (costs == nullptr || row_to_col == nullptr || total_cost == nullptr ||
+      n < 1 || stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  // the solver scales the costs by n + 1
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  int64_t limit = belegium::AuctionSolver::kMaxScaledCost / (int64_t{n} + 1);
+  if (bounds.low <= -limit || bounds.high >= limit) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::AuctionSolver solver(threads);
+  *total_cost = solver.Solve(costs, n, stride, row_to_col);
+  g_last_stats = solver.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_components_i32(const int32_t* costs,
+                                      int32_t n,
+                                      int32_t stride,
+                                      int32_t threads,
+                                      int32_t* row_to_col,
+                                      int64_t* total_cost,
+                                      int32_t* component_count) {
+  if (costs == nullptr || row_to_col == nullptr || total_cost == nullptr ||
+      component_count == nullptr || n < 1 || stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::ComponentSolver solver(threads);
+  *total_cost = solver.Solve(costs, n, stride, row_to_col);
+  *component_count = solver.component_count();
+  g_last_stats = solver.stats();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_k_best_i32(const int32_t* costs,
+                                  int32_t n,
+                                  int32_t stride,
+                                  int32_t k,
+                                  int64_t max_gap,
+                                  int32_t threads,
+                                  int32_t* row_to_cols,
+                                  int64_t* total_costs,
+                                  int32_t* count) {
+  if (costs == nullptr || row_to_cols == nullptr || total_costs == nullptr ||
+      count == nullptr || n < 1 || stride < n || k < 1) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::KBestSolver solver(threads);
+  std::vector<belegium::RankedAssignment> results;
+  solver.Solve(costs, n, stride, k, max_gap, &results);
+  g_last_stats = solver.stats();
+
+  for (size_t i = 0; i < results.size(); i++) {
+    std::copy(results[i].row_to_col.begin(), results[i].row_to_col.end(),
+              row_to_cols + static_cast<int64_t>(i) * n);
+    total_costs[i] = results[i].cost;
+  }
+  *count = static_cast<int32_t>(results.size());
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_transportation(const int64_t* costs,
+                                      int32_t m,
+                                      int32_t n,
+                                      const int32_t* row_capacities,
+                                      const int32_t* column_capacities,
+                                      int32_t* rows,
+                                      int32_t* columns,
+                                      int32_t* assignment_count,
+                                      int64_t* total_cost) {
+  if (costs == nullptr || row_capacities == nullptr ||
+      column_capacities == nullptr || rows == nullptr || columns == nullptr ||
+      assignment_count == nullptr || total_cost == nullptr || m < 1 ||
+      n < 1) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  if (std::any_of(row_capacities, row_capacities + m,
+                  [](int32_t c) { return c < 0; }) ||
+      std::any_of(column_capacities, column_capacities + n,
+                  [](int32_t c) { return c < 0; })) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  std::vector<int32_t> assigned_rows;
+  std::vector<int32_t> assigned_columns;
+
+  belegium::TransportationSolver solver;
+  *total_cost = solver.Solve(costs, m, n, row_capacities, column_capacities,
+                             &assigned_rows, &assigned_columns);
+  g_last_stats = solver.stats();
+
+  std::copy(assigned_rows.begin(), assigned_rows.end(), rows);
+  std::copy(assigned_columns.begin(), assigned_columns.end(), columns);
+  *assignment_count = static_cast<int32_t>(assigned_rows.size());
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_sparse(const int32_t* row_offsets,
+                              const int32_t* columns,
+                              const int64_t* costs,
+                              int32_t m,
+                              int32_t n,
+                              int32_t* row_to_col,
+                              int64_t* total_cost,
+                              int32_t* unassigned) {
+  if (row_offsets == nullptr || row_to_col == nullptr ||
+      total_cost == nullptr || unassigned == nullptr || m < 1 || n < 1 ||
+      row_offsets[0] != 0) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  for (int32_t i = 0; i < m; i++) {
+    if (row_offsets[i + 1] < row_offsets[i]) {
+      return BELEGIUM_ERROR_INVALID_ARGUMENT;
+    }
+  }
+
+  int32_t pairs = row_offsets[m];
+  if (pairs > 0 && (columns == nullptr || costs == nullptr)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+  if (std::any_of(columns, columns + pairs,
+                  [n](int32_t j) { return j < 0 || j >= n; })) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  // unassigned rows are priced at about min(m, n) times the cost range
+  if (pairs > 0) {
+    belegium::CostBounds bounds;
+    bounds.low = *std::min_element(costs, costs + pairs);
+    bounds.high = *std::max_element(costs, costs + pairs);
+    if (!belegium::CostsFitSolvers(bounds, std::max(m, n))) {
+      return BELEGIUM_ERROR_INVALID_ARGUMENT;
+    }
+  }
+
+  belegium::SparseLapSolver solver;
+  *total_cost = solver.Solve(row_offsets, columns, costs, m, n, row_to_col);
+  g_last_stats = solver.stats();
+  *unassigned = static_cast<int32_t>(solver.unassigned_rows().size());
+
+  return *unassigned == 0 ? BELEGIUM_OK : BELEGIUM_ERROR_INFEASIBLE;
+}
+
+BelegiumIncrementalSolver* belegium_incremental_solver_create(void) {
+  return new BelegiumIncrementalSolver();
+}
+
+void belegium_incremental_solver_free(BelegiumIncrementalSolver* solver) {
+  delete solver;
+}
+
+int32_t belegium_incremental_solve_i32(BelegiumIncrementalSolver* solver,
+                                       const int32_t* costs,
+                                       int32_t n,
+                                       int32_t stride,
+                                       int32_t* row_to_col,
+                                       int64_t* total_cost,
+                                       int32_t* repaired) {
+  if (solver == nullptr || costs == nullptr || row_to_col == nullptr ||
+      total_cost == nullptr || repaired == nullptr || n < 1 || stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::CostBounds bounds =
+      belegium::FindCostBounds(costs, n, n, stride);
+  if (!belegium::CostsFitSolvers(bounds, n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  *total_cost = solver->solver.Solve(costs, n, stride, row_to_col);
+  g_last_stats = solver->solver.stats();
+  *repaired = solver->solver.repaired();
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_solve_job_start(BelegiumIncrementalSolver* solver,
+                                 const int32_t* costs,
+                                 int32_t n,
+                                 int32_t stride,
+                                 BelegiumSolveProgressCallback progress,
+                                 BelegiumSolveDoneCallback done,
+                                 void* user_data,
+                                 BelegiumSolveJob** job) {
+  if (solver == nullptr || costs == nullptr || job == nullptr || n < 1 ||
+      stride < n) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+  if (!belegium::CostsFitSolvers(
+          belegium::FindCostBounds(costs, n, n, stride), n)) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  belegium::SolveJob::ProgressCallback on_progress;
+  if (progress != nullptr) {
+    on_progress = [progress, user_data](
+                      const belegium::SolveJob::Progress& state) {
+      progress(user_data, state.assigned, state.n, state.dual_objective);
+    };
+  }
+  belegium::SolveJob::DoneCallback on_done;
+  if (done != nullptr) on_done = [done, user_data] { done(user_data); };
+
+  *job = new BelegiumSolveJob();
+  (*job)->job.reset(new belegium::SolveJob(&solver->solver, costs, n, stride,
+                                           std::move(on_progress),
+                                           std::move(on_done)));
+
+  return BELEGIUM_OK;
+}
+
+void belegium_solve_job_cancel(BelegiumSolveJob* job) {
+  if (job != nullptr) job->job->Cancel();
+}
+
+int32_t belegium_solve_job_finish(BelegiumSolveJob* job,
+                                  int32_t* row_to_col,
+                                  int64_t* total_cost) {
+  if (job == nullptr || row_to_col == nullptr || total_cost == nullptr) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  job->job->Wait();
+  std::copy(job->job->row_to_col().begin(), job->job->row_to_col().end(),
+            row_to_col);
+  *total_cost = job->job->total_cost();
+  g_last_stats = job->job->stats();
+
+  return job->job->cancelled() ? BELEGIUM_ERROR_CANCELLED : BELEGIUM_OK;
+}
+
+void belegium_solve_job_free(BelegiumSolveJob* job) { delete job; }
+
+int32_t belegium_last_solver_stats(BelegiumSolverStats* stats) {
+  if (stats == nullptr) return BELEGIUM_ERROR_INVALID_ARGUMENT;
+
+  stats->augmentations = g_last_stats.augmentations;
+  stats->scanned = g_last_stats.scanned;
+  stats->dual_updates = g_last_stats.dual_updates;
+  stats->path_length = g_last_stats.path_length;
+
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_load_input(const char* path, BelegiumInput** input) {
+  if (path == nullptr || input == nullptr) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+
+  *input = new BelegiumInput();
+  if (!belegium::LoadInputFileCached(path, InputCacheDirectory(),
+                                     &(*input)->tables, &(*input)->error)) {
+    return BELEGIUM_ERROR_INVALID_INPUT;
+  }
+
+  return BELEGIUM_OK;
+}
+
+void belegium_input_free(BelegiumInput* input) {
+  delete input;
+}
+
+int32_t belegium_input_wg_count(const BelegiumInput* input) {
+  return input == nullptr ? 0
+                          : static_cast<int32_t>(input->tables.wgs.size());
+}
+
+int32_t belegium_input_person_count(const BelegiumInput* input) {
+  return input == nullptr ? 0
+                          : static_cast<int32_t>(input->tables.persons.size());
+}
+
+const char* belegium_input_wg(const BelegiumInput* input, int32_t index) {
+  if (index < 0 || index >= belegium_input_wg_count(input)) return nullptr;
+  return input->tables.wgs[index].c_str();
+}
+
+const char* belegium_input_person(const BelegiumInput* input, int32_t index) {
+  if (index < 0 || index >= belegium_input_person_count(input)) return nullptr;
+  return input->tables.persons[index].c_str();
+}
+
+const int64_t* belegium_input_ratings_a(const BelegiumInput* input) {
+  if (input == nullptr || input->tables.a.data.empty()) return nullptr;
+  return input->tables.a.data.data();
+}
+
+const int64_t* belegium_input_ratings_b(const BelegiumInput* input) {
+  if (input == nullptr || input->tables.b.data.empty()) return nullptr;
+  return input->tables.b.data.data();
+}
+
+const char* belegium_input_error_message(const BelegiumInput* input) {
+  return input == nullptr ? "" : input->error.message.c_str();
+}
+
+int32_t belegium_input_error_position(const BelegiumInput* input,
+                                      int32_t* row,
+                                      int32_t* column,
+                                      int32_t* row_offset) {
+  if (input == nullptr || row == nullptr || column == nullptr ||
+      row_offset == nullptr || !input->error.has_position) {
+    return 0;
+  }
+
+  *row = input->error.position.row;
+  *column = input->error.position.column;
+  *row_offset = input->error.position.row_offset;
+  return 1;
+}
+
+int32_t belegium_preload_input(const char* path) {
+  if (path == nullptr) return BELEGIUM_ERROR_INVALID_ARGUMENT;
+
+  // the cache directory is looked up before the thread starts
+  PreloadedInputs& inputs = GetPreloadedInputs();
+  std::unique_ptr<belegium::InputPreload> load(
+      new belegium::InputPreload(path, InputCacheDirectory()));
+
+  std::lock_guard<std::mutex> lock(inputs.mutex);
+  inputs.loads.push_back(std::move(load));
+  return BELEGIUM_OK;
+}
+
+int32_t belegium_take_preloaded_input(const char* path,
+                                      BelegiumInput** input) {
+  if (path == nullptr || input == nullptr) {
+    return BELEGIUM_ERROR_INVALID_ARGUMENT;
+  }
+  *input = nullptr;
+
+  // the load is removed before waiting for it, so other loads can be started
+  // and taken meanwhile
+  std::unique_ptr<belegium::InputPreload> load;
+  {
+    PreloadedInputs& inputs = GetPreloadedInputs();
+    std::lock_guard<std::mutex> lock(inputs.mutex);
+    auto it = std::find_if(
+        inputs.loads.begin(), inputs.loads.end(),
+        [path](const std::unique_ptr<belegium::InputPreload>& candidate) {
+          return candidate->path() == path;
+        });
+    if (it == inputs.loads.end()) return BELEGIUM_ERROR_NOT_FOUND;
+
+    load = std::move(*it);
+    inputs.loads.erase(it);
+  }
+
+  *input = new BelegiumInput();
+  if (!load->Take(&(*input)->tables, &(*input)->error)) {
+    return BELEGIUM_ERROR_INVALID_INPUT;
+  }
+
+  return BELEGIUM_OK;
+}
+
+void belegium_discard_preloaded_inputs(void) {
+  // the loads are joined once they go out of scope, outside of the lock
+  std::vector<std::unique_ptr<belegium::InputPreload>> loads;
+  {
+    PreloadedInputs& inputs = GetPreloadedInputs();
+    std::lock_guard<std::mutex> lock(inputs.mutex);
+    loads.swap(inputs.loads);
+  }
+}
@@ -0,0 +1,335 @@
+#ifndef BELEGIUM_CORE_H_
+#define BELEGIUM_CORE_H_
+
+// C interface of the native matching core. It is loaded by the Dart code via
+// dart:ffi, so every exported function only uses plain C types.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BELEGIUM_CORE_EXPORT __attribute__((visibility("default")))
+
+// Status codes returned by the core functions.
+enum {
+  BELEGIUM_OK = 0,
+  BELEGIUM_ERROR_INVALID_ARGUMENT = 1,
+  BELEGIUM_ERROR_INVALID_INPUT = 2,
+  BELEGIUM_ERROR_INFEASIBLE = 3,
+  BELEGIUM_ERROR_CANCELLED = 4,
+  BELEGIUM_ERROR_NOT_FOUND = 5,
+};
+
+// Input file loaded by belegium_load_input.
+typedef struct BelegiumInput BelegiumInput;
+
+// Solver keeping the state of its last solve, see
+// belegium_incremental_solver_create.
+typedef struct BelegiumIncrementalSolver BelegiumIncrementalSolver;
+
+// Solve running on a thread of its own, see belegium_solve_job_start.
+typedef struct BelegiumSolveJob BelegiumSolveJob;
+
+// Called by a solve job with the number of |assigned| rows of |n| and the dual
+// objective, a lower bound of the optimal cost that rises to it.
+typedef void (*BelegiumSolveProgressCallback)(void* user_data,
+                                              int32_t assigned,
+                                              int32_t n,
+                                              int64_t dual_objective);
+
+// Called by a solve job once its result is available.
+typedef void (*BelegiumSolveDoneCallback)(void* user_data);
+
+// Work counters of a solve, see belegium_last_solver_stats.
+typedef struct BelegiumSolverStats {
+  // number of shortest augmenting path searches or auction rounds
+  int64_t augmentations;
+
+  // number of rows and columns settled by all path searches, or bids
+  int64_t scanned;
+
+  // number of times the dual potentials or prices were changed
+  int64_t dual_updates;
+
+  // number of pairs added to the assignment along all augmenting paths
+  int64_t path_length;
+} BelegiumSolverStats;
+
+// Solves the n x n minimization problem stored row-major in |costs|.
+// Writes the column assigned to each row into |row_to_col| (n entries) and
+// the sum of the assigned costs into |total_cost|. The costs are read in
+// place at the width of |costs|. Returns BELEGIUM_ERROR_INVALID_ARGUMENT if a
+// cost is so large that the sums of the solver could overflow.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_assignment(const int64_t* costs,
+                                                       int32_t n,
+                                                       int32_t* row_to_col,
+                                                       int64_t* total_cost);
+
+// Same as belegium_solve_assignment for 32 bit costs whose rows are |stride|
+// cells apart, so views into larger buffers can be solved without copying.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_assignment_i32(
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    int32_t* row_to_col,
+    int64_t* total_cost);
+
+// Same as belegium_solve_assignment_i32, but also writes the optimal dual
+// potentials into |row_potentials| and |column_potentials| (n entries each).
+// The reduced cost costs[i][j] - row_potentials[i] - column_potentials[j] of
+// every cell is non-negative and 0 for the assigned cells.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_assignment_duals_i32(
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    int32_t* row_to_col,
+    int64_t* row_potentials,
+    int64_t* column_potentials,
+    int64_t* total_cost);
+
+// Writes the margins of every cell of the solved n x n problem whose rows are
+// |stride| cells apart row-major into |margins| (n * n entries), searching
+// with |threads| threads or one per hardware thread if it is < 1. The margin
+// of an unassigned cell is the amount its cost must fall until an optimal
+// assignment contains it, the margin of an assigned cell the amount its cost
+// may rise while |row_to_col| stays optimal, -1 for the single cell of a 1 x 1
+// problem. |row_to_col| must be an optimal assignment and the potentials
+// optimal duals, e.g. those of belegium_solve_assignment_duals_i32, which are
+// optimal for every optimal assignment. Returns
+// BELEGIUM_ERROR_INVALID_ARGUMENT if they are not.
+BELEGIUM_CORE_EXPORT int32_t belegium_sensitivity_i32(
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    const int32_t* row_to_col,
+    const int64_t* row_potentials,
+    const int64_t* column_potentials,
+    int32_t threads,
+    int64_t* margins);
+
+// Same as belegium_solve_assignment_i32 for an m x n problem, which is solved
+// without padding it to a square one in O(min(m, n)^2 * max(m, n)). Every row
+// and column of the smaller side is assigned, |row_to_col| (m entries) is -1
+// for the rows left over.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_rectangular_i32(
+    const int32_t* costs,
+    int32_t m,
+    int32_t n,
+    int32_t stride,
+    int32_t* row_to_col,
+    int64_t* total_cost);
+
+// Same as belegium_solve_assignment_i32 using the auction algorithm with
+// epsilon scaling, which bids with |threads| threads or one per hardware
+// thread if it is < 1. The result is exactly optimal. Returns
+// BELEGIUM_ERROR_INVALID_ARGUMENT if a cost times n + 1 exceeds 2^52.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_assignment_auction_i32(
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    int32_t threads,
+    int32_t* row_to_col,
+    int64_t* total_cost);
+
+// Same as belegium_solve_assignment_i32, but splits the problem into the
+// components of the cells below its largest cost, e.g. below a veto, solves
+// them on their own with |threads| threads or one per hardware thread if it is
+// < 1 and pairs the rows and columns left over at the largest cost. The
+// result is exactly optimal. Writes the number of components with at least
+// one row and one column into |component_count|.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_components_i32(
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    int32_t threads,
+    int32_t* row_to_col,
+    int64_t* total_cost,
+    int32_t* component_count);
+
+// Same as belegium_solve_assignment_i32, but finds the up to |k| cheapest
+// assignments ordered by cost with the partitioning of Murty, searching the
+// subproblems with |threads| threads or one per hardware thread if it is < 1.
+// If |max_gap| is not negative, only assignments costing at most the optimum
+// plus |max_gap| are found, so a gap of 0 enumerates the tied optima. Writes
+// the n columns of the i-th assignment to |row_to_cols| + i * n (k * n
+// entries), its cost into |total_costs|[i] (k entries) and the number of
+// assignments found into |count|.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_k_best_i32(const int32_t* costs,
+                                                       int32_t n,
+                                                       int32_t stride,
+                                                       int32_t k,
+                                                       int64_t max_gap,
+                                                       int32_t threads,
+                                                       int32_t* row_to_cols,
+                                                       int64_t* total_costs,
+                                                       int32_t* count);
+
+// Solves the m x n minimization problem stored row-major in |costs| where
+// row i may be assigned |row_capacities|[i] times and column j
+// |column_capacities|[j] times. Assigns min(sum of row capacities, sum of
+// column capacities) units and writes one (row, column) pair per unit into
+// |rows| and |columns|, which must hold that many entries. The number of
+// pairs is written into |assignment_count| and their costs into |total_cost|.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_transportation(
+    const int64_t* costs,
+    int32_t m,
+    int32_t n,
+    const int32_t* row_capacities,
+    const int32_t* column_capacities,
+    int32_t* rows,
+    int32_t* columns,
+    int32_t* assignment_count,
+    int64_t* total_cost);
+
+// Solves the m x n minimization problem whose allowed pairs are given in
+// compressed sparse row form: the allowed columns of row i and their costs are
+// stored at the indices |row_offsets|[i] to |row_offsets|[i + 1] - 1 of
+// |columns| and |costs|. Every other pair, e.g. a veto, is forbidden and never
+// assigned. As many rows as possible are assigned, with minimal costs among
+// those matchings. Writes the column assigned to each row into |row_to_col|
+// (m entries), -1 if the row is unassigned, the number of unassigned rows
+// into |unassigned| and the costs of the assigned rows into |total_cost|.
+// Returns BELEGIUM_ERROR_INFEASIBLE if any row is unassigned and
+// BELEGIUM_ERROR_INVALID_ARGUMENT if a cost is so large that the sums of the
+// solver could overflow.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_sparse(const int32_t* row_offsets,
+                                                   const int32_t* columns,
+                                                   const int64_t* costs,
+                                                   int32_t m,
+                                                   int32_t n,
+                                                   int32_t* row_to_col,
+                                                   int64_t* total_cost,
+                                                   int32_t* unassigned);
+
+// Creates a solver for a sequence of similar n x n problems. Each problem is
+// compared against the previous one and only the rows or columns with changed
+// costs are re-solved, starting from the kept dual potentials and assignment.
+// Too many changes or a different size lead to a solve from scratch. The
+// solver must be released with belegium_incremental_solver_free and must not
+// be used by several threads at once.
+BELEGIUM_CORE_EXPORT BelegiumIncrementalSolver*
+belegium_incremental_solver_create(void);
+
+// Releases a solver returned by belegium_incremental_solver_create.
+BELEGIUM_CORE_EXPORT void belegium_incremental_solver_free(
+    BelegiumIncrementalSolver* solver);
+
+// Same as belegium_solve_assignment_i32 using the state of |solver|. Writes
+// the number of repaired rows or columns into |repaired|, -1 if the problem
+// was solved from scratch.
+BELEGIUM_CORE_EXPORT int32_t belegium_incremental_solve_i32(
+    BelegiumIncrementalSolver* solver,
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    int32_t* row_to_col,
+    int64_t* total_cost,
+    int32_t* repaired);
+
+// Copies the n x n problem of belegium_incremental_solve_i32 and starts
+// solving it with |solver| on a new thread. |progress| is called every 50 ms
+// at most and once the problem is solved, |done| after the result is
+// available. Both are called with |user_data| on the thread of the job, may be
+// null and must not free the job. |solver| must not be used otherwise until
+// the job is done. Every job must be released with belegium_solve_job_free.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_job_start(
+    BelegiumIncrementalSolver* solver,
+    const int32_t* costs,
+    int32_t n,
+    int32_t stride,
+    BelegiumSolveProgressCallback progress,
+    BelegiumSolveDoneCallback done,
+    void* user_data,
+    BelegiumSolveJob** job);
+
+// Asks |job| to stop as soon as possible. May be called from any thread.
+BELEGIUM_CORE_EXPORT void belegium_solve_job_cancel(BelegiumSolveJob* job);
+
+// Waits for |job| and writes its result like belegium_incremental_solve_i32,
+// its work counters become the last solver stats of the calling thread.
+// Returns BELEGIUM_ERROR_CANCELLED if the job was cancelled, the rows it did
+// not assign are -1 then. The solver completes them with its next solve.
+BELEGIUM_CORE_EXPORT int32_t belegium_solve_job_finish(BelegiumSolveJob* job,
+                                                       int32_t* row_to_col,
+                                                       int64_t* total_cost);
+
+// Cancels |job|, waits for it and releases it.
+BELEGIUM_CORE_EXPORT void belegium_solve_job_free(BelegiumSolveJob* job);
+
+// Writes the work counters of the last solve of any solve function on the
+// calling thread into |stats|, all zero if there was none.
+BELEGIUM_CORE_EXPORT int32_t belegium_last_solver_stats(
+    BelegiumSolverStats* stats);
+
+// Loads the two-table csv file at |path|. The file is memory mapped and its
+// ratings are parsed directly into the buffers of the handle stored in
+// |input|. The tables of valid files are cached by the hash of their content
+// in the cache directory of the user, so loading an unchanged file again
+// skips parsing. Returns BELEGIUM_ERROR_INVALID_INPUT if the file is missing or
+// invalid, the handle then only describes the error. Every handle must be
+// released with belegium_input_free.
+BELEGIUM_CORE_EXPORT int32_t belegium_load_input(const char* path,
+                                                 BelegiumInput** input);
+
+// Releases a handle returned by belegium_load_input.
+BELEGIUM_CORE_EXPORT void belegium_input_free(BelegiumInput* input);
+
+// Number of names in the header of the first (wgs) and the second (persons)
+// table, the names are sorted.
+BELEGIUM_CORE_EXPORT int32_t belegium_input_wg_count(
+    const BelegiumInput* input);
+BELEGIUM_CORE_EXPORT int32_t belegium_input_person_count(
+    const BelegiumInput* input);
+
+// Utf-8 encoded name at |index|, null if |index| is out of range. The string
+// is owned by |input|.
+BELEGIUM_CORE_EXPORT const char* belegium_input_wg(const BelegiumInput* input,
+                                                   int32_t index);
+BELEGIUM_CORE_EXPORT const char* belegium_input_person(
+    const BelegiumInput* input,
+    int32_t index);
+
+// Row-major ratings of the first table (persons x wgs) and of the second
+// table (wgs x persons). The buffers are owned by |input|.
+BELEGIUM_CORE_EXPORT const int64_t* belegium_input_ratings_a(
+    const BelegiumInput* input);
+BELEGIUM_CORE_EXPORT const int64_t* belegium_input_ratings_b(
+    const BelegiumInput* input);
+
+// Message of a failed load, empty if the file was loaded. The string is owned
+// by |input|.
+BELEGIUM_CORE_EXPORT const char* belegium_input_error_message(
+    const BelegiumInput* input);
+
+// Writes the position of a failed load into |row|, |column| and |row_offset|,
+// unset members are -1. Returns 0 if the error has no position.
+BELEGIUM_CORE_EXPORT int32_t belegium_input_error_position(
+    const BelegiumInput* input,
+    int32_t* row,
+    int32_t* column,
+    int32_t* row_offset);
+
+// Starts loading the csv file at |path| like belegium_load_input on a
+// background thread, e.g. while the GUI starts, and keeps the result until it
+// is taken with belegium_take_preloaded_input.
+BELEGIUM_CORE_EXPORT int32_t belegium_preload_input(const char* path);
+
+// Waits for the load of |path| started by belegium_preload_input and stores
+// its handle into |input|, which must be released with belegium_input_free.
+// Returns the status of the load, or BELEGIUM_ERROR_NOT_FOUND and stores null
+// if no load of exactly |path| was started or it was taken already, e.g. by
+// another caller.
+BELEGIUM_CORE_EXPORT int32_t belegium_take_preloaded_input(
+    const char* path,
+    BelegiumInput** input);
+
+// Waits for and releases every preloaded input that was not taken.
+BELEGIUM_CORE_EXPORT void belegium_discard_preloaded_inputs(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // BELEGIUM_CORE_H_
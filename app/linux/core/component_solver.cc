@@ -0,0 +1,191 @@
+#include "component_solver.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace belegium {
+
+ComponentSolver::ComponentSolver(int thread_count) {
+  if (thread_count < 1) thread_count = ThreadPool::HardwareThreads();
+  if (thread_count > 1) pool_.reset(new ThreadPool(thread_count));
+  solvers_.resize(thread_count);
+}
+
+template <typename Cost>
+int64_t ComponentSolver::Solve(const Cost* costs,
+                               int n,
+                               int stride,
+                               int32_t* row_to_col) {
+  FindComponents(costs, n, stride);
+  component_count_ = static_cast<int>(components_.size());
+
+  // a single component spanning the whole problem is solved in place
+  if (component_count_ == 1 && components_[0].rows.size() == size_t(n) &&
+      components_[0].columns.size() == size_t(n)) {
+    int64_t cost = solvers_[0].Solve(costs, n, stride, row_to_col);
+    stats_ = solvers_[0].stats();
+    return cost;
+  }
+
+  std::fill(row_to_col, row_to_col + n, -1);
+  std::vector<SolverStats> worker_stats(solvers_.size());
+
+  // the components are interleaved, so every task gets some of the large ones
+  auto solve_range = [&](int task, int tasks) {
+    int worker = ThreadPool::WorkerIndex(pool_.get());
+    for (int c = task; c < component_count_; c += tasks) {
+      SolveComponent(costs, stride, components_[c], &solvers_[worker],
+                     row_to_col);
+
+      const SolverStats& stats = solvers_[worker].stats();
+      SolverStats& sum = worker_stats[worker];
+      sum.augmentations += stats.augmentations;
+      sum.scanned += stats.scanned;
+      sum.dual_updates += stats.dual_updates;
+      sum.path_length += stats.path_length;
+    }
+  };
+
+  int tasks = 1;
+  if (pool_) tasks = std::min(pool_->size(), component_count_);
+  if (tasks > 1) {
+    for (int task = 0; task < tasks; ++task) {
+      pool_->Submit([&solve_range, task, tasks] {
+        solve_range(task, tasks);
+      });
+    }
+    pool_->Wait();
+  } else {
+    solve_range(0, 1);
+  }
+
+  stats_ = SolverStats();
+  for (const SolverStats& stats : worker_stats) {
+    stats_.augmentations += stats.augmentations;
+    stats_.scanned += stats.scanned;
+    stats_.dual_updates += stats.dual_updates;
+    stats_.path_length += stats.path_length;
+  }
+
+  // rows and columns left over belong to different components, so every
+  // pair of them has the largest cost
+  std::vector<char> taken(n, 0);
+  for (int i = 0; i < n; ++i) {
+    if (row_to_col[i] >= 0) taken[row_to_col[i]] = 1;
+  }
+  int column = 0;
+  for (int i = 0; i < n; ++i) {
+    if (row_to_col[i] >= 0) continue;
+    while (taken[column]) ++column;
+    row_to_col[i] = column;
+    taken[column] = 1;
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < n; ++i) {
+    total += costs[static_cast<int64_t>(i) * stride + row_to_col[i]];
+  }
+  return total;
+}
+
+template <typename Cost>
+void ComponentSolver::FindComponents(const Cost* costs, int n, int stride) {
+  Cost largest = costs[0];
+  for (int i = 0; i < n; ++i) {
+    const Cost* row = costs + static_cast<int64_t>(i) * stride;
+    largest = std::max(largest, *std::max_element(row, row + n));
+  }
+
+  // rows are the nodes 0 to n - 1, columns n to 2n - 1
+  parent_.resize(2 * static_cast<size_t>(n));
+  std::iota(parent_.begin(), parent_.end(), 0);
+  for (int i = 0; i < n; ++i) {
+    const Cost* row = costs + static_cast<int64_t>(i) * stride;
+    for (int j = 0; j < n; ++j) {
+      if (row[j] == largest) continue;
+
+      int32_t a = Find(i);
+      int32_t b = Find(n + j);
+      if (a != b) parent_[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+  // collect the nodes by root, in increasing order
+  std::vector<int32_t> index(2 * static_cast<size_t>(n), -1);
+  std::vector<Component> found;
+  for (int node = 0; node < 2 * n; ++node) {
+    int32_t root = Find(node);
+    if (index[root] < 0) {
+      index[root] = static_cast<int32_t>(found.size());
+      found.emplace_back();
+    }
+    Component& component = found[index[root]];
+    if (node < n) {
+      component.rows.push_back(node);
+    } else {
+      component.columns.push_back(node - n);
+    }
+  }
+
+  components_.clear();
+  for (Component& component : found) {
+    if (!component.rows.empty() && !component.columns.empty()) {
+      components_.push_back(std::move(component));
+    }
+  }
+  std::stable_sort(components_.begin(), components_.end(),
+                   [](const Component& a, const Component& b) {
+                     return std::max(a.rows.size(), a.columns.size()) >
+                            std::max(b.rows.size(), b.columns.size());
+                   });
+}
+
+int32_t ComponentSolver::Find(int32_t node) {
+  while (parent_[node] != node) {
+    parent_[node] = parent_[parent_[node]];
+    node = parent_[node];
+  }
+  return node;
+}
+
+template <typename Cost>
+void ComponentSolver::SolveComponent(const Cost* costs,
+                                     int stride,
+                                     const Component& component,
+                                     LapSolver* solver,
+                                     int32_t* row_to_col) {
+  // the smaller side is assigned completely, the rows and columns of the
+  // larger side left over are paired with other components at the largest
+  // cost, which is what a padded square block would cost as well
+  int m = static_cast<int>(component.rows.size());
+  int n = static_cast<int>(component.columns.size());
+  std::vector<Cost> block(static_cast<size_t>(m) * n);
+  for (int i = 0; i < m; ++i) {
+    const Cost* row =
+        costs + static_cast<int64_t>(component.rows[i]) * stride;
+    Cost* out = block.data() + static_cast<int64_t>(i) * n;
+    for (int j = 0; j < n; ++j) out[j] = row[component.columns[j]];
+  }
+
+  std::vector<int32_t> block_row_to_col(m);
+  solver->SolveRectangular(block.data(), m, n, n, block_row_to_col.data());
+  for (int i = 0; i < m; ++i) {
+    int j = block_row_to_col[i];
+    if (j >= 0) row_to_col[component.rows[i]] = component.columns[j];
+  }
+}
+
+template int64_t ComponentSolver::Solve<int16_t>(const int16_t*,
+                                                 int,
+                                                 int,
+                                                 int32_t*);
+template int64_t ComponentSolver::Solve<int32_t>(const int32_t*,
+                                                 int,
+                                                 int,
+                                                 int32_t*);
+template int64_t ComponentSolver::Solve<int64_t>(const int64_t*,
+                                                 int,
+                                                 int,
+                                                 int32_t*);
+
+}  // namespace belegium
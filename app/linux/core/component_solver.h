@@ -0,0 +1,88 @@
+#ifndef BELEGIUM_CORE_COMPONENT_SOLVER_H_
+#define BELEGIUM_CORE_COMPONENT_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lap_solver.h"
+#include "solver_stats.h"
+#include "thread_pool.h"
+
+namespace belegium {
+
+// Solves dense square linear assignment problems (minimization) whose cells
+// often have the largest cost, e.g. vetoes and padding, by splitting them into
+// independent smaller problems.
+//
+// Rows and columns joined by a cell below the largest cost form the
+// components of a bipartite graph, found with union-find in O(n^2). Every
+// cell between two components has the largest cost, so pairing a row and a
+// column of the same component is never worse than pairing both outside.
+// An optimal assignment therefore solves each component on its own as a
+// rectangular problem, which assigns its smaller side completely, and pairs
+// the rows and columns left over at the largest cost. As the solve is cubic,
+// k equally large components take about 1 / k^2 of the time, and they are
+// split among the threads. The result does not depend on
+// the number of threads.
+class ComponentSolver {
+ public:
+  // Solves the components with |thread_count| threads, one per hardware
+  // thread if it is < 1.
+  explicit ComponentSolver(int thread_count = 1);
+
+  // Solves the n x n problem whose rows are |stride| cells apart and writes
+  // the column assigned to each row into |row_to_col|. Returns the total
+  // cost. Instantiated for int16_t, int32_t and int64_t costs.
+  template <typename Cost>
+  int64_t Solve(const Cost* costs, int n, int stride, int32_t* row_to_col);
+
+  // Number of components of the last solve with at least one row and one
+  // column.
+  int component_count() const { return component_count_; }
+
+  // Work counters of the last solve, summed over its components.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Rows and columns of one component in increasing order.
+  struct Component {
+    std::vector<int32_t> rows;
+    std::vector<int32_t> columns;
+  };
+
+  // Finds the components with at least one row and one column into
+  // |components_|, the largest first, joined by cells below the largest cost.
+  template <typename Cost>
+  void FindComponents(const Cost* costs, int n, int stride);
+
+  // Returns the root of |node| in |parent_|.
+  int32_t Find(int32_t node);
+
+  // Solves the rectangular block of |component| with |solver| without
+  // padding it and writes its pairs into |row_to_col|, rows left over keep -1.
+  template <typename Cost>
+  static void SolveComponent(const Cost* costs,
+                             int stride,
+                             const Component& component,
+                             LapSolver* solver,
+                             int32_t* row_to_col);
+
+  // pool to solve the components, null to solve them on the caller
+  std::unique_ptr<ThreadPool> pool_;
+
+  // solvers, one per worker
+  std::vector<LapSolver> solvers_;
+
+  // union-find parents of the n rows followed by the n columns
+  std::vector<int32_t> parent_;
+
+  std::vector<Component> components_;
+  int component_count_ = 0;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_COMPONENT_SOLVER_H_
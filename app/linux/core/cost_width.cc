@@ -0,0 +1,68 @@
+#include "cost_width.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace belegium {
+
+namespace {
+
+// bound of the cost magnitude times 4n + 4, it keeps the potentials and path
+// lengths below the infinity of LapSolver with room to spare
+constexpr int64_t kMaxScaledCost = std::numeric_limits<int64_t>::max() / 8;
+
+template <typename Narrow>
+bool Holds(const CostBounds& bounds) {
+  return bounds.low >= std::numeric_limits<Narrow>::min() &&
+         bounds.high <= std::numeric_limits<Narrow>::max();
+}
+
+}  // namespace
+
+template <typename Cost>
+CostBounds FindCostBounds(const Cost* costs, int m, int n, int stride) {
+  CostBounds bounds;
+  if (m < 1 || n < 1) return bounds;
+
+  Cost low = costs[0];
+  Cost high = costs[0];
+  for (int i = 0; i < m; i++) {
+    const Cost* row = costs + static_cast<int64_t>(i) * stride;
+    for (int j = 0; j < n; j++) {
+      low = std::min(low, row[j]);
+      high = std::max(high, row[j]);
+    }
+  }
+
+  bounds.low = low;
+  bounds.high = high;
+  return bounds;
+}
+
+CostWidth NarrowestCostWidth(const CostBounds& bounds) {
+  if (Holds<int16_t>(bounds)) return CostWidth::kInt16;
+  if (Holds<int32_t>(bounds)) return CostWidth::kInt32;
+  return CostWidth::kInt64;
+}
+
+const char* CostWidthName(CostWidth width) {
+  switch (width) {
+    case CostWidth::kInt16:
+      return "int16";
+    case CostWidth::kInt32:
+      return "int32";
+    case CostWidth::kInt64:
+      return "int64";
+  }
+  return "";
+}
+
+bool CostsFitSolvers(const CostBounds& bounds, int n) {
+  int64_t limit = kMaxScaledCost / (4 * int64_t{n} + 4);
+  return bounds.low >= -limit && bounds.high <= limit;
+}
+
+template CostBounds FindCostBounds<int32_t>(const int32_t*, int, int, int);
+template CostBounds FindCostBounds<int64_t>(const int64_t*, int, int, int);
+
+}  // namespace belegium
@@ -0,0 +1,111 @@
+#ifndef BELEGIUM_CORE_COST_WIDTH_H_
+#define BELEGIUM_CORE_COST_WIDTH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace belegium {
+
+// Integer types the dense solvers are instantiated for. Rating based costs
+// are small, so most problems are built with 16 or 32 bit cells, which halves
+// or quarters the memory every shortest path step reads. The potentials and
+// path lengths of the solvers stay 64 bit.
+enum class CostWidth {
+  kInt16,
+  kInt32,
+  kInt64,
+};
+
+// Smallest and largest cost of a problem.
+struct CostBounds {
+  int64_t low = 0;
+  int64_t high = 0;
+};
+
+// Returns the bounds of the m x n costs whose rows are |stride| cells apart.
+// Instantiated for int32_t and int64_t costs.
+template <typename Cost>
+CostBounds FindCostBounds(const Cost* costs, int m, int n, int stride);
+
+// Returns the narrowest width holding every cost within |bounds|.
+CostWidth NarrowestCostWidth(const CostBounds& bounds);
+
+// Returns the name of |width|, e.g. "int16".
+const char* CostWidthName(CostWidth width);
+
+// Whether n x n costs within |bounds| can be solved without overflow. The
+// potentials and path lengths of the solvers are sums of up to 2n costs and
+// must stay far below their infinity.
+bool CostsFitSolvers(const CostBounds& bounds, int n);
+
+// Costs of an m x n problem stored row-major in the narrowest type holding
+// them. The cells are written at that width when the problem is built, so no
+// wider copy of the problem is kept for solving.
+class CostMatrix {
+ public:
+  CostMatrix() = default;
+
+  // Builds the m x n matrix of the costs |cost|(i, j), which must all lie
+  // within |bounds|, in the narrowest type holding them.
+  template <typename CellCost>
+  CostMatrix(int m, int n, const CostBounds& bounds, CellCost cost)
+      : m_(m), n_(n), bounds_(bounds), width_(NarrowestCostWidth(bounds)) {
+    switch (width_) {
+      case CostWidth::kInt16:
+        Fill(cost, &int16_);
+        break;
+      case CostWidth::kInt32:
+        Fill(cost, &int32_);
+        break;
+      case CostWidth::kInt64:
+        Fill(cost, &int64_);
+        break;
+    }
+  }
+
+  int m() const { return m_; }
+  int n() const { return n_; }
+  const CostBounds& bounds() const { return bounds_; }
+  CostWidth width() const { return width_; }
+
+  // Calls |solve|(costs, stride) with the cells. |solve| must accept pointers
+  // to int16_t, int32_t and int64_t, e.g. a generic lambda.
+  template <typename Solver>
+  auto Solve(Solver solve) const
+      -> decltype(solve(static_cast<const int64_t*>(nullptr), 0)) {
+    switch (width_) {
+      case CostWidth::kInt16:
+        return solve(int16_.data(), n_);
+      case CostWidth::kInt32:
+        return solve(int32_.data(), n_);
+      case CostWidth::kInt64:
+        break;
+    }
+    return solve(int64_.data(), n_);
+  }
+
+ private:
+  template <typename CellCost, typename Cost>
+  void Fill(CellCost cost, std::vector<Cost>* cells) {
+    cells->resize(static_cast<size_t>(m_) * n_);
+    Cost* out = cells->data();
+    for (int i = 0; i < m_; i++) {
+      for (int j = 0; j < n_; j++) *out++ = static_cast<Cost>(cost(i, j));
+    }
+  }
+
+  int m_ = 0;
+  int n_ = 0;
+  CostBounds bounds_;
+  CostWidth width_ = CostWidth::kInt64;
+
+  // cells of |width_|, the others stay empty
+  std::vector<int16_t> int16_;
+  std::vector<int32_t> int32_;
+  std::vector<int64_t> int64_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_COST_WIDTH_H_
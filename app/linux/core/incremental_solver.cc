@@ -0,0 +1,108 @@
+#include "incremental_solver.h"
+
+#include <cstddef>
+
+namespace belegium {
+
+namespace {
+
+// Repairing a line costs about as much as one augmenting path of a full
+// solve, which in turn starts with many rows assigned by the column
+// reduction. Beyond this share of changed lines solving from scratch is
+// faster.
+constexpr int kMaxRepairedShareDivisor = 4;
+
+}  // namespace
+
+template <typename Cost>
+int64_t IncrementalSolver::Solve(const Cost* costs,
+                                 int n,
+                                 int stride,
+                                 int32_t* row_to_col) {
+  bool warm = n == n_ && solver_.size() == n;
+
+  if (warm) {
+    // find the change shared by most cells with a majority vote
+    int64_t shift = 0;
+    int64_t votes = 0;
+    for (int i = 0; i < n; i++) {
+      const Cost* row = costs + static_cast<int64_t>(i) * stride;
+      const int64_t* last = costs_.data() + static_cast<int64_t>(i) * n;
+      for (int j = 0; j < n; j++) {
+        int64_t change = static_cast<int64_t>(row[j]) - last[j];
+        if (votes == 0) shift = change;
+        votes += change == shift ? 1 : -1;
+      }
+    }
+
+    // collect the rows and columns with other changes
+    row_changed_.assign(n, 0);
+    column_changed_.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+      const Cost* row = costs + static_cast<int64_t>(i) * stride;
+      const int64_t* last = costs_.data() + static_cast<int64_t>(i) * n;
+      for (int j = 0; j < n; j++) {
+        if (static_cast<int64_t>(row[j]) - last[j] != shift) {
+          row_changed_[i] = 1;
+          column_changed_[j] = 1;
+        }
+      }
+    }
+
+    rows_.clear();
+    columns_.clear();
+    for (int k = 0; k < n; k++) {
+      if (row_changed_[k]) rows_.push_back(k);
+      if (column_changed_[k]) columns_.push_back(k);
+    }
+
+    // the changes are covered by either all changed rows or all changed
+    // columns, the smaller set is repaired
+    if (columns_.size() < rows_.size()) {
+      rows_.clear();
+    } else {
+      columns_.clear();
+    }
+
+    repaired_ = static_cast<int>(rows_.size() + columns_.size());
+    warm = repaired_ * kMaxRepairedShareDivisor <= n;
+    if (warm) solver_.ShiftPotentials(shift);
+  }
+
+  // remember the costs for the next solve
+  costs_.resize(static_cast<size_t>(n) * n);
+  for (int i = 0; i < n; i++) {
+    const Cost* row = costs + static_cast<int64_t>(i) * stride;
+    int64_t* last = costs_.data() + static_cast<int64_t>(i) * n;
+    for (int j = 0; j < n; j++) last[j] = row[j];
+  }
+  n_ = n;
+
+  if (warm) {
+    return solver_.Repair(costs, n, stride, rows_, columns_, row_to_col);
+  }
+
+  repaired_ = -1;
+  return solver_.Solve(costs, n, stride, row_to_col);
+}
+
+void IncrementalSolver::Reset() {
+  costs_.clear();
+  n_ = 0;
+  repaired_ = -1;
+}
+
+template int64_t IncrementalSolver::Solve<int16_t>(const int16_t*,
+                                                  int,
+                                                  int,
+                                                  int32_t*);
+template int64_t IncrementalSolver::Solve<int32_t>(const int32_t*,
+                                                  int,
+                                                  int,
+                                                  int32_t*);
+template int64_t IncrementalSolver::Solve<int64_t>(const int64_t*,
+                                                  int,
+                                                  int,
+                                                  int32_t*);
+
+}  // namespace belegium
@@ -0,0 +1,69 @@
+#ifndef BELEGIUM_CORE_INCREMENTAL_SOLVER_H_
+#define BELEGIUM_CORE_INCREMENTAL_SOLVER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "lap_solver.h"
+#include "solver_stats.h"
+
+namespace belegium {
+
+// Solves a sequence of square assignment problems (minimization) where each
+// problem usually differs from the previous one in a few cells only, e.g.
+// after a single rating was fixed.
+//
+// The solver keeps the costs, the dual potentials and the assignment of the
+// last solve. The next problem is compared cell by cell against the kept costs
+// and only the rows or columns containing changes are repaired by
+// LapSolver::Repair. A change of all costs by the same amount, as caused by a
+// new largest entry when inverting a problem, is absorbed by the potentials.
+// If too many rows or columns changed or the size differs, the problem is
+// solved from scratch.
+class IncrementalSolver {
+ public:
+  // Solves the n x n problem whose rows are |stride| cells apart and writes
+  // the column assigned to each row into |row_to_col|. Returns the total cost.
+  // Instantiated for int16_t, int32_t and int64_t costs.
+  template <typename Cost>
+  int64_t Solve(const Cost* costs, int n, int stride, int32_t* row_to_col);
+
+  // Sets the observer of the solves, see LapSolver::set_progress. A cancelled
+  // solve is completed by the next one.
+  void set_progress(LapSolver::Progress progress) {
+    solver_.set_progress(std::move(progress));
+  }
+
+  // Whether the last solve was cancelled, see LapSolver::cancelled.
+  bool cancelled() const { return solver_.cancelled(); }
+
+  // Forgets the last problem, so the next one is solved from scratch.
+  void Reset();
+
+  // Number of rows or columns repaired by the last solve, -1 if it was solved
+  // from scratch.
+  int repaired() const { return repaired_; }
+
+  // Work counters of the last solve.
+  const SolverStats& stats() const { return solver_.stats(); }
+
+ private:
+  LapSolver solver_;
+
+  // costs of the last problem, row-major without gaps
+  std::vector<int64_t> costs_;
+  int n_ = 0;
+
+  // rows and columns with changed cells
+  std::vector<char> row_changed_;
+  std::vector<char> column_changed_;
+  std::vector<int32_t> rows_;
+  std::vector<int32_t> columns_;
+
+  int repaired_ = -1;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_INCREMENTAL_SOLVER_H_
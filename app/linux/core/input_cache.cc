@@ -0,0 +1,350 @@
+#include "input_cache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace belegium {
+
+namespace {
+
+// first bytes of every cache file
+constexpr char kMagic[8] = {'B', 'L', 'G', 'M', 'I', 'N', 'P', 'T'};
+
+// the file is written in native byte order, files of another one do not match
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+// Start of a cache file. It is followed by the names of the wgs and persons,
+// each as its 32 bit length and its bytes, and by the ratings of the first
+// (persons x wgs) and the second table (wgs x persons) as integers of
+// |cell_size| bytes. Every block is padded to a multiple of 8 bytes, so the
+// ratings of a mapped file are aligned.
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t content_hash;
+  uint64_t content_size;
+  uint32_t wg_count;
+  uint32_t person_count;
+
+  // 1, 2, 4 or 8, the smallest size that fits all ratings
+  uint32_t cell_size;
+  uint32_t reserved;
+
+  // size of the names block including its padding
+  uint64_t names_size;
+};
+
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader must not be padded");
+
+// multipliers of the hash, odd with well mixed bits
+constexpr uint64_t kHashPrime1 = 0xa0761d6478bd642fULL;
+constexpr uint64_t kHashPrime2 = 0xe7037ed1a0b428dbULL;
+constexpr uint64_t kHashPrime3 = 0x8ebc6af09c88c6e3ULL;
+
+// Folds the 128 bit product of |a| and |b|.
+uint64_t Mix(uint64_t a, uint64_t b) {
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<uint64_t>(product) ^
+         static_cast<uint64_t>(product >> 64);
+}
+
+uint64_t Load64(const char* data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t Padded(uint64_t size) {
+  return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Returns the number of bytes needed to store every rating of |a| and |b|.
+uint32_t CellSize(const Matrix& a, const Matrix& b) {
+  int64_t low = 0;
+  int64_t high = 0;
+  for (const Matrix* matrix : {&a, &b}) {
+    for (int64_t value : matrix->data) {
+      low = std::min(low, value);
+      high = std::max(high, value);
+    }
+  }
+
+  if (low >= std::numeric_limits<int8_t>::min() &&
+      high <= std::numeric_limits<int8_t>::max()) {
+    return 1;
+  }
+  if (low >= std::numeric_limits<int16_t>::min() &&
+      high <= std::numeric_limits<int16_t>::max()) {
+    return 2;
+  }
+  if (low >= std::numeric_limits<int32_t>::min() &&
+      high <= std::numeric_limits<int32_t>::max()) {
+    return 4;
+  }
+  return 8;
+}
+
+// Writes the cells of |matrix| as Cell followed by the padding of the block.
+template <typename Cell>
+bool WriteCells(FILE* file, const Matrix& matrix) {
+  constexpr size_t kChunk = 4096;
+  Cell buffer[kChunk];
+
+  size_t count = matrix.data.size();
+  for (size_t k = 0; k < count; k += kChunk) {
+    size_t chunk = std::min(kChunk, count - k);
+    for (size_t c = 0; c < chunk; c++) {
+      buffer[c] = static_cast<Cell>(matrix.data[k + c]);
+    }
+    if (std::fwrite(buffer, sizeof(Cell), chunk, file) != chunk) return false;
+  }
+
+  static const char kZeros[8] = {};
+  size_t padding = Padded(count * sizeof(Cell)) - count * sizeof(Cell);
+  return std::fwrite(kZeros, 1, padding, file) == padding;
+}
+
+// Widens the |matrix|->m x |matrix|->n cells of Cell at |data| into |matrix|.
+template <typename Cell>
+void ReadCells(const char* data, Matrix* matrix) {
+  const Cell* cells = reinterpret_cast<const Cell*>(data);
+  std::copy(cells, cells + matrix->data.size(), matrix->data.begin());
+}
+
+bool WriteMatrix(FILE* file, const Matrix& matrix, uint32_t cell_size) {
+  switch (cell_size) {
+    case 1:
+      return WriteCells<int8_t>(file, matrix);
+    case 2:
+      return WriteCells<int16_t>(file, matrix);
+    case 4:
+      return WriteCells<int32_t>(file, matrix);
+    default:
+      return WriteCells<int64_t>(file, matrix);
+  }
+}
+
+void ReadMatrix(const char* data, uint32_t cell_size, Matrix* matrix) {
+  switch (cell_size) {
+    case 1:
+      return ReadCells<int8_t>(data, matrix);
+    case 2:
+      return ReadCells<int16_t>(data, matrix);
+    case 4:
+      return ReadCells<int32_t>(data, matrix);
+    default:
+      return ReadCells<int64_t>(data, matrix);
+  }
+}
+
+// Returns the path of the cache file of content with |hash|.
+std::string CachePath(const std::string& directory, uint64_t hash) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "/%016" PRIx64 ".bin", hash);
+  return directory + name;
+}
+
+// Creates |directory| and its missing parents. Returns false if it does not
+// exist afterwards.
+bool CreateDirectories(const std::string& directory) {
+  for (size_t slash = directory.find('/', 1); slash != std::string::npos;
+       slash = directory.find('/', slash + 1)) {
+    mkdir(directory.substr(0, slash).c_str(), 0755);
+  }
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) return false;
+
+  struct stat info;
+  return stat(directory.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+// Reads the tables from the cache file at |path| if it belongs to |size|
+// bytes of content with |hash|.
+bool ReadCache(const std::string& path,
+               uint64_t hash,
+               uint64_t size,
+               InputTables* tables) {
+  MappedFile file(path);
+  if (!file.opened() || file.size() < sizeof(CacheHeader)) return false;
+
+  CacheHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kInputCacheVersion ||
+      header.byte_order != kByteOrderMark || header.content_hash != hash ||
+      header.content_size != size) {
+    return false;
+  }
+
+  // the sizes are checked before anything is allocated, so a damaged file is
+  // rebuilt like a stale one
+  uint64_t limit = std::numeric_limits<int32_t>::max();
+  if (header.wg_count > limit || header.person_count > limit ||
+      (header.cell_size != 1 && header.cell_size != 2 &&
+       header.cell_size != 4 && header.cell_size != 8) ||
+      header.names_size > file.size() - sizeof(CacheHeader)) {
+    return false;
+  }
+  uint64_t cells = static_cast<uint64_t>(header.wg_count) * header.person_count;
+  if (cells > file.size() / header.cell_size) return false;
+  uint64_t table_size = Padded(cells * header.cell_size);
+  if (file.size() != sizeof(CacheHeader) + header.names_size + 2 * table_size) {
+    return false;
+  }
+
+  const char* names = file.data() + sizeof(CacheHeader);
+  const char* names_end = names + header.names_size;
+  tables->wgs.clear();
+  tables->persons.clear();
+  for (uint64_t k = 0; k < header.wg_count + header.person_count; k++) {
+    uint32_t length;
+    if (names_end - names < static_cast<ptrdiff_t>(sizeof(length))) {
+      return false;
+    }
+    std::memcpy(&length, names, sizeof(length));
+    names += sizeof(length);
+    if (static_cast<uint64_t>(names_end - names) < length) return false;
+
+    (k < header.wg_count ? tables->wgs : tables->persons)
+        .emplace_back(names, length);
+    names += length;
+  }
+
+  int wg_count = static_cast<int>(header.wg_count);
+  int person_count = static_cast<int>(header.person_count);
+  const char* ratings = names_end;
+  tables->a = Matrix(person_count, wg_count);
+  ReadMatrix(ratings, header.cell_size, &tables->a);
+  tables->b = Matrix(wg_count, person_count);
+  ReadMatrix(ratings + table_size, header.cell_size, &tables->b);
+
+  return true;
+}
+
+// Writes |tables| into a temporary file next to |path| and moves it there,
+// so readers never see a partial file.
+bool WriteCache(const std::string& path,
+                uint64_t hash,
+                uint64_t size,
+                const InputTables& tables) {
+  std::string names;
+  for (const std::vector<std::string>* list : {&tables.wgs, &tables.persons}) {
+    for (const std::string& name : *list) {
+      uint32_t length = static_cast<uint32_t>(name.size());
+      names.append(reinterpret_cast<const char*>(&length), sizeof(length));
+      names.append(name);
+    }
+  }
+  names.resize(Padded(names.size()), '\0');
+
+  CacheHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kInputCacheVersion;
+  header.byte_order = kByteOrderMark;
+  header.content_hash = hash;
+  header.content_size = size;
+  header.wg_count = static_cast<uint32_t>(tables.wgs.size());
+  header.person_count = static_cast<uint32_t>(tables.persons.size());
+  header.cell_size = CellSize(tables.a, tables.b);
+  header.names_size = names.size();
+
+  std::string temporary = path + ".XXXXXX";
+  int fd = mkstemp(&temporary[0]);
+  if (fd < 0) return false;
+  FILE* file = fdopen(fd, "wb");
+  if (file == nullptr) {
+    close(fd);
+    unlink(temporary.c_str());
+    return false;
+  }
+
+  bool written =
+      std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+      std::fwrite(names.data(), 1, names.size(), file) == names.size() &&
+      WriteMatrix(file, tables.a, header.cell_size) &&
+      WriteMatrix(file, tables.b, header.cell_size);
+  written = std::fclose(file) == 0 && written;
+
+  if (!written || rename(temporary.c_str(), path.c_str()) != 0) {
+    unlink(temporary.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+uint64_t HashContent(const char* data, size_t size) {
+  uint64_t hash = Mix(size ^ kHashPrime1, kHashPrime2);
+
+  size_t k = 0;
+  for (; k + 16 <= size; k += 16) {
+    hash = Mix(Load64(data + k) ^ kHashPrime1, Load64(data + k + 8) ^ hash);
+  }
+
+  // the last bytes are padded with zeros, the size tells them apart
+  char tail[16] = {};
+  if (size > k) std::memcpy(tail, data + k, size - k);
+  hash = Mix(Load64(tail) ^ kHashPrime1, Load64(tail + 8) ^ hash);
+
+  return Mix(hash ^ kHashPrime3, size ^ kHashPrime2);
+}
+
+std::string DefaultInputCacheDirectory() {
+  const char* cache_home = std::getenv("XDG_CACHE_HOME");
+  if (cache_home != nullptr && cache_home[0] == '/') {
+    return std::string(cache_home) + "/belegium_matcher/inputs";
+  }
+
+  const char* home = std::getenv("HOME");
+  if (home != nullptr && home[0] == '/') {
+    return std::string(home) + "/.cache/belegium_matcher/inputs";
+  }
+
+  return "";
+}
+
+bool LoadInputFileCached(const std::string& path,
+                         const std::string& cache_directory,
+                         InputTables* tables,
+                         InputError* error,
+                         bool* cache_hit) {
+  if (cache_hit != nullptr) *cache_hit = false;
+
+  if (cache_directory.empty()) return LoadInputFile(path, tables, error);
+
+  // missing files are reported by the loader
+  MappedFile file(path);
+  if (!file.opened()) return LoadInputFile(path, tables, error);
+
+  uint64_t hash = HashContent(file.data(), file.size());
+  std::string cache_path = CachePath(cache_directory, hash);
+  if (ReadCache(cache_path, hash, file.size(), tables)) {
+    if (cache_hit != nullptr) *cache_hit = true;
+    return true;
+  }
+
+  // invalid files are not cached, their errors are reported on every load
+  if (!ParseInputFile(file.data(), file.size(), tables, error)) return false;
+
+  // the cache only saves time, the load succeeds even if it is not written
+  if (CreateDirectories(cache_directory)) {
+    WriteCache(cache_path, hash, file.size(), *tables);
+  }
+
+  return true;
+}
+
+}  // namespace belegium
@@ -0,0 +1,40 @@
+#ifndef BELEGIUM_CORE_INPUT_CACHE_H_
+#define BELEGIUM_CORE_INPUT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "input_file.h"
+
+namespace belegium {
+
+// Version of the cache file format. Files of other versions are ignored and
+// replaced, so it has to be increased with every change of the format or of
+// the parsed result.
+constexpr uint32_t kInputCacheVersion = 1;
+
+// Returns a 64 bit hash of the |size| bytes at |data|.
+uint64_t HashContent(const char* data, size_t size);
+
+// Returns the directory of the input cache of the user,
+// $XDG_CACHE_HOME/belegium_matcher/inputs or ~/.cache/belegium_matcher/inputs,
+// empty if neither is known.
+std::string DefaultInputCacheDirectory();
+
+// Same as LoadInputFile, but the tables of valid files are kept in
+// |cache_directory|, which is created if needed. Each cache file is named
+// after the hash of the csv content and holds the sorted headers and both
+// matrices in a binary format that is memory mapped and copied without
+// parsing. Cache files of another version, size or hash are rebuilt. An empty
+// |cache_directory| disables the cache. If |cache_hit| is not null, it is set
+// to whether the tables were read from the cache.
+bool LoadInputFileCached(const std::string& path,
+                         const std::string& cache_directory,
+                         InputTables* tables,
+                         InputError* error,
+                         bool* cache_hit = nullptr);
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_INPUT_CACHE_H_
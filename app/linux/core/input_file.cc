@@ -0,0 +1,545 @@
+#include "input_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#include "mapped_file.h"
+
+namespace belegium {
+
+namespace {
+
+// Entry of the table, points into the mapped file.
+struct Cell {
+  const char* begin;
+  const char* end;
+
+  bool empty() const { return begin == end; }
+  size_t size() const { return static_cast<size_t>(end - begin); }
+
+  std::string str() const { return std::string(begin, end); }
+};
+
+bool operator==(const Cell& a, const Cell& b) {
+  return a.size() == b.size() && std::memcmp(a.begin, b.begin, a.size()) == 0;
+}
+
+// Returns the position of the code point starting at |c| in the UTF-16 order
+// of String.compareTo, or -1 if |c| starts no valid UTF-8 sequence. Code points
+// above U+FFFF are surrogate pairs in UTF-16 and sort before U+E000..U+FFFF.
+int32_t Utf16Rank(const unsigned char* c, const unsigned char* end) {
+  int length = 0;
+  if (*c < 0x80) {
+    length = 1;
+  } else if (*c >= 0xc2 && *c < 0xe0) {
+    length = 2;
+  } else if (*c >= 0xe0 && *c < 0xf0) {
+    length = 3;
+  } else if (*c >= 0xf0 && *c < 0xf5) {
+    length = 4;
+  }
+  if (length == 0 || end - c < length) return -1;
+
+  int32_t code_point = length == 1 ? *c : *c & (0x7f >> length);
+  for (int k = 1; k < length; k++) {
+    if ((c[k] & 0xc0) != 0x80) return -1;
+    code_point = (code_point << 6) | (c[k] & 0x3f);
+  }
+
+  if (code_point >= 0xe000 && code_point <= 0xffff) code_point += 0x100000;
+  return code_point;
+}
+
+// Orders names like String.compareTo of the Dart code, by UTF-16 code units
+// instead of UTF-8 bytes. Invalid UTF-8 falls back to the byte order.
+bool operator<(const Cell& a, const Cell& b) {
+  const unsigned char* x = reinterpret_cast<const unsigned char*>(a.begin);
+  const unsigned char* y = reinterpret_cast<const unsigned char*>(b.begin);
+  const unsigned char* x_end = reinterpret_cast<const unsigned char*>(a.end);
+  const unsigned char* y_end = reinterpret_cast<const unsigned char*>(b.end);
+
+  auto mismatch = std::mismatch(x, x + std::min(a.size(), b.size()), y);
+  if (mismatch.first == x + std::min(a.size(), b.size())) {
+    return a.size() < b.size();
+  }
+
+  // compare the code points containing the first differing byte
+  size_t k = mismatch.first - x;
+  while (k > 0 && (x[k] & 0xc0) == 0x80) k--;
+  int32_t x_rank = Utf16Rank(x + k, x_end);
+  int32_t y_rank = Utf16Rank(y + k, y_end);
+  if (x_rank < 0 || y_rank < 0) return *mismatch.first < *mismatch.second;
+
+  return x_rank < y_rank;
+}
+
+// Rows of cells stored back to back, the i-th row is
+// cells[row_begin[i] .. row_begin[i + 1]).
+struct Table {
+  std::vector<Cell> cells;
+  std::vector<size_t> row_begin = {0};
+
+  int rows() const { return static_cast<int>(row_begin.size()) - 1; }
+  int columns(int row) const {
+    return static_cast<int>(row_begin[row + 1] - row_begin[row]);
+  }
+  const Cell& at(int row, int column) const {
+    return cells[row_begin[row] + column];
+  }
+};
+
+// One of the two tables of the file, a range of rows of the whole table.
+struct TableRange {
+  const Table* table;
+
+  // index of the header row in the whole table
+  int first_row;
+
+  // number of rows including the header
+  int rows;
+
+  int columns(int row) const { return table->columns(first_row + row); }
+  const Cell& at(int row, int column) const {
+    return table->at(first_row + row, column);
+  }
+};
+
+// Sets |error| to |message| without a position.
+bool Fail(InputError* error, const std::string& message) {
+  error->message = message;
+  error->has_position = false;
+  return false;
+}
+
+// Sets |error| to |message| at the given position.
+bool Fail(InputError* error,
+          const std::string& message,
+          int row,
+          int column,
+          int row_offset = -1) {
+  error->message = message;
+  error->has_position = true;
+  error->position.row = row;
+  error->position.column = column;
+  error->position.row_offset = row_offset;
+  return false;
+}
+
+// Splits the mapped |data| into lines and cells, mirrors _splitTable. Lines
+// without any content are kept as separator, lines without characters are
+// skipped. The index of the separator line is stored in |split_position|.
+bool SplitTable(const char* data,
+                size_t size,
+                char delimiter,
+                Table* table,
+                int* split_position,
+                InputError* error) {
+  int empty_count = 0;
+  *split_position = -1;
+
+  const char* end = data + size;
+  for (const char* line = data; line < end;) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if (line_end == nullptr) line_end = end;
+    const char* next = line_end + 1;
+
+    // carriage returns are ignored
+    while (line_end > line && line_end[-1] == '\r') line_end--;
+
+    // skip empty lines
+    if (line_end == line) {
+      line = next;
+      continue;
+    }
+
+    size_t row_start = table->cells.size();
+    bool empty = true;
+    for (const char* cell = line;;) {
+      const char* cell_end = static_cast<const char*>(
+          std::memchr(cell, delimiter, line_end - cell));
+      if (cell_end == nullptr) cell_end = line_end;
+
+      table->cells.push_back({cell, cell_end});
+      if (cell_end != cell) empty = false;
+
+      if (cell_end == line_end) break;
+      cell = cell_end + 1;
+    }
+
+    if (!empty) {
+      // strip empty entries from the line end, the first entry may be empty
+      size_t stripped = row_start + 1;
+      while (stripped < table->cells.size() &&
+             !table->cells[stripped].empty()) {
+        stripped++;
+      }
+      table->cells.resize(stripped);
+    } else {
+      empty_count++;
+      if (*split_position == -1) *split_position = table->rows();
+
+      if (empty_count > 1) {
+        return Fail(error, "Multiple empty lines detected", table->rows(), -1);
+      }
+    }
+
+    table->row_begin.push_back(table->cells.size());
+    line = next;
+  }
+
+  if (empty_count == 0) {
+    return Fail(error, "No empty line detected", table->rows() - 1, -1);
+  }
+
+  return true;
+}
+
+// Extracts the names from the header of |range|, mirrors
+// _getNamesFromTableHeader.
+bool NamesFromHeader(const TableRange& range,
+                     std::vector<Cell>* names,
+                     InputError* error) {
+  names->clear();
+
+  int columns = range.columns(0);
+  for (int i = 1; i < columns && !range.at(0, i).empty(); i++) {
+    names->push_back(range.at(0, i));
+  }
+
+  // prevent multiple identical names, report the first one
+  std::vector<Cell> sorted = *names;
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end() ||
+      (range.at(0, 0).size() > 0 &&
+       std::binary_search(sorted.begin(), sorted.end(), range.at(0, 0)))) {
+    for (size_t i = 0; i < names->size(); i++) {
+      const Cell& name = (*names)[i];
+      int count = range.at(0, 0) == name ? 1 : 0;
+      auto equal = std::equal_range(sorted.begin(), sorted.end(), name);
+      count += static_cast<int>(equal.second - equal.first);
+      if (count > 1) {
+        return Fail(error, "Name duplicate found", range.first_row,
+                    static_cast<int>(i) + 1);
+      }
+    }
+  }
+
+  if (names->empty()) {
+    return Fail(error, "No names found in header", range.first_row, -1);
+  }
+
+  return true;
+}
+
+// Collects the row names of |range| and sorts rows and columns by name,
+// mirrors _sortedTable. |row_order| and |column_order| list the original
+// index of each sorted row and column.
+bool SortTable(const TableRange& range,
+               std::vector<Cell>* row_names,
+               std::vector<Cell>* column_names,
+               std::vector<int>* row_order,
+               std::vector<int>* column_order,
+               InputError* error) {
+  if (range.rows < 1) {
+    return Fail(error, "No names found in header", range.first_row, -1);
+  }
+
+  row_names->clear();
+  for (int i = 1; i < range.rows; i++) {
+    const Cell& name = range.at(i, 0);
+
+    // the name must not appear again in its own row
+    for (int j = 1; j < range.columns(i); j++) {
+      if (range.at(i, j) == name) {
+        return Fail(error, "Name duplicate found", range.first_row + i + 1, 0);
+      }
+    }
+
+    row_names->push_back(name);
+  }
+
+  if (!NamesFromHeader(range, column_names, error)) return false;
+
+  row_order->resize(row_names->size());
+  column_order->resize(column_names->size());
+  for (size_t i = 0; i < row_order->size(); i++) (*row_order)[i] = i;
+  for (size_t j = 0; j < column_order->size(); j++) (*column_order)[j] = j;
+
+  std::stable_sort(row_order->begin(), row_order->end(), [&](int x, int y) {
+    return (*row_names)[x] < (*row_names)[y];
+  });
+  std::stable_sort(column_order->begin(), column_order->end(),
+                   [&](int x, int y) {
+                     return (*column_names)[x] < (*column_names)[y];
+                   });
+
+  // reordering the columns requires every row to be complete
+  if (!std::is_sorted(column_order->begin(), column_order->end())) {
+    int columns = static_cast<int>(column_names->size()) + 1;
+    for (int row : *row_order) {
+      if (range.columns(row + 1) < columns) {
+        return Fail(error, "Dimension missmatch detected",
+                    range.first_row + row + 1, -1);
+      }
+    }
+  }
+
+  return true;
+}
+
+// Verifies the row names of one table match the column names of the other,
+// mirrors _checkTableHeader. Both name lists must be sorted.
+bool CheckTableHeader(const std::vector<Cell>& row_names,
+                      const std::vector<Cell>& other_names,
+                      int table_error_offset,
+                      int column_header_error_offset,
+                      InputError* error) {
+  if (row_names.size() != other_names.size()) {
+    if (table_error_offset > column_header_error_offset) {
+      return Fail(error, "Dimension missmatch detected", -1, 0,
+                  table_error_offset);
+    }
+    return Fail(error, "Dimension missmatch detected",
+                column_header_error_offset, -1);
+  }
+
+  for (size_t i = 0; i < row_names.size(); i++) {
+    if (!std::binary_search(other_names.begin(), other_names.end(),
+                            row_names[i])) {
+      return Fail(error, "Name is missing: " + row_names[i].str());
+    }
+
+    if (!std::binary_search(row_names.begin(), row_names.end(),
+                            other_names[i])) {
+      return Fail(error, "Name is missing: " + other_names[i].str());
+    }
+  }
+
+  return true;
+}
+
+// UTF-8 encodings of the whitespace removed by String.trim besides ASCII.
+const char* const kUnicodeSpaces[] = {
+    "\xc2\x85",     "\xc2\xa0",     "\xe1\x9a\x80", "\xe2\x80\x80",
+    "\xe2\x80\x81", "\xe2\x80\x82", "\xe2\x80\x83", "\xe2\x80\x84",
+    "\xe2\x80\x85", "\xe2\x80\x86", "\xe2\x80\x87", "\xe2\x80\x88",
+    "\xe2\x80\x89", "\xe2\x80\x8a", "\xe2\x80\xa8", "\xe2\x80\xa9",
+    "\xe2\x80\xaf", "\xe2\x81\x9f", "\xe3\x80\x80", "\xef\xbb\xbf",
+};
+
+// Returns the length of the whitespace starting at |c|, 0 if there is none.
+size_t LeadingSpace(const char* c, const char* end) {
+  if (c == end) return 0;
+  if (*c == ' ' || (*c >= '\t' && *c <= '\r')) return 1;
+
+  for (const char* space : kUnicodeSpaces) {
+    size_t length = std::strlen(space);
+    if (static_cast<size_t>(end - c) >= length &&
+        std::memcmp(c, space, length) == 0) {
+      return length;
+    }
+  }
+  return 0;
+}
+
+// Returns the length of the whitespace ending at |end|, 0 if there is none.
+size_t TrailingSpace(const char* begin, const char* end) {
+  if (begin == end) return 0;
+  if (end[-1] == ' ' || (end[-1] >= '\t' && end[-1] <= '\r')) return 1;
+
+  for (const char* space : kUnicodeSpaces) {
+    size_t length = std::strlen(space);
+    if (static_cast<size_t>(end - begin) >= length &&
+        std::memcmp(end - length, space, length) == 0) {
+      return length;
+    }
+  }
+  return 0;
+}
+
+// Returns the value of the hexadecimal digit |c|, -1 if it is none.
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Parses a cell the way int.parse does: whitespace is trimmed, a sign is
+// optional and "0x" starts a hexadecimal number. Like the Dart VM, decimal
+// numbers must fit into 64 bits and hexadecimal ones are read as unsigned
+// 64 bit numbers, e.g. 0xffffffffffffffff is -1.
+bool ParseInt(const Cell& cell, int64_t* value) {
+  const char* c = cell.begin;
+  const char* end = cell.end;
+
+  for (size_t space; (space = LeadingSpace(c, end)) > 0;) c += space;
+  for (size_t space; (space = TrailingSpace(c, end)) > 0;) end -= space;
+
+  bool negative = false;
+  if (c < end && (*c == '-' || *c == '+')) {
+    negative = *c == '-';
+    c++;
+  }
+
+  bool hex = end - c > 2 && c[0] == '0' && (c[1] == 'x' || c[1] == 'X');
+  if (hex) c += 2;
+
+  int base = hex ? 16 : 10;
+  uint64_t limit = hex ? std::numeric_limits<uint64_t>::max()
+                       : static_cast<uint64_t>(
+                             std::numeric_limits<int64_t>::max()) +
+                             (negative ? 1 : 0);
+  if (c == end) return false;
+
+  uint64_t magnitude = 0;
+  for (; c < end; c++) {
+    int digit = HexDigit(*c);
+    if (digit < 0 || digit >= base ||
+        magnitude > (limit - static_cast<uint64_t>(digit)) / base) {
+      return false;
+    }
+    magnitude = magnitude * base + static_cast<uint64_t>(digit);
+  }
+
+  // two's complement wraps the unsigned hexadecimal values like the VM does
+  *value = static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+  return true;
+}
+
+// Parses the cells of |range| in sorted order directly into |matrix|.
+bool ParseTable(const TableRange& range,
+                const std::vector<int>& row_order,
+                const std::vector<int>& column_order,
+                Matrix* matrix,
+                InputError* error) {
+  int m = static_cast<int>(row_order.size());
+  int n = static_cast<int>(column_order.size());
+  *matrix = Matrix(m, n);
+
+  for (int i = 0; i < m; i++) {
+    int row = row_order[i] + 1;
+    int columns = range.columns(row);
+    int64_t* target = (*matrix)[i];
+
+    for (int j = 0; j < n; j++) {
+      int column = column_order[j] + 1;
+      if (column >= columns || !ParseInt(range.at(row, column), &target[j])) {
+        return Fail(error, "Invalid number", range.first_row + row, column);
+      }
+    }
+  }
+
+  return true;
+}
+
+// Returns the sorted copies of |names|.
+std::vector<Cell> Sorted(const std::vector<Cell>& names,
+                         const std::vector<int>& order) {
+  std::vector<Cell> sorted;
+  sorted.reserve(order.size());
+  for (int index : order) sorted.push_back(names[index]);
+  return sorted;
+}
+
+}  // namespace
+
+bool LoadInputFile(const std::string& path,
+                   InputTables* tables,
+                   InputError* error) {
+  MappedFile file(path);
+  if (!file.opened()) {
+    return Fail(error, "File not found: " + path);
+  }
+
+  return ParseInputFile(file.data(), file.size(), tables, error);
+}
+
+bool ParseInputFile(const char* data,
+                    size_t size,
+                    InputTables* tables,
+                    InputError* error) {
+  // count lines, delimiter candidates and carriage returns inside of lines in
+  // one pass
+  size_t newlines = 0;
+  size_t semicolons = 0;
+  size_t commas = 0;
+  size_t carriage_returns = 0;
+  for (size_t k = 0; k < size; k++) {
+    newlines += data[k] == '\n';
+    semicolons += data[k] == ';';
+    commas += data[k] == ',';
+    carriage_returns += data[k] == '\r' && k + 1 < size &&
+                        data[k + 1] != '\n' && data[k + 1] != '\r';
+  }
+
+  if (newlines < 4) {
+    return Fail(error, "Multiple lines required");
+  }
+
+  // line ends are handled while splitting, other carriage returns have to be
+  // removed first as InputFile ignores them
+  std::string content;
+  if (carriage_returns > 0) {
+    content.reserve(size);
+    std::remove_copy(data, data + size, std::back_inserter(content), '\r');
+    data = content.data();
+    size = content.size();
+  }
+
+  // every delimiter and line end closes one cell
+  char delimiter = semicolons > commas ? ';' : ',';
+  Table table;
+  table.cells.reserve((delimiter == ';' ? semicolons : commas) + newlines + 1);
+  table.row_begin.reserve(newlines + 2);
+  int split_position = 0;
+  if (!SplitTable(data, size, delimiter, &table, &split_position, error)) {
+    return false;
+  }
+
+  // the second table starts after the first one and the empty line
+  TableRange first = {&table, 0, split_position};
+  TableRange second = {&table, split_position + 1,
+                       table.rows() - split_position - 1};
+
+  std::vector<Cell> first_rows;
+  std::vector<Cell> first_columns;
+  std::vector<int> first_row_order;
+  std::vector<int> first_column_order;
+  std::vector<Cell> second_rows;
+  std::vector<Cell> second_columns;
+  std::vector<int> second_row_order;
+  std::vector<int> second_column_order;
+
+  if (!SortTable(first, &first_rows, &first_columns, &first_row_order,
+                 &first_column_order, error) ||
+      !SortTable(second, &second_rows, &second_columns, &second_row_order,
+                 &second_column_order, error)) {
+    return false;
+  }
+
+  std::vector<Cell> wgs = Sorted(first_columns, first_column_order);
+  std::vector<Cell> persons = Sorted(second_columns, second_column_order);
+
+  if (!CheckTableHeader(Sorted(first_rows, first_row_order), persons, 0,
+                        second.first_row, error) ||
+      !CheckTableHeader(Sorted(second_rows, second_row_order), wgs,
+                        second.first_row, 0, error)) {
+    return false;
+  }
+
+  tables->wgs.clear();
+  tables->persons.clear();
+  for (const Cell& name : wgs) tables->wgs.push_back(name.str());
+  for (const Cell& name : persons) tables->persons.push_back(name.str());
+
+  return ParseTable(first, first_row_order, first_column_order, &tables->a,
+                    error) &&
+         ParseTable(second, second_row_order, second_column_order, &tables->b,
+                    error);
+}
+
+}  // namespace belegium
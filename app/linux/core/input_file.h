@@ -0,0 +1,62 @@
+#ifndef BELEGIUM_CORE_INPUT_FILE_H_
+#define BELEGIUM_CORE_INPUT_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "matrix.h"
+
+namespace belegium {
+
+// Position of an input error, mirrors TablePosition of the Dart code. Unset
+// members are -1: a position can be a full row, a full column or a cell.
+struct TablePosition {
+  int row = -1;
+  int column = -1;
+  int row_offset = -1;
+};
+
+// Details of a failed load.
+struct InputError {
+  std::string message;
+
+  // true if |position| points into the table
+  bool has_position = false;
+  TablePosition position;
+};
+
+// Both rating tables of an input file with their rows and columns sorted by
+// name, so the rows of |a| line up with the columns of |b| and vice versa.
+struct InputTables {
+  // names in the header of the first table (columns of |a|, rows of |b|)
+  std::vector<std::string> wgs;
+
+  // names in the header of the second table (rows of |a|, columns of |b|)
+  std::vector<std::string> persons;
+
+  // ratings of the first table (persons x wgs)
+  Matrix a;
+
+  // ratings of the second table (wgs x persons)
+  Matrix b;
+};
+
+// Loads the two-table csv file at |path| in the format accepted by InputFile
+// of the Dart code. Returns false and fills |error| if the file is invalid.
+// Ratings are parsed like int.parse, including surrounding whitespace and
+// "0x" hexadecimal numbers, and names are sorted like String.compareTo by
+// their UTF-16 code units, not by their UTF-8 bytes.
+bool LoadInputFile(const std::string& path,
+                   InputTables* tables,
+                   InputError* error);
+
+// Same as LoadInputFile for the |size| bytes of file content at |data|.
+bool ParseInputFile(const char* data,
+                    size_t size,
+                    InputTables* tables,
+                    InputError* error);
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_INPUT_FILE_H_
@@ -0,0 +1,30 @@
+#include "input_preload.h"
+
+#include <utility>
+
+#include "input_cache.h"
+
+namespace belegium {
+
+InputPreload::InputPreload(std::string path, std::string cache_directory)
+    : path_(std::move(path)), cache_directory_(std::move(cache_directory)) {
+  thread_ = std::thread(&InputPreload::Run, this);
+}
+
+InputPreload::~InputPreload() {
+  if (thread_.joinable()) thread_.join();
+}
+
+bool InputPreload::Take(InputTables* tables, InputError* error) {
+  if (thread_.joinable()) thread_.join();
+
+  *tables = std::move(tables_);
+  *error = std::move(error_);
+  return loaded_;
+}
+
+void InputPreload::Run() {
+  loaded_ = LoadInputFileCached(path_, cache_directory_, &tables_, &error_);
+}
+
+}  // namespace belegium
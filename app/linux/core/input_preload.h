@@ -0,0 +1,50 @@
+#ifndef BELEGIUM_CORE_INPUT_PRELOAD_H_
+#define BELEGIUM_CORE_INPUT_PRELOAD_H_
+
+#include <string>
+#include <thread>
+
+#include "input_file.h"
+
+namespace belegium {
+
+// Loads an input file on a thread of its own, e.g. while the GUI and its
+// engine start, so the tables are ready once they are needed instead of only
+// being loaded then.
+class InputPreload {
+ public:
+  // Starts loading |path| with LoadInputFileCached and |cache_directory|.
+  InputPreload(std::string path, std::string cache_directory);
+
+  // Joins the thread of the load.
+  ~InputPreload();
+
+  InputPreload(const InputPreload&) = delete;
+  InputPreload& operator=(const InputPreload&) = delete;
+
+  // Path the load was started with.
+  const std::string& path() const { return path_; }
+
+  // Blocks until the load finished and moves its result into |tables| and
+  // |error|. Returns whether the file was loaded, see LoadInputFile. May only
+  // be called once.
+  bool Take(InputTables* tables, InputError* error);
+
+ private:
+  // Main function of the thread of the load.
+  void Run();
+
+  std::string path_;
+  std::string cache_directory_;
+
+  bool loaded_ = false;
+  InputTables tables_;
+  InputError error_;
+
+  // started last, after all members it reads
+  std::thread thread_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_INPUT_PRELOAD_H_
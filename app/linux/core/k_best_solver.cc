@@ -0,0 +1,277 @@
+#include "k_best_solver.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "lap_solver.h"
+#include "simd_kernels.h"
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+// minimal number of subproblems searched by one task, fewer are not worth
+// waking up the workers
+constexpr int kMinSearchesPerTask = 8;
+
+}  // namespace
+
+KBestSolver::KBestSolver(int thread_count) {
+  if (thread_count < 1) thread_count = ThreadPool::HardwareThreads();
+  if (thread_count > 1) pool_.reset(new ThreadPool(thread_count));
+  searches_.resize(thread_count);
+}
+
+template <typename Cost>
+void KBestSolver::Solve(const Cost* costs,
+                        int n,
+                        int stride,
+                        int k,
+                        int64_t max_gap,
+                        std::vector<RankedAssignment>* results) {
+  results->clear();
+  nodes_.clear();
+  candidates_.clear();
+  sequence_ = 0;
+  stats_ = SolverStats();
+
+  if (n < 1 || k < 1) return;
+
+  // the optimum is the root of the partitioning, its duals are inherited by
+  // all subproblems
+  Node root;
+  root.row_to_col.resize(n);
+  LapSolver solver;
+  root.cost = solver.Solve(costs, n, stride, root.row_to_col.data());
+  root.col_to_row.resize(n);
+  for (int i = 0; i < n; ++i) root.col_to_row[root.row_to_col[i]] = i;
+  root.u = solver.row_potentials();
+  root.v = solver.column_potentials();
+  root.fixed.assign(n, 0);
+  stats_ = solver.stats();
+
+  int64_t bound = kInfinity;
+  if (max_gap >= 0) bound = root.cost + std::min(max_gap, kInfinity);
+
+  nodes_.push_back(std::move(root));
+  results->push_back({nodes_.back().row_to_col, nodes_.back().cost});
+  remaining_ = k - 1;
+
+  while (remaining_ > 0) {
+    Split(costs, n, stride, static_cast<int>(nodes_.size()) - 1, bound);
+    if (candidates_.empty()) break;
+
+    Candidate next = *candidates_.begin();
+    candidates_.erase(candidates_.begin());
+    remaining_--;
+
+    Expand(costs, n, stride, next);
+    results->push_back({nodes_.back().row_to_col, nodes_.back().cost});
+  }
+}
+
+template <typename Cost>
+int64_t KBestSolver::SearchPath(const Cost* costs,
+                                int n,
+                                int stride,
+                                const Node& parent,
+                                int row,
+                                int64_t limit,
+                                Search* search) const {
+  search->distance.assign(n, kInfinity);
+  search->predecessor.assign(n, -1);
+  search->visited.assign(n, 0);
+  search->visited_cols.clear();
+
+  // the columns of fixed rows are out of reach, the column of |row| is the
+  // only free one and ends the path
+  for (int i = 0; i < n; ++i) {
+    if (parent.fixed[i] || i < row) search->visited[parent.row_to_col[i]] = 1;
+  }
+  int sink = parent.row_to_col[row];
+
+  int current = row;
+  int64_t base = 0;
+  for (;;) {
+    // forbidden cells are hidden from the relaxation
+    auto first = std::lower_bound(
+        parent.forbidden.begin(), parent.forbidden.end(),
+        std::make_pair(static_cast<int32_t>(current),
+                       std::numeric_limits<int32_t>::min()));
+    auto last = first;
+    while (last != parent.forbidden.end() && last->first == current) {
+      search->visited[last->second] |= 2;
+      ++last;
+    }
+    if (current == row) search->visited[sink] |= 2;
+
+    // the reduced costs are offset by the distance of |current|, so the
+    // slacks are the distances from |row|
+    const Cost* cost_row = costs + static_cast<int64_t>(current) * stride;
+    int32_t next_col = -1;
+    int64_t distance = RelaxRow(
+        cost_row, n, parent.u[current] - base, parent.v.data(),
+        search->visited.data(), current, search->distance.data(),
+        search->predecessor.data(), &next_col);
+
+    for (auto it = first; it != last; ++it) search->visited[it->second] &= 1;
+    if (current == row) search->visited[sink] &= 1;
+
+    if (next_col == -1 || distance >= kInfinity || distance > limit) {
+      search->scanned += static_cast<int64_t>(search->visited_cols.size());
+      return -1;
+    }
+
+    search->visited[next_col] = 1;
+    search->visited_cols.push_back(next_col);
+
+    if (next_col == sink) {
+      search->scanned += static_cast<int64_t>(search->visited_cols.size());
+      return distance;
+    }
+
+    current = parent.col_to_row[next_col];
+    base = distance;
+  }
+}
+
+template <typename Cost>
+void KBestSolver::Split(const Cost* costs,
+                        int n,
+                        int stride,
+                        int index,
+                        int64_t bound) {
+  const Node& parent = nodes_[index];
+
+  // a subproblem is only queued if it can still be reported
+  int64_t limit = bound;
+  if (static_cast<int>(candidates_.size()) >= remaining_) {
+    limit = std::min(limit, std::prev(candidates_.end())->cost - 1);
+  }
+  if (limit < parent.cost) return;
+
+  // with all other free rows fixed, the last free row has no column left
+  std::vector<int32_t> rows;
+  for (int i = 0; i < n; ++i) {
+    if (!parent.fixed[i]) rows.push_back(i);
+  }
+  if (!rows.empty()) rows.pop_back();
+
+  int count = static_cast<int>(rows.size());
+  std::vector<int64_t> increases(count, -1);
+
+  auto search_range = [&](int task, int tasks) {
+    int worker = ThreadPool::WorkerIndex(pool_.get());
+    for (int p = task; p < count; p += tasks) {
+      increases[p] = SearchPath(costs, n, stride, parent, rows[p],
+                                limit - parent.cost, &searches_[worker]);
+    }
+  };
+
+  int tasks = 1;
+  if (pool_) {
+    tasks = std::min(pool_->size(), count / kMinSearchesPerTask);
+  }
+  if (tasks > 1) {
+    // the subproblems are interleaved, later rows have more fixed rows and
+    // search faster
+    for (int task = 0; task < tasks; ++task) {
+      pool_->Submit([&search_range, task, tasks] {
+        search_range(task, tasks);
+      });
+    }
+    pool_->Wait();
+  } else {
+    search_range(0, 1);
+  }
+
+  stats_.augmentations += count;
+  for (Search& search : searches_) {
+    stats_.scanned += search.scanned;
+    search.scanned = 0;
+  }
+
+  // queued in row order, so ties are ordered independent of the threads
+  for (int p = 0; p < count; ++p) {
+    if (increases[p] < 0) continue;
+
+    candidates_.insert({parent.cost + increases[p], sequence_++, index,
+                        rows[p]});
+    if (static_cast<int>(candidates_.size()) > remaining_) {
+      candidates_.erase(std::prev(candidates_.end()));
+    }
+  }
+}
+
+template <typename Cost>
+void KBestSolver::Expand(const Cost* costs,
+                         int n,
+                         int stride,
+                         const Candidate& candidate) {
+  Node node = nodes_[candidate.parent];
+  int row = candidate.row;
+  Search& search = searches_[0];
+
+  int64_t increase =
+      SearchPath(costs, n, stride, node, row, kInfinity, &search);
+  stats_.augmentations++;
+  stats_.scanned += search.scanned;
+  stats_.dual_updates++;
+  search.scanned = 0;
+
+  int sink = node.row_to_col[row];
+  for (int i = 0; i < row; ++i) node.fixed[i] = 1;
+  node.forbidden.insert(
+      std::upper_bound(node.forbidden.begin(), node.forbidden.end(),
+                       std::make_pair(static_cast<int32_t>(row),
+                                      static_cast<int32_t>(sink))),
+      std::make_pair(static_cast<int32_t>(row), static_cast<int32_t>(sink)));
+
+  // shift the duals so the path becomes tight, like a single augmentation of
+  // the Jonker-Volgenant solver
+  node.u[row] += increase;
+  for (int32_t j : search.visited_cols) {
+    if (j == sink) continue;
+    int64_t shift = increase - search.distance[j];
+    node.u[node.col_to_row[j]] += shift;
+    node.v[j] -= shift;
+  }
+
+  // flip the matching along the path back to |row|
+  for (int j = sink;;) {
+    int i = search.predecessor[j];
+    int next = node.row_to_col[i];
+    node.row_to_col[i] = j;
+    node.col_to_row[j] = i;
+    stats_.path_length++;
+    if (i == row) break;
+    j = next;
+  }
+
+  node.cost += increase;
+  nodes_.push_back(std::move(node));
+}
+
+template void KBestSolver::Solve<int16_t>(const int16_t*,
+                                          int,
+                                          int,
+                                          int,
+                                          int64_t,
+                                          std::vector<RankedAssignment>*);
+template void KBestSolver::Solve<int32_t>(const int32_t*,
+                                          int,
+                                          int,
+                                          int,
+                                          int64_t,
+                                          std::vector<RankedAssignment>*);
+template void KBestSolver::Solve<int64_t>(const int64_t*,
+                                          int,
+                                          int,
+                                          int,
+                                          int64_t,
+                                          std::vector<RankedAssignment>*);
+
+}  // namespace belegium
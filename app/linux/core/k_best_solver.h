@@ -0,0 +1,143 @@
+#ifndef BELEGIUM_CORE_K_BEST_SOLVER_H_
+#define BELEGIUM_CORE_K_BEST_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "solver_stats.h"
+#include "thread_pool.h"
+
+namespace belegium {
+
+// One assignment found by KBestSolver.
+struct RankedAssignment {
+  std::vector<int32_t> row_to_col;
+  int64_t cost = 0;
+};
+
+// Finds the k cheapest assignments of a dense square linear assignment problem
+// (minimization) with the partitioning of Murty.
+//
+// After an assignment is reported, the remaining assignments of its
+// subproblem are split into disjoint subproblems: the i-th one keeps the
+// assigned pairs of the first i - 1 free rows fixed and forbids the pair of
+// the i-th free row. Each subproblem inherits the optimal duals of its
+// parent, which stay feasible, so its optimum is found by a single shortest
+// path search from the row that lost its pair. The searches of all
+// subproblems of a parent are independent and are split among the threads.
+// Only the cost and the origin of a subproblem are queued, its assignment is
+// rebuilt when it is reported, and subproblems that cannot be among the k
+// cheapest are dropped or stop their search early.
+class KBestSolver {
+ public:
+  // Searches with |thread_count| threads, one per hardware thread if it is
+  // < 1.
+  explicit KBestSolver(int thread_count = 1);
+
+  // Writes the up to |k| cheapest assignments of the n x n problem whose rows
+  // are |stride| cells apart into |results|, ordered by cost. If |max_gap| is
+  // not negative, only assignments costing at most the optimum plus
+  // |max_gap| are reported, so a gap of 0 enumerates the tied optima. Ties are
+  // ordered deterministically, independent of the number of threads.
+  // Instantiated for int16_t, int32_t and int64_t costs.
+  template <typename Cost>
+  void Solve(const Cost* costs,
+             int n,
+             int stride,
+             int k,
+             int64_t max_gap,
+             std::vector<RankedAssignment>* results);
+
+  // Work counters of the last solve, |augmentations| counts the shortest
+  // path searches and |scanned| the rows they relaxed.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Reported assignment with the state needed to split its subproblem.
+  struct Node {
+    int64_t cost = 0;
+
+    // optimal assignment and duals of the subproblem
+    std::vector<int32_t> row_to_col;
+    std::vector<int32_t> col_to_row;
+    std::vector<int64_t> u;
+    std::vector<int64_t> v;
+
+    // rows whose pair is fixed in the subproblem
+    std::vector<char> fixed;
+
+    // forbidden (row, column) pairs, sorted
+    std::vector<std::pair<int32_t, int32_t>> forbidden;
+  };
+
+  // Queued subproblem: the |row| of the reported node |parent| loses its pair,
+  // all free rows before it keep theirs.
+  struct Candidate {
+    int64_t cost;
+    int64_t sequence;
+    int parent;
+    int row;
+
+    bool operator<(const Candidate& other) const {
+      return cost != other.cost ? cost < other.cost
+                                : sequence < other.sequence;
+    }
+  };
+
+  // Buffers of one shortest path search.
+  struct Search {
+    std::vector<int64_t> distance;
+    std::vector<int32_t> predecessor;
+    std::vector<char> visited;
+    std::vector<int32_t> visited_cols;
+    int64_t scanned = 0;
+  };
+
+  // Searches the cheapest way to reassign |row| of |parent| in its subproblem
+  // without the pair of |row| and with all free rows before |row| fixed.
+  // Returns the increase of the cost, or -1 if it would exceed |limit| or the
+  // subproblem has no assignment. |search| holds the path afterwards.
+  template <typename Cost>
+  int64_t SearchPath(const Cost* costs,
+                     int n,
+                     int stride,
+                     const Node& parent,
+                     int row,
+                     int64_t limit,
+                     Search* search) const;
+
+  // Queues the subproblems of the reported node |index| whose cost is below
+  // the costs that can still be reported.
+  template <typename Cost>
+  void Split(const Cost* costs, int n, int stride, int index, int64_t bound);
+
+  // Builds the reported node of |candidate|.
+  template <typename Cost>
+  void Expand(const Cost* costs,
+              int n,
+              int stride,
+              const Candidate& candidate);
+
+  // pool to search the subproblems, null to search them on the caller
+  std::unique_ptr<ThreadPool> pool_;
+
+  // search buffers, one per worker
+  std::vector<Search> searches_;
+
+  // reported nodes and the subproblems that may still be reported
+  std::vector<Node> nodes_;
+  std::set<Candidate> candidates_;
+  int64_t sequence_ = 0;
+
+  // number of assignments that may still be reported
+  int remaining_ = 0;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_K_BEST_SOLVER_H_
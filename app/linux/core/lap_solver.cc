@@ -0,0 +1,290 @@
+#include "lap_solver.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "simd_kernels.h"
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+}  // namespace
+
+template <typename Cost>
+int64_t LapSolver::Solve(const Cost* costs,
+                         int n,
+                         int stride,
+                         int32_t* row_to_col) {
+  u_.assign(n, 0);
+  row_to_col_.assign(n, -1);
+  col_to_row_.assign(n, -1);
+  stats_ = SolverStats();
+
+  ReduceColumns(costs, n, stride);
+
+  return Finish(costs, n, n, stride, row_to_col);
+}
+
+template <typename Cost>
+int64_t LapSolver::SolveRectangular(const Cost* costs,
+                                    int m,
+                                    int n,
+                                    int stride,
+                                    int32_t* row_to_col) {
+  if (m > n) {
+    // the augmenting paths start at the smaller side, so the transposed
+    // problem is solved and its state turned back
+    std::vector<Cost> transposed(static_cast<size_t>(m) * n);
+    for (int i = 0; i < m; ++i) {
+      const Cost* row = costs + static_cast<int64_t>(i) * stride;
+      for (int j = 0; j < n; ++j) {
+        transposed[static_cast<int64_t>(j) * m + i] = row[j];
+      }
+    }
+
+    std::vector<int32_t> col_to_row(n);
+    int64_t total =
+        SolveRectangular(transposed.data(), n, m, m, col_to_row.data());
+    u_.swap(v_);
+    row_to_col_.swap(col_to_row_);
+    std::copy(row_to_col_.begin(), row_to_col_.end(), row_to_col);
+    return total;
+  }
+
+  u_.assign(m, 0);
+  row_to_col_.assign(m, -1);
+  col_to_row_.assign(n, -1);
+  stats_ = SolverStats();
+
+  ReduceRows(costs, m, n, stride);
+
+  return Finish(costs, m, n, stride, row_to_col);
+}
+
+template <typename Cost>
+int64_t LapSolver::Repair(const Cost* costs,
+                          int n,
+                          int stride,
+                          const std::vector<int32_t>& rows,
+                          const std::vector<int32_t>& columns,
+                          int32_t* row_to_col) {
+  if (size() != n) return Solve(costs, n, stride, row_to_col);
+
+  stats_ = SolverStats();
+
+  // free each row and lower its potential to its smallest reduced cost
+  for (int32_t i : rows) {
+    if (row_to_col_[i] != -1) {
+      col_to_row_[row_to_col_[i]] = -1;
+      row_to_col_[i] = -1;
+    }
+
+    const Cost* cost_row = costs + static_cast<int64_t>(i) * stride;
+    int64_t u = kInfinity;
+    for (int j = 0; j < n; ++j) {
+      u = std::min(u, static_cast<int64_t>(cost_row[j]) - v_[j]);
+    }
+    u_[i] = u;
+  }
+
+  // same for the columns, the row potentials are final at this point
+  for (int32_t j : columns) {
+    if (col_to_row_[j] != -1) {
+      row_to_col_[col_to_row_[j]] = -1;
+      col_to_row_[j] = -1;
+    }
+
+    int64_t v = kInfinity;
+    for (int i = 0; i < n; ++i) {
+      v = std::min(
+          v, static_cast<int64_t>(costs[static_cast<int64_t>(i) * stride + j]) -
+                 u_[i]);
+    }
+    v_[j] = v;
+  }
+
+  return Finish(costs, n, n, stride, row_to_col);
+}
+
+template <typename Cost>
+int64_t LapSolver::Finish(const Cost* costs,
+                          int m,
+                          int n,
+                          int stride,
+                          int32_t* row_to_col) {
+  cancelled_ = false;
+  for (int i = 0; i < m; ++i) {
+    if (row_to_col_[i] == -1) {
+      Augment(costs, n, stride, i);
+
+      if (progress_ && !ReportProgress()) {
+        cancelled_ = true;
+        break;
+      }
+    }
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < m; ++i) {
+    row_to_col[i] = row_to_col_[i];
+    if (row_to_col_[i] == -1) continue;
+    total += costs[static_cast<int64_t>(i) * stride + row_to_col_[i]];
+  }
+
+  return total;
+}
+
+bool LapSolver::ReportProgress() const {
+  int assigned = 0;
+  int64_t dual_objective = 0;
+  for (size_t i = 0; i < row_to_col_.size(); ++i) {
+    if (row_to_col_[i] != -1) assigned++;
+    dual_objective += u_[i];
+  }
+  for (int64_t v : v_) dual_objective += v;
+
+  return progress_(assigned, dual_objective);
+}
+
+template <typename Cost>
+void LapSolver::ReduceColumns(const Cost* costs, int n, int stride) {
+  // the minima are collected row by row to read the costs in memory order,
+  // the first row holding the minimum of a column is kept
+  v_.assign(n, kInfinity);
+  predecessor_.assign(n, -1);
+  for (int i = 0; i < n; ++i) {
+    ColumnMinima(costs + static_cast<int64_t>(i) * stride, n, i, v_.data(),
+                 predecessor_.data());
+  }
+
+  for (int j = 0; j < n; ++j) {
+    int min_row = predecessor_[j];
+
+    // the reduced cost of (min_row, j) is zero, so it may join the matching
+    if (row_to_col_[min_row] == -1) {
+      row_to_col_[min_row] = j;
+      col_to_row_[j] = min_row;
+    }
+  }
+}
+
+template <typename Cost>
+void LapSolver::ReduceRows(const Cost* costs, int m, int n, int stride) {
+  v_.assign(n, 0);
+  for (int i = 0; i < m; ++i) {
+    const Cost* cost_row = costs + static_cast<int64_t>(i) * stride;
+    int min_col = static_cast<int>(
+        std::min_element(cost_row, cost_row + n) - cost_row);
+    u_[i] = cost_row[min_col];
+
+    // the reduced cost of (i, min_col) is zero, so it may join the matching
+    if (col_to_row_[min_col] == -1) {
+      row_to_col_[i] = min_col;
+      col_to_row_[min_col] = i;
+    }
+  }
+}
+
+template <typename Cost>
+void LapSolver::Augment(const Cost* costs, int n, int stride, int row) {
+  min_slack_.assign(n, kInfinity);
+  predecessor_.assign(n, -1);
+  visited_.assign(n, 0);
+  visited_cols_.clear();
+
+  int current_row = row;
+  int sink = -1;
+
+  while (sink == -1) {
+    // relax all unvisited columns from the row reached last
+    const Cost* cost_row = costs + static_cast<int64_t>(current_row) * stride;
+    int32_t next_col = -1;
+    int64_t delta = RelaxRow(cost_row, n, u_[current_row], v_.data(),
+                             visited_.data(), current_row, min_slack_.data(),
+                             predecessor_.data(), &next_col);
+
+    // shift the duals so the closest column becomes tight
+    u_[row] += delta;
+    for (int32_t j : visited_cols_) {
+      u_[col_to_row_[j]] += delta;
+      v_[j] -= delta;
+    }
+    // the slacks of visited columns are not read again, so all are shifted
+    Kernels().subtract(min_slack_.data(), n, delta);
+
+    visited_[next_col] = 1;
+    visited_cols_.push_back(next_col);
+
+    if (col_to_row_[next_col] == -1) {
+      sink = next_col;
+    } else {
+      current_row = col_to_row_[next_col];
+    }
+  }
+
+  stats_.augmentations++;
+  stats_.scanned += static_cast<int64_t>(visited_cols_.size());
+  stats_.dual_updates += static_cast<int64_t>(visited_cols_.size());
+
+  // flip the matching along the path back to the start row
+  for (int j = sink;;) {
+    int i = predecessor_[j];
+    int next = row_to_col_[i];
+    row_to_col_[i] = j;
+    col_to_row_[j] = i;
+    stats_.path_length++;
+    if (i == row) break;
+    j = next;
+  }
+}
+
+template int64_t LapSolver::Solve<int16_t>(const int16_t*,
+                                          int,
+                                          int,
+                                          int32_t*);
+template int64_t LapSolver::Solve<int32_t>(const int32_t*,
+                                          int,
+                                          int,
+                                          int32_t*);
+template int64_t LapSolver::Solve<int64_t>(const int64_t*,
+                                          int,
+                                          int,
+                                          int32_t*);
+template int64_t LapSolver::SolveRectangular<int16_t>(const int16_t*,
+                                                     int,
+                                                     int,
+                                                     int,
+                                                     int32_t*);
+template int64_t LapSolver::SolveRectangular<int32_t>(const int32_t*,
+                                                     int,
+                                                     int,
+                                                     int,
+                                                     int32_t*);
+template int64_t LapSolver::SolveRectangular<int64_t>(const int64_t*,
+                                                     int,
+                                                     int,
+                                                     int,
+                                                     int32_t*);
+template int64_t LapSolver::Repair<int16_t>(const int16_t*,
+                                           int,
+                                           int,
+                                           const std::vector<int32_t>&,
+                                           const std::vector<int32_t>&,
+                                           int32_t*);
+template int64_t LapSolver::Repair<int32_t>(const int32_t*,
+                                           int,
+                                           int,
+                                           const std::vector<int32_t>&,
+                                           const std::vector<int32_t>&,
+                                           int32_t*);
+template int64_t LapSolver::Repair<int64_t>(const int64_t*,
+                                           int,
+                                           int,
+                                           const std::vector<int32_t>&,
+                                           const std::vector<int32_t>&,
+                                           int32_t*);
+
+}  // namespace belegium
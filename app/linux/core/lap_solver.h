@@ -0,0 +1,146 @@
+#ifndef BELEGIUM_CORE_LAP_SOLVER_H_
+#define BELEGIUM_CORE_LAP_SOLVER_H_
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "solver_stats.h"
+
+namespace belegium {
+
+// Solves dense square linear assignment problems (minimization) with the
+// shortest augmenting path method of Jonker and Volgenant in O(n^3).
+//
+// The solver keeps its work buffers between calls, so a single instance can
+// be reused for many problems without reallocating.
+class LapSolver {
+ public:
+  // Observer of a running solve, called with the number of assigned rows and
+  // the dual objective, the sum of all potentials. The dual objective never
+  // exceeds the optimal cost and rises to it. Returning false cancels the
+  // solve.
+  using Progress = std::function<bool(int assigned, int64_t dual_objective)>;
+
+  // Solves the n x n problem stored row-major in |costs| and writes the column
+  // assigned to each row into |row_to_col|. Returns the total cost.
+  int64_t Solve(const int64_t* costs, int n, int32_t* row_to_col) {
+    return Solve(costs, n, n, row_to_col);
+  }
+
+  // Same as above for rows that are |stride| cells apart, which allows solving
+  // views into larger matrices. Instantiated for int16_t, int32_t and int64_t
+  // costs.
+  template <typename Cost>
+  int64_t Solve(const Cost* costs, int n, int stride, int32_t* row_to_col);
+
+  // Solves the m x n problem whose rows are |stride| cells apart without
+  // padding it to a square one, which takes O(min(m, n)^2 * max(m, n)). Every
+  // row and column of the smaller side is assigned, rows left over get -1 in
+  // |row_to_col| (m entries). Instantiated for int16_t, int32_t and int64_t
+  // costs.
+  template <typename Cost>
+  int64_t SolveRectangular(const Cost* costs,
+                           int m,
+                           int n,
+                           int stride,
+                           int32_t* row_to_col);
+
+  // Re-solves the n x n problem of the last solve after the costs of some
+  // cells changed. Every changed cell must lie in one of |rows| or |columns|.
+  // Only those rows and columns are unassigned and their potentials lowered
+  // until the duals are feasible again, so just as many augmenting paths are
+  // searched. Instantiated for int16_t, int32_t and int64_t costs.
+  template <typename Cost>
+  int64_t Repair(const Cost* costs,
+                 int n,
+                 int stride,
+                 const std::vector<int32_t>& rows,
+                 const std::vector<int32_t>& columns,
+                 int32_t* row_to_col);
+
+  // Adds |delta| to all row potentials. The state of the last solve stays
+  // optimal if every cost changed by |delta|.
+  void ShiftPotentials(int64_t delta) {
+    for (int64_t& u : u_) u += delta;
+  }
+
+  // Sets the observer called after every augmenting path, none by default.
+  void set_progress(Progress progress) { progress_ = std::move(progress); }
+
+  // Whether the last solve was cancelled by its observer. Its assignment is
+  // incomplete then, unassigned rows are -1 and the returned cost only covers
+  // the assigned rows. The duals stay feasible, so a following Repair also
+  // assigns the remaining rows.
+  bool cancelled() const { return cancelled_; }
+
+  // Size of the square problem the state of the last solve belongs to, 0 if
+  // there was none or it was not square.
+  int size() const {
+    return row_to_col_.size() == col_to_row_.size()
+               ? static_cast<int>(row_to_col_.size())
+               : 0;
+  }
+
+  // Dual potentials of the last solve. For every cell the reduced cost
+  // costs[i][j] - row_potentials[i] - column_potentials[j] is non-negative and
+  // it is zero for all assigned cells.
+  const std::vector<int64_t>& row_potentials() const { return u_; }
+  const std::vector<int64_t>& column_potentials() const { return v_; }
+
+  // Work counters of the last solve.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Initializes the duals by column reduction and greedily assigns rows to
+  // free columns with a reduced cost of zero.
+  template <typename Cost>
+  void ReduceColumns(const Cost* costs, int n, int stride);
+
+  // Same as above by row reduction for m <= n rows, the column potentials
+  // start at 0. Free columns keep that potential, which keeps the solution
+  // of the rectangular problem optimal.
+  template <typename Cost>
+  void ReduceRows(const Cost* costs, int m, int n, int stride);
+
+  // Augments the matching along a shortest path starting at the free |row|
+  // through the n columns.
+  template <typename Cost>
+  void Augment(const Cost* costs, int n, int stride, int row);
+
+  // Augments all m free rows through the n columns and copies the assignment
+  // to |row_to_col|. Returns the total cost.
+  template <typename Cost>
+  int64_t Finish(const Cost* costs,
+                 int m,
+                 int n,
+                 int stride,
+                 int32_t* row_to_col);
+
+  // Calls the observer with the current state. Returns false to cancel.
+  bool ReportProgress() const;
+
+  // row and column potentials
+  std::vector<int64_t> u_;
+  std::vector<int64_t> v_;
+
+  // assignment in both directions, -1 if unassigned
+  std::vector<int32_t> row_to_col_;
+  std::vector<int32_t> col_to_row_;
+
+  // shortest path state
+  std::vector<int64_t> min_slack_;
+  std::vector<int32_t> predecessor_;
+  std::vector<char> visited_;
+  std::vector<int32_t> visited_cols_;
+
+  SolverStats stats_;
+
+  Progress progress_;
+  bool cancelled_ = false;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_LAP_SOLVER_H_
@@ -0,0 +1,58 @@
+#ifndef BELEGIUM_CORE_MAPPED_FILE_H_
+#define BELEGIUM_CORE_MAPPED_FILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <string>
+
+namespace belegium {
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+      opened_ = true;
+      size_ = static_cast<size_t>(info.st_size);
+      if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+          data_ = static_cast<const char*>(data);
+          madvise(data, size_, MADV_SEQUENTIAL);
+        } else {
+          opened_ = false;
+        }
+      }
+    }
+
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool opened() const { return opened_; }
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  bool opened_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_MAPPED_FILE_H_
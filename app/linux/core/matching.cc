@@ -0,0 +1,210 @@
+#include "matching.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "score_expression.h"
+#include "simd_kernels.h"
+
+namespace belegium {
+
+namespace {
+
+// cells copied at once by Transpose, a block of both matrices fits the cache
+constexpr int kTransposeBlock = 32;
+
+bool FitsSimdCombine(const Matrix& matrix) {
+  for (int64_t value : matrix.data) {
+    if (value <= -kMaxSimdCombineValue || value >= kMaxSimdCombineValue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Row loop of CombineRow specialized for one combination, so the switch of
+// Combine is resolved at compile time.
+template <Combination kCombination>
+void CombineRowWith(const int64_t* a,
+                    const int64_t* b,
+                    int64_t* out,
+                    int n) {
+  for (int j = 0; j < n; j++) out[j] = Combine(kCombination, a[j], b[j]);
+}
+
+Matrix Transpose(const Matrix& matrix) {
+  Matrix transposed(matrix.n, matrix.m);
+  for (int i0 = 0; i0 < matrix.m; i0 += kTransposeBlock) {
+    int i1 = std::min(matrix.m, i0 + kTransposeBlock);
+    for (int j0 = 0; j0 < matrix.n; j0 += kTransposeBlock) {
+      int j1 = std::min(matrix.n, j0 + kTransposeBlock);
+      for (int i = i0; i < i1; i++) {
+        for (int j = j0; j < j1; j++) transposed[j][i] = matrix[i][j];
+      }
+    }
+  }
+  return transposed;
+}
+
+}  // namespace
+
+Combination CombinationAt(int index) {
+  return static_cast<Combination>(index);
+}
+
+const char* CombinationDescription(Combination combination) {
+  switch (combination) {
+    case Combination::kSum:
+      return "a + b";
+    case Combination::kProduct:
+      return "a * b";
+    case Combination::kSignedProduct:
+      return "sign(a) * sign(b) * a * b";
+    case Combination::kBalancedSum:
+      return "3 * (a + b) - abs(a - b)";
+  }
+  return "";
+}
+
+int64_t Combine(Combination combination, int64_t a, int64_t b) {
+  switch (combination) {
+    case Combination::kSum:
+      return a + b;
+    case Combination::kProduct:
+      return a * b;
+    case Combination::kSignedProduct:
+      return ((a < 0 || b < 0) ? -1 : 1) * a * b;
+    case Combination::kBalancedSum:
+      // three times a + b - |a - b| / 3, which ranks the pairs the same
+      // without truncating the division
+      return 3 * (a + b) - std::llabs(a - b);
+  }
+  return 0;
+}
+
+void CombineRow(Combination combination,
+                const int64_t* a,
+                const int64_t* b,
+                int64_t* out,
+                int n) {
+  switch (combination) {
+    case Combination::kSum:
+      return CombineRowWith<Combination::kSum>(a, b, out, n);
+    case Combination::kProduct:
+      return CombineRowWith<Combination::kProduct>(a, b, out, n);
+    case Combination::kSignedProduct:
+      return CombineRowWith<Combination::kSignedProduct>(a, b, out, n);
+    case Combination::kBalancedSum:
+      return CombineRowWith<Combination::kBalancedSum>(a, b, out, n);
+  }
+}
+
+void ProcessExtrema(Matrix* a, Matrix* b, int64_t direct_match_bonus) {
+  for (int i = 0; i < a->m; i++) {
+    for (int j = 0; j < a->n; j++) {
+      int64_t& x = (*a)[i][j];
+      int64_t& y = (*b)[j][i];
+
+      if (x == kVetoRating || y == kVetoRating) {
+        x = kVetoScore;
+        y = kVetoScore;
+      } else if (x == kPerfectRating || y == kPerfectRating) {
+        x += direct_match_bonus;
+        y += direct_match_bonus;
+      }
+    }
+  }
+}
+
+Matrix Quadratic(const Matrix& matrix, int64_t fill_value) {
+  int size = std::max(matrix.m, matrix.n);
+  Matrix result(size, size, fill_value);
+
+  for (int i = 0; i < matrix.m; i++) {
+    std::copy(matrix[i], matrix[i] + matrix.n, result[i]);
+  }
+
+  return result;
+}
+
+Matrix CombineProblem(const Matrix& a,
+                      const Matrix& b,
+                      Combination combination) {
+  Matrix problem(a.m, a.n);
+
+  // b is transposed first, so both operands are read row by row
+  Matrix transposed = Transpose(b);
+  if (!FitsSimdCombine(a) || !FitsSimdCombine(b)) {
+    for (int i = 0; i < a.m; i++) {
+      CombineRow(combination, a[i], transposed[i], problem[i], a.n);
+    }
+
+    return problem;
+  }
+
+  const SimdKernels& kernels = Kernels();
+  for (int i = 0; i < a.m; i++) {
+    kernels.combine(combination, a[i], transposed[i], problem[i], a.n);
+  }
+
+  return problem;
+}
+
+Matrix CombineProblem(const Matrix& a,
+                      const Matrix& b,
+                      const ScoreExpression& score) {
+  if (score.is_builtin()) return CombineProblem(a, b, score.builtin());
+
+  Matrix problem(a.m, a.n);
+  Matrix transposed = Transpose(b);
+  for (int i = 0; i < a.m; i++) {
+    score.EvaluateRow(a[i], transposed[i], problem[i], a.n);
+  }
+
+  return problem;
+}
+
+Matrix InvertProblem(const Matrix& problem) {
+  int64_t largest = *std::max_element(problem.data.begin(), problem.data.end());
+
+  Matrix inverse(problem.m, problem.n);
+  for (size_t k = 0; k < problem.data.size(); k++) {
+    inverse.data[k] = largest - problem.data[k];
+  }
+
+  return inverse;
+}
+
+CostMatrix InvertProblemCosts(const Matrix& problem) {
+  CostBounds bounds =
+      FindCostBounds(problem.data.data(), problem.m, problem.n, problem.n);
+  int64_t largest = bounds.high;
+
+  // the largest cell becomes 0 and the smallest the widest cost
+  CostBounds inverse_bounds;
+  inverse_bounds.high = bounds.high - bounds.low;
+  return CostMatrix(problem.m, problem.n, inverse_bounds,
+                    [&](int i, int j) { return largest - problem[i][j]; });
+}
+
+SparseProblem AllowedPairs(const Matrix& problem, const Matrix& a) {
+  SparseProblem sparse;
+  sparse.m = problem.m;
+  sparse.n = problem.n;
+  sparse.row_offsets.reserve(problem.m + 1);
+  sparse.row_offsets.push_back(0);
+
+  for (int i = 0; i < problem.m; i++) {
+    for (int j = 0; j < problem.n; j++) {
+      if (a[i][j] == kVetoScore) continue;
+
+      sparse.columns.push_back(j);
+      sparse.costs.push_back(problem[i][j]);
+    }
+    sparse.row_offsets.push_back(static_cast<int32_t>(sparse.columns.size()));
+  }
+
+  return sparse;
+}
+
+}  // namespace belegium
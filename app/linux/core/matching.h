@@ -0,0 +1,83 @@
+#ifndef BELEGIUM_CORE_MATCHING_H_
+#define BELEGIUM_CORE_MATCHING_H_
+
+#include <cstdint>
+
+#include "cost_width.h"
+#include "matrix.h"
+#include "sparse_lap_solver.h"
+
+namespace belegium {
+
+class ScoreExpression;
+
+// rating of a veto and the score it is replaced with
+constexpr int64_t kVetoRating = 0;
+constexpr int64_t kVetoScore = -100;
+
+// rating of a perfect match which receives the direct match bonus
+constexpr int64_t kPerfectRating = 15;
+
+// default bonus for direct matches
+constexpr int64_t kDefaultDirectMatchBonus = 10;
+
+// Strategies to merge the two ratings of a pair into a single score, in the
+// order of MatchService._combinationFunctions.
+enum class Combination {
+  kSum,
+  kProduct,
+  kSignedProduct,
+  kBalancedSum,
+};
+
+constexpr int kCombinationCount = 4;
+
+// Returns the combination at |index| of the list above.
+Combination CombinationAt(int index);
+
+// Returns the description shown for |combination|, e.g. "a + b".
+const char* CombinationDescription(Combination combination);
+
+// Merges the ratings |a| and |b| of one pair.
+int64_t Combine(Combination combination, int64_t a, int64_t b);
+
+// Writes Combine(combination, a[j], b[j]) for all n columns into |out|.
+void CombineRow(Combination combination,
+                const int64_t* a,
+                const int64_t* b,
+                int64_t* out,
+                int n);
+
+// Replaces vetoes by kVetoScore and adds |direct_match_bonus| to perfect
+// matches. |b| holds the ratings of the other side, so |a|[i][j] and
+// |b|[j][i] describe the same pair.
+void ProcessExtrema(Matrix* a, Matrix* b, int64_t direct_match_bonus);
+
+// Returns |matrix| extended to a square matrix, new cells are |fill_value|.
+Matrix Quadratic(const Matrix& matrix, int64_t fill_value);
+
+// Returns the maximization problem a[i][j] (+) b[j][i].
+Matrix CombineProblem(const Matrix& a,
+                      const Matrix& b,
+                      Combination combination);
+
+// Same as above for a user-defined scoring expression.
+Matrix CombineProblem(const Matrix& a,
+                      const Matrix& b,
+                      const ScoreExpression& score);
+
+// Returns the minimization problem of the maximization problem |problem|.
+Matrix InvertProblem(const Matrix& problem);
+
+// Same as above, but the costs are written in the narrowest type holding
+// them instead of being copied there before solving.
+CostMatrix InvertProblemCosts(const Matrix& problem);
+
+// Returns the cells of |problem| whose pair is no veto in |a|, which must have
+// been processed by ProcessExtrema. Vetoes become forbidden pairs instead of
+// being matched with a bad score.
+SparseProblem AllowedPairs(const Matrix& problem, const Matrix& a);
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_MATCHING_H_
@@ -0,0 +1,36 @@
+#ifndef BELEGIUM_CORE_MATRIX_H_
+#define BELEGIUM_CORE_MATRIX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace belegium {
+
+// Dense row-major integer matrix with m rows and n columns.
+struct Matrix {
+  Matrix() = default;
+  Matrix(int rows, int columns, int64_t fill_value = 0)
+      : m(rows),
+        n(columns),
+        data(static_cast<size_t>(rows) * columns, fill_value) {}
+
+  // Returns a pointer to the first cell of |row|.
+  int64_t* operator[](int row) { return data.data() + Offset(row); }
+  const int64_t* operator[](int row) const {
+    return data.data() + Offset(row);
+  }
+
+  bool is_square() const { return m == n; }
+
+  int m = 0;
+  int n = 0;
+  std::vector<int64_t> data;
+
+ private:
+  size_t Offset(int row) const { return static_cast<size_t>(row) * n; }
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_MATRIX_H_
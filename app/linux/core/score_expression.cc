@@ -0,0 +1,385 @@
+#include "score_expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+namespace belegium {
+
+namespace {
+
+// columns evaluated at once, the stack of a block stays in the l1 cache
+constexpr int kBlock = 256;
+
+// largest number of values on the stack while evaluating an expression
+constexpr int kMaxDepth = 16;
+
+// largest number of nested parentheses and function calls
+constexpr int kMaxNesting = 64;
+
+int64_t Truncate(double value) {
+  if (std::isnan(value)) return 0;
+  double bound = static_cast<double>(ScoreExpression::kMaxScore);
+  return static_cast<int64_t>(std::max(-bound, std::min(bound, value)));
+}
+
+}  // namespace
+
+constexpr int64_t ScoreExpression::kMaxScore;
+
+// Recursive descent parser emitting postfix bytecode. Each method parses one
+// level of precedence, the lowest first.
+class ScoreExpression::Parser {
+ public:
+  Parser(const std::string& text, std::vector<Instruction>* code)
+      : text_(text), code_(code) {}
+
+  bool Parse(std::string* error) {
+    ParseSum();
+    SkipSpaces();
+    if (error_.empty() && position_ < text_.size()) Unexpected();
+    if (error_.empty() && max_depth_ > kMaxDepth) {
+      error_ = "expression is too large";
+    }
+
+    if (!error_.empty()) {
+      *error = error_;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  // sum := product (("+" | "-") product)*
+  void ParseSum() {
+    ParseProduct();
+    while (error_.empty()) {
+      if (Accept('+')) {
+        ParseProduct();
+        Emit(Op::kAdd);
+      } else if (Accept('-')) {
+        ParseProduct();
+        Emit(Op::kSubtract);
+      } else {
+        return;
+      }
+    }
+  }
+
+  // product := unary (("*" | "/") unary)*
+  void ParseProduct() {
+    ParseUnary();
+    while (error_.empty()) {
+      if (Accept('*')) {
+        ParseUnary();
+        Emit(Op::kMultiply);
+      } else if (Accept('/')) {
+        ParseUnary();
+        Emit(Op::kDivide);
+      } else {
+        return;
+      }
+    }
+  }
+
+  // unary := "-" unary | primary
+  void ParseUnary() {
+    if (Accept('-')) {
+      if (!Enter()) return;
+      ParseUnary();
+      Emit(Op::kNegate);
+      nesting_--;
+    } else {
+      ParsePrimary();
+    }
+  }
+
+  // primary := number | "a" | "b" | "(" sum ")" | name "(" arguments ")"
+  void ParsePrimary() {
+    if (!error_.empty()) return;
+
+    SkipSpaces();
+    if (position_ >= text_.size()) return Unexpected();
+
+    char c = text_[position_];
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      return ParseNumber();
+    }
+
+    if (Accept('(')) {
+      if (!Enter()) return;
+      ParseSum();
+      Expect(')');
+      nesting_--;
+      return;
+    }
+
+    if (!std::isalpha(static_cast<unsigned char>(c))) return Unexpected();
+
+    size_t start = position_;
+    while (position_ < text_.size() &&
+           std::isalnum(static_cast<unsigned char>(text_[position_]))) {
+      position_++;
+    }
+    std::string name = text_.substr(start, position_ - start);
+
+    if (name == "a") return Emit(Op::kA);
+    if (name == "b") return Emit(Op::kB);
+
+    Op op;
+    int arguments;
+    if (name == "abs") {
+      op = Op::kAbs;
+      arguments = 1;
+    } else if (name == "sign") {
+      op = Op::kSign;
+      arguments = 1;
+    } else if (name == "min") {
+      op = Op::kMin;
+      arguments = 2;
+    } else if (name == "max") {
+      op = Op::kMax;
+      arguments = 2;
+    } else {
+      error_ = "unknown name '" + name + "' at position " +
+               std::to_string(start + 1);
+      return;
+    }
+
+    if (!Expect('(') || !Enter()) return;
+    for (int k = 0; k < arguments; k++) {
+      if (k > 0) Expect(',');
+      ParseSum();
+    }
+    Expect(')');
+    nesting_--;
+    Emit(op);
+  }
+
+  void ParseNumber() {
+    const char* begin = text_.c_str() + position_;
+    char* end = nullptr;
+    double value = std::strtod(begin, &end);
+
+    // only plain decimals, strtod would also accept exponents and hex
+    size_t length = 0;
+    while (begin + length < end &&
+           (std::isdigit(static_cast<unsigned char>(begin[length])) ||
+            begin[length] == '.')) {
+      length++;
+    }
+    if (end == begin || begin + length != end) return Unexpected();
+
+    position_ += length;
+    Emit(Op::kConstant, value);
+  }
+
+  void Emit(Op op, double constant = 0) {
+    if (!error_.empty()) return;
+
+    switch (op) {
+      case Op::kA:
+      case Op::kB:
+      case Op::kConstant:
+        depth_++;
+        break;
+      case Op::kNegate:
+      case Op::kAbs:
+      case Op::kSign:
+        break;
+      case Op::kAdd:
+      case Op::kSubtract:
+      case Op::kMultiply:
+      case Op::kDivide:
+      case Op::kMin:
+      case Op::kMax:
+        depth_--;
+        break;
+    }
+    max_depth_ = std::max(max_depth_, depth_);
+
+    code_->push_back({op, constant});
+  }
+
+  // Enters a parenthesis or function call, fails if they are nested too
+  // deeply.
+  bool Enter() {
+    if (++nesting_ > kMaxNesting) {
+      if (error_.empty()) error_ = "expression is nested too deeply";
+      return false;
+    }
+    return true;
+  }
+
+  // Skips spaces and consumes |c| if it follows.
+  bool Accept(char c) {
+    if (!error_.empty()) return false;
+
+    SkipSpaces();
+    if (position_ < text_.size() && text_[position_] == c) {
+      position_++;
+      return true;
+    }
+    return false;
+  }
+
+  // Same as Accept, but fails if |c| does not follow.
+  bool Expect(char c) {
+    if (Accept(c)) return true;
+    if (error_.empty()) Unexpected();
+    return false;
+  }
+
+  void Unexpected() {
+    if (!error_.empty()) return;
+
+    if (position_ >= text_.size()) {
+      error_ = "unexpected end of expression";
+    } else {
+      error_ = std::string("unexpected '") + text_[position_] +
+               "' at position " + std::to_string(position_ + 1);
+    }
+  }
+
+  void SkipSpaces() {
+    while (position_ < text_.size() &&
+           std::isspace(static_cast<unsigned char>(text_[position_]))) {
+      position_++;
+    }
+  }
+
+  const std::string& text_;
+  std::vector<Instruction>* code_;
+
+  size_t position_ = 0;
+  int nesting_ = 0;
+  int depth_ = 0;
+  int max_depth_ = 0;
+
+  // first error, empty while the text is valid
+  std::string error_;
+};
+
+bool ScoreExpression::Parse(const std::string& text,
+                            ScoreExpression* expression,
+                            std::string* error) {
+  std::vector<Instruction> code;
+  if (!Parser(text, &code).Parse(error)) return false;
+
+  expression->text_ = text;
+  expression->code_ = std::move(code);
+  expression->is_builtin_ = false;
+
+  // the built-in combinations are recognized by their bytecode, so spacing
+  // and redundant parentheses do not matter
+  for (int k = 0; k < kCombinationCount; k++) {
+    ScoreExpression builtin = FromCombination(CombinationAt(k));
+    if (builtin.code_ == expression->code_) {
+      expression->is_builtin_ = true;
+      expression->builtin_ = builtin.builtin_;
+      break;
+    }
+  }
+
+  return true;
+}
+
+ScoreExpression ScoreExpression::FromCombination(Combination combination) {
+  ScoreExpression expression;
+  expression.text_ = CombinationDescription(combination);
+
+  std::string error;
+  Parser(expression.text_, &expression.code_).Parse(&error);
+
+  expression.is_builtin_ = true;
+  expression.builtin_ = combination;
+  return expression;
+}
+
+int64_t ScoreExpression::Evaluate(int64_t a, int64_t b) const {
+  if (is_builtin_) return Combine(builtin_, a, b);
+
+  int64_t score = 0;
+  EvaluateBlock(&a, &b, &score, 1);
+  return score;
+}
+
+void ScoreExpression::EvaluateRow(const int64_t* a,
+                                  const int64_t* b,
+                                  int64_t* out,
+                                  int n) const {
+  if (is_builtin_) return CombineRow(builtin_, a, b, out, n);
+
+  for (int j = 0; j < n; j += kBlock) {
+    EvaluateBlock(a + j, b + j, out + j, std::min(kBlock, n - j));
+  }
+}
+
+void ScoreExpression::EvaluateBlock(const int64_t* a,
+                                    const int64_t* b,
+                                    int64_t* out,
+                                    int n) const {
+  // every instruction is applied to all columns of the block before the next
+  // one runs, so the loops below are simple enough to be vectorized
+  double stack[kMaxDepth][kBlock];
+  int top = 0;
+
+  for (const Instruction& instruction : code_) {
+    double* x = top > 0 ? stack[top - 1] : nullptr;
+    double* y = top > 1 ? stack[top - 2] : nullptr;
+
+    switch (instruction.op) {
+      case Op::kA:
+        for (int j = 0; j < n; j++) stack[top][j] = static_cast<double>(a[j]);
+        top++;
+        break;
+      case Op::kB:
+        for (int j = 0; j < n; j++) stack[top][j] = static_cast<double>(b[j]);
+        top++;
+        break;
+      case Op::kConstant:
+        std::fill(stack[top], stack[top] + n, instruction.constant);
+        top++;
+        break;
+      case Op::kNegate:
+        for (int j = 0; j < n; j++) x[j] = -x[j];
+        break;
+      case Op::kAdd:
+        for (int j = 0; j < n; j++) y[j] += x[j];
+        top--;
+        break;
+      case Op::kSubtract:
+        for (int j = 0; j < n; j++) y[j] -= x[j];
+        top--;
+        break;
+      case Op::kMultiply:
+        for (int j = 0; j < n; j++) y[j] *= x[j];
+        top--;
+        break;
+      case Op::kDivide:
+        for (int j = 0; j < n; j++) y[j] = x[j] != 0.0 ? y[j] / x[j] : 0.0;
+        top--;
+        break;
+      case Op::kAbs:
+        for (int j = 0; j < n; j++) x[j] = std::fabs(x[j]);
+        break;
+      case Op::kSign:
+        for (int j = 0; j < n; j++) x[j] = (x[j] > 0.0) - (x[j] < 0.0);
+        break;
+      case Op::kMin:
+        for (int j = 0; j < n; j++) y[j] = std::min(y[j], x[j]);
+        top--;
+        break;
+      case Op::kMax:
+        for (int j = 0; j < n; j++) y[j] = std::max(y[j], x[j]);
+        top--;
+        break;
+    }
+  }
+
+  for (int j = 0; j < n; j++) out[j] = Truncate(stack[0][j]);
+}
+
+}  // namespace belegium
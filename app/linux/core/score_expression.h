@@ -0,0 +1,97 @@
+#ifndef BELEGIUM_CORE_SCORE_EXPRESSION_H_
+#define BELEGIUM_CORE_SCORE_EXPRESSION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "matching.h"
+
+namespace belegium {
+
+// User-defined strategy to merge the ratings a and b of a pair into a score,
+// e.g. "a * b - abs(a - b) / 3".
+//
+// Expressions consist of the ratings a and b, decimal numbers, the operators
+// + - * / with the usual precedence, parentheses and the functions abs(x),
+// sign(x), min(x, y) and max(x, y). They are evaluated with double precision
+// like the dart closures and the score is truncated towards zero. A division
+// by zero yields 0 and scores are clamped to +-kMaxScore.
+//
+// The text is parsed once into a postfix bytecode that is evaluated over
+// blocks of columns, one instruction at a time. Expressions whose bytecode
+// equals the description of a built-in Combination are evaluated by the
+// specialized loops of that combination instead.
+class ScoreExpression {
+ public:
+  // Bound of the magnitude of a score.
+  static constexpr int64_t kMaxScore = int64_t{1} << 53;
+
+  // Parses |text| into |expression|. Returns false and fills |error| if the
+  // text is no valid expression.
+  static bool Parse(const std::string& text,
+                    ScoreExpression* expression,
+                    std::string* error);
+
+  // Returns the expression of the built-in |combination|.
+  static ScoreExpression FromCombination(Combination combination);
+
+  // Text the expression was parsed from.
+  const std::string& text() const { return text_; }
+
+  // True if the expression is evaluated by the loops of |builtin()|.
+  bool is_builtin() const { return is_builtin_; }
+  Combination builtin() const { return builtin_; }
+
+  // Returns the score of the ratings |a| and |b|.
+  int64_t Evaluate(int64_t a, int64_t b) const;
+
+  // Writes the score of a[j] and b[j] for all n columns into |out|.
+  void EvaluateRow(const int64_t* a,
+                   const int64_t* b,
+                   int64_t* out,
+                   int n) const;
+
+ private:
+  enum class Op : uint8_t {
+    kA,
+    kB,
+    kConstant,
+    kNegate,
+    kAdd,
+    kSubtract,
+    kMultiply,
+    kDivide,
+    kAbs,
+    kSign,
+    kMin,
+    kMax,
+  };
+
+  struct Instruction {
+    Op op;
+    double constant;
+
+    bool operator==(const Instruction& other) const {
+      return op == other.op && constant == other.constant;
+    }
+  };
+
+  class Parser;
+
+  // Evaluates the bytecode for the n <= kBlock columns of one block.
+  void EvaluateBlock(const int64_t* a,
+                     const int64_t* b,
+                     int64_t* out,
+                     int n) const;
+
+  std::string text_;
+  std::vector<Instruction> code_;
+
+  bool is_builtin_ = false;
+  Combination builtin_ = Combination::kSum;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SCORE_EXPRESSION_H_
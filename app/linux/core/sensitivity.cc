@@ -0,0 +1,189 @@
+#include "sensitivity.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+// bound of the costs and potentials, their reduced costs cannot overflow
+constexpr int64_t kMaxMagnitude = std::numeric_limits<int64_t>::max() / 8;
+
+// minimal number of trees searched by one task, fewer are not worth waking up
+// the workers
+constexpr int kMinSearchesPerTask = 8;
+
+template <typename Value>
+bool Bounded(Value value) {
+  return value >= -kMaxMagnitude && value <= kMaxMagnitude;
+}
+
+}  // namespace
+
+constexpr int64_t SensitivityAnalysis::kUnbounded;
+
+SensitivityAnalysis::SensitivityAnalysis(int thread_count) {
+  if (thread_count < 1) thread_count = ThreadPool::HardwareThreads();
+  if (thread_count > 1) pool_.reset(new ThreadPool(thread_count));
+  searches_.resize(thread_count);
+}
+
+template <typename Cost>
+bool SensitivityAnalysis::Analyze(const Cost* costs,
+                                  int n,
+                                  int stride,
+                                  const int32_t* row_to_col,
+                                  const int64_t* row_potentials,
+                                  const int64_t* column_potentials,
+                                  int64_t* margins) {
+  stats_ = SolverStats();
+
+  // the assignment must be a permutation
+  row_to_col_.assign(row_to_col, row_to_col + n);
+  col_to_row_.assign(n, -1);
+  for (int i = 0; i < n; ++i) {
+    int j = row_to_col[i];
+    if (j < 0 || j >= n || col_to_row_[j] >= 0) return false;
+    col_to_row_[j] = i;
+  }
+
+  // the duals must be feasible and tight on the assignment, which proves both
+  // optimal. A path has at most n reduced costs besides the first one.
+  int64_t max_reduced = kInfinity / (int64_t{n} + 1);
+  for (int i = 0; i < n; ++i) {
+    if (!Bounded(row_potentials[i]) || !Bounded(column_potentials[i])) {
+      return false;
+    }
+  }
+  reduced_.resize(static_cast<size_t>(n) * n);
+  for (int i = 0; i < n; ++i) {
+    const Cost* row = costs + static_cast<int64_t>(i) * stride;
+    for (int j = 0; j < n; ++j) {
+      if (!Bounded(row[j])) return false;
+
+      int64_t reduced =
+          int64_t{row[j]} - row_potentials[i] - column_potentials[j];
+      if (reduced < 0 || reduced > max_reduced ||
+          (j == row_to_col[i] && reduced != 0)) {
+        return false;
+      }
+      reduced_[static_cast<size_t>(j) * n + i] = reduced;
+    }
+  }
+
+  auto search_range = [&](int task, int tasks) {
+    Search& search = searches_[ThreadPool::WorkerIndex(pool_.get())];
+    search.distance.resize(n);
+    search.settled.resize(n);
+    search.blocked.resize(n);
+    for (int i = task; i < n; i += tasks) {
+      SearchRow(n, i, margins + static_cast<int64_t>(i) * n, &search);
+    }
+  };
+
+  int tasks = 1;
+  if (pool_) tasks = std::min(pool_->size(), n / kMinSearchesPerTask);
+  if (tasks > 1) {
+    for (int task = 0; task < tasks; ++task) {
+      pool_->Submit([&search_range, task, tasks] {
+        search_range(task, tasks);
+      });
+    }
+    pool_->Wait();
+  } else {
+    search_range(0, 1);
+  }
+
+  stats_.augmentations = n;
+  for (Search& search : searches_) {
+    stats_.scanned += search.scanned;
+    search.scanned = 0;
+  }
+
+  // an assigned cell may rise until the cheapest other cell of its row ties
+  for (int i = 0; i < n; ++i) {
+    int64_t* row = margins + static_cast<int64_t>(i) * n;
+    int64_t tolerance = kInfinity;
+    for (int j = 0; j < n; ++j) {
+      if (j != row_to_col[i]) tolerance = std::min(tolerance, row[j]);
+    }
+    row[row_to_col[i]] = n > 1 ? tolerance : kUnbounded;
+  }
+
+  return true;
+}
+
+void SensitivityAnalysis::SearchRow(int n,
+                                    int row,
+                                    int64_t* margins,
+                                    Search* search) const {
+  // distance of every row to the column of |row| along alternating paths,
+  // starting with the direct step onto that column. Settled rows move their
+  // distance to |settled| and are blocked from relaxation by an infinite
+  // offset, so relaxing and finding the next closest row take one pass.
+  int target = row_to_col_[row];
+  int64_t* distance = search->distance.data();
+  int64_t* settled = search->settled.data();
+  int64_t* blocked = search->blocked.data();
+  const int64_t* towards_target =
+      reduced_.data() + static_cast<size_t>(target) * n;
+  std::copy(towards_target, towards_target + n, distance);
+  std::fill(blocked, blocked + n, 0);
+
+  int closest = static_cast<int>(
+      std::min_element(distance, distance + n) - distance);
+  for (int step = 0; step < n; ++step) {
+    int64_t closest_distance = distance[closest];
+    settled[closest] = closest_distance;
+    distance[closest] = kInfinity;
+    blocked[closest] = kInfinity;
+    ++search->scanned;
+    if (step == n - 1) break;
+
+    // every other row can reach |closest| through its column
+    int column = row_to_col_[closest];
+    const int64_t* towards_column =
+        reduced_.data() + static_cast<size_t>(column) * n;
+    int64_t offset = column == target ? kInfinity : closest_distance;
+    int next = -1;
+    int64_t next_distance = kInfinity;
+    for (int k = 0; k < n; ++k) {
+      int64_t length =
+          std::min(distance[k], towards_column[k] + offset + blocked[k]);
+      distance[k] = length;
+      if (length < next_distance) {
+        next = k;
+        next_distance = length;
+      }
+    }
+    if (next < 0) break;
+    closest = next;
+  }
+
+  // taking column j moves its row onto a path back to the freed column
+  for (int j = 0; j < n; ++j) {
+    if (j == target) continue;
+    margins[j] = reduced_[static_cast<size_t>(j) * n + row] +
+                 settled[col_to_row_[j]];
+  }
+}
+
+template bool SensitivityAnalysis::Analyze<int32_t>(const int32_t*,
+                                                    int,
+                                                    int,
+                                                    const int32_t*,
+                                                    const int64_t*,
+                                                    const int64_t*,
+                                                    int64_t*);
+template bool SensitivityAnalysis::Analyze<int64_t>(const int64_t*,
+                                                    int,
+                                                    int,
+                                                    const int32_t*,
+                                                    const int64_t*,
+                                                    const int64_t*,
+                                                    int64_t*);
+
+}  // namespace belegium
@@ -0,0 +1,88 @@
+#ifndef BELEGIUM_CORE_SENSITIVITY_H_
+#define BELEGIUM_CORE_SENSITIVITY_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "solver_stats.h"
+#include "thread_pool.h"
+
+namespace belegium {
+
+// Computes how far the cost of every cell of a solved dense square assignment
+// problem (minimization) can change before the optimal assignment does.
+//
+// The margin of an unassigned cell (i, j) is the amount its cost must fall
+// until an optimal assignment contains it. Forcing row i onto column j frees
+// the column of row i and takes column j from its row k, so the margin is the
+// reduced cost of (i, j) plus the shortest alternating path from row k back to
+// the column of row i in the reduced costs. One shortest path tree towards
+// the column of each row gives the margins of the whole row, so all n^2
+// margins take n searches of O(n^2), which are split among the threads. The
+// margin of an assigned cell is the amount its cost may rise while the
+// assignment stays optimal, the smallest margin of the other cells of its row.
+// A margin of 0 marks a tie with another optimal assignment.
+class SensitivityAnalysis {
+ public:
+  // Value of the margin of the assigned cell of a 1 x 1 problem, which stays
+  // assigned whatever its cost.
+  static constexpr int64_t kUnbounded = -1;
+
+  // Searches with |thread_count| threads, one per hardware thread if it is
+  // < 1.
+  explicit SensitivityAnalysis(int thread_count = 1);
+
+  // Writes the margins of the n x n problem whose rows are |stride| cells
+  // apart row-major into |margins| (n * n entries). |row_to_col| must be an
+  // optimal assignment and |row_potentials| and |column_potentials| optimal
+  // duals of the problem, e.g. those of any optimal solve, as optimal duals
+  // are complementary to every optimal assignment. Returns false and leaves
+  // |margins| unchanged if they are not, or if their reduced costs are so
+  // large that path lengths could overflow. Instantiated for int32_t and
+  // int64_t costs.
+  template <typename Cost>
+  bool Analyze(const Cost* costs,
+               int n,
+               int stride,
+               const int32_t* row_to_col,
+               const int64_t* row_potentials,
+               const int64_t* column_potentials,
+               int64_t* margins);
+
+  // Work counters of the last analysis, |augmentations| counts the shortest
+  // path trees and |scanned| the rows they settled.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Buffers of one shortest path tree.
+  struct Search {
+    std::vector<int64_t> distance;
+    std::vector<int64_t> settled;
+    std::vector<int64_t> blocked;
+    int64_t scanned = 0;
+  };
+
+  // Writes the margins of the unassigned cells of |row| into |margins|.
+  void SearchRow(int n, int row, int64_t* margins, Search* search) const;
+
+  // pool to search the trees, null to search them on the caller
+  std::unique_ptr<ThreadPool> pool_;
+
+  // search buffers, one per worker
+  std::vector<Search> searches_;
+
+  // reduced costs stored transposed, so the reduced costs of all rows towards
+  // a column are contiguous
+  std::vector<int64_t> reduced_;
+
+  // assignment of the analyzed problem
+  std::vector<int32_t> row_to_col_;
+  std::vector<int32_t> col_to_row_;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SENSITIVITY_H_
@@ -0,0 +1,150 @@
+#include "simd_kernels.h"
+
+#include <atomic>
+#include <limits>
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kLargest = std::numeric_limits<int64_t>::max();
+
+template <typename Cost>
+void ColumnMinimaScalar(const Cost* row,
+                        int n,
+                        int32_t row_index,
+                        int64_t* minima,
+                        int32_t* min_rows) {
+  for (int j = 0; j < n; ++j) {
+    if (row[j] < minima[j]) {
+      minima[j] = row[j];
+      min_rows[j] = row_index;
+    }
+  }
+}
+
+template <typename Cost>
+int64_t RelaxRowScalar(const Cost* cost_row,
+                       int n,
+                       int64_t u,
+                       const int64_t* v,
+                       const char* visited,
+                       int32_t row,
+                       int64_t* min_slack,
+                       int32_t* predecessor,
+                       int32_t* min_column) {
+  int64_t delta = kLargest;
+  int32_t next = -1;
+
+  for (int j = 0; j < n; ++j) {
+    if (visited[j]) continue;
+
+    int64_t slack = static_cast<int64_t>(cost_row[j]) - u - v[j];
+    if (slack < min_slack[j]) {
+      min_slack[j] = slack;
+      predecessor[j] = row;
+    }
+
+    if (min_slack[j] < delta) {
+      delta = min_slack[j];
+      next = j;
+    }
+  }
+
+  *min_column = next;
+  return delta;
+}
+
+void SubtractScalar(int64_t* values, int n, int64_t delta) {
+  for (int j = 0; j < n; ++j) values[j] -= delta;
+}
+
+void CombineScalar(Combination combination,
+                   const int64_t* a,
+                   const int64_t* b,
+                   int64_t* out,
+                   int n) {
+  for (int j = 0; j < n; ++j) out[j] = Combine(combination, a[j], b[j]);
+}
+
+const SimdKernels* KernelsOf(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAvx2:
+      return Avx2Kernels();
+    case SimdLevel::kSse4:
+      return Sse4Kernels();
+    case SimdLevel::kScalar:
+      return ScalarKernels();
+  }
+  return ScalarKernels();
+}
+
+bool IsSupported(SimdLevel level) {
+  if (KernelsOf(level) == nullptr) return false;
+
+#if defined(__x86_64__) || defined(__i386__)
+  switch (level) {
+    case SimdLevel::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case SimdLevel::kSse4:
+      return __builtin_cpu_supports("sse4.2");
+    case SimdLevel::kScalar:
+      return true;
+  }
+#endif
+
+  return level == SimdLevel::kScalar;
+}
+
+// kernels selected by SelectSimdLevel, null selects the best supported ones
+std::atomic<const SimdKernels*> g_selected{nullptr};
+
+}  // namespace
+
+const SimdKernels* ScalarKernels() {
+  static const SimdKernels kernels = {
+      &ColumnMinimaScalar<int16_t>, &ColumnMinimaScalar<int32_t>,
+      &ColumnMinimaScalar<int64_t>, &RelaxRowScalar<int16_t>,
+      &RelaxRowScalar<int32_t>,     &RelaxRowScalar<int64_t>,
+      &SubtractScalar,              &CombineScalar,
+  };
+  return &kernels;
+}
+
+SimdLevel SupportedSimdLevel() {
+  static const SimdLevel supported =
+      IsSupported(SimdLevel::kAvx2)   ? SimdLevel::kAvx2
+      : IsSupported(SimdLevel::kSse4) ? SimdLevel::kSse4
+                                      : SimdLevel::kScalar;
+  return supported;
+}
+
+SimdLevel SelectSimdLevel(SimdLevel level) {
+  while (!IsSupported(level)) {
+    level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+  }
+
+  g_selected.store(KernelsOf(level), std::memory_order_relaxed);
+  return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kSse4:
+      return "sse4";
+    case SimdLevel::kScalar:
+      return "scalar";
+  }
+  return "";
+}
+
+const SimdKernels& Kernels() {
+  static const SimdKernels* const best = KernelsOf(SupportedSimdLevel());
+
+  const SimdKernels* selected = g_selected.load(std::memory_order_relaxed);
+  return selected != nullptr ? *selected : *best;
+}
+
+}  // namespace belegium
@@ -0,0 +1,169 @@
+#ifndef BELEGIUM_CORE_SIMD_KERNELS_H_
+#define BELEGIUM_CORE_SIMD_KERNELS_H_
+
+#include <cstdint>
+
+#include "matching.h"
+
+namespace belegium {
+
+// Instruction sets the kernels below are built for. Each level is only used
+// if the processor supports it, the scalar kernels run everywhere.
+enum class SimdLevel {
+  kScalar,
+  kSse4,
+  kAvx2,
+};
+
+// Returns the best level supported by the processor and the build.
+SimdLevel SupportedSimdLevel();
+
+// Selects |level|, or the best supported level below it, for all following
+// kernel calls and returns the selected level. The best supported level is
+// selected by default. Must not be called while kernels run.
+SimdLevel SelectSimdLevel(SimdLevel level);
+
+// Returns the name of |level|, e.g. "avx2".
+const char* SimdLevelName(SimdLevel level);
+
+// Vectorized inner loops of the solvers and of the problem construction. All
+// implementations give identical results, ties are resolved like the scalar
+// loops they replace.
+struct SimdKernels {
+  // Lowers minima[j] to row[j] for all n columns and sets min_rows[j] to
+  // |row_index| wherever it was lowered.
+  void (*column_minima_i16)(const int16_t* row,
+                            int n,
+                            int32_t row_index,
+                            int64_t* minima,
+                            int32_t* min_rows);
+  void (*column_minima_i32)(const int32_t* row,
+                            int n,
+                            int32_t row_index,
+                            int64_t* minima,
+                            int32_t* min_rows);
+  void (*column_minima_i64)(const int64_t* row,
+                            int n,
+                            int32_t row_index,
+                            int64_t* minima,
+                            int32_t* min_rows);
+
+  // Shortest path step of the Jonker-Volgenant solver. For every column j
+  // that is not |visited| it lowers min_slack[j] to cost_row[j] - u - v[j] and
+  // then sets predecessor[j] to |row|. Returns the smallest min_slack of all
+  // columns that are not visited and writes the first column holding it into
+  // |min_column|.
+  int64_t (*relax_row_i16)(const int16_t* cost_row,
+                           int n,
+                           int64_t u,
+                           const int64_t* v,
+                           const char* visited,
+                           int32_t row,
+                           int64_t* min_slack,
+                           int32_t* predecessor,
+                           int32_t* min_column);
+  int64_t (*relax_row_i32)(const int32_t* cost_row,
+                           int n,
+                           int64_t u,
+                           const int64_t* v,
+                           const char* visited,
+                           int32_t row,
+                           int64_t* min_slack,
+                           int32_t* predecessor,
+                           int32_t* min_column);
+  int64_t (*relax_row_i64)(const int64_t* cost_row,
+                           int n,
+                           int64_t u,
+                           const int64_t* v,
+                           const char* visited,
+                           int32_t row,
+                           int64_t* min_slack,
+                           int32_t* predecessor,
+                           int32_t* min_column);
+
+  // Subtracts |delta| from all n |values|.
+  void (*subtract)(int64_t* values, int n, int64_t delta);
+
+  // Writes Combine(combination, a[j], b[j]) for all n columns into |out|.
+  // Every value must be smaller than kMaxSimdCombineValue in magnitude.
+  void (*combine)(Combination combination,
+                  const int64_t* a,
+                  const int64_t* b,
+                  int64_t* out,
+                  int n);
+};
+
+// Bound of the values passed to SimdKernels::combine, the products stay exact
+// in 32 bit multiplications below it.
+constexpr int64_t kMaxSimdCombineValue = int64_t{1} << 28;
+
+// Returns the kernels of the selected level.
+const SimdKernels& Kernels();
+
+// Overloads calling the kernel of the selected level for the cost type.
+inline void ColumnMinima(const int16_t* row,
+                         int n,
+                         int32_t row_index,
+                         int64_t* minima,
+                         int32_t* min_rows) {
+  Kernels().column_minima_i16(row, n, row_index, minima, min_rows);
+}
+inline void ColumnMinima(const int32_t* row,
+                         int n,
+                         int32_t row_index,
+                         int64_t* minima,
+                         int32_t* min_rows) {
+  Kernels().column_minima_i32(row, n, row_index, minima, min_rows);
+}
+inline void ColumnMinima(const int64_t* row,
+                         int n,
+                         int32_t row_index,
+                         int64_t* minima,
+                         int32_t* min_rows) {
+  Kernels().column_minima_i64(row, n, row_index, minima, min_rows);
+}
+inline int64_t RelaxRow(const int16_t* cost_row,
+                        int n,
+                        int64_t u,
+                        const int64_t* v,
+                        const char* visited,
+                        int32_t row,
+                        int64_t* min_slack,
+                        int32_t* predecessor,
+                        int32_t* min_column) {
+  return Kernels().relax_row_i16(cost_row, n, u, v, visited, row, min_slack,
+                                 predecessor, min_column);
+}
+inline int64_t RelaxRow(const int32_t* cost_row,
+                        int n,
+                        int64_t u,
+                        const int64_t* v,
+                        const char* visited,
+                        int32_t row,
+                        int64_t* min_slack,
+                        int32_t* predecessor,
+                        int32_t* min_column) {
+  return Kernels().relax_row_i32(cost_row, n, u, v, visited, row, min_slack,
+                                 predecessor, min_column);
+}
+inline int64_t RelaxRow(const int64_t* cost_row,
+                        int n,
+                        int64_t u,
+                        const int64_t* v,
+                        const char* visited,
+                        int32_t row,
+                        int64_t* min_slack,
+                        int32_t* predecessor,
+                        int32_t* min_column) {
+  return Kernels().relax_row_i64(cost_row, n, u, v, visited, row, min_slack,
+                                 predecessor, min_column);
+}
+
+// Kernels of each level, null if the level is not part of the build.
+const SimdKernels* ScalarKernels();
+const SimdKernels* Sse4Kernels();
+const SimdKernels* Avx2Kernels();
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SIMD_KERNELS_H_
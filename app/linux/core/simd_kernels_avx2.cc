@@ -0,0 +1,115 @@
+// AVX2 build of the kernels, four 64 bit lanes.
+
+#include "simd_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+#define BELEGIUM_SIMD_TARGET __attribute__((target("avx2")))
+
+namespace belegium {
+namespace {
+
+struct Avx2 {
+  using Vec = __m256i;
+  static constexpr int kLanes = 4;
+
+  BELEGIUM_SIMD_TARGET static Vec Load(const int64_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  BELEGIUM_SIMD_TARGET static void Store(int64_t* p, Vec x) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+  }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int64_t* p) { return Load(p); }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int32_t* p) {
+    return _mm256_cvtepi32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int16_t* p) {
+    return _mm256_cvtepi16_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+  }
+
+  // all bits set in the lanes whose flag is not zero
+  BELEGIUM_SIMD_TARGET static Vec LoadVisited(const char* p) {
+    int32_t flags;
+    std::memcpy(&flags, p, sizeof(flags));
+    Vec x = _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(flags));
+    return _mm256_xor_si256(_mm256_cmpeq_epi64(x, _mm256_setzero_si256()),
+                            _mm256_set1_epi64x(-1));
+  }
+
+  // sets p[k] to |index| in the lanes set in |mask|
+  BELEGIUM_SIMD_TARGET static void StoreIndex(int32_t* p,
+                                              Vec mask,
+                                              int32_t index) {
+    __m128i lanes = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+        mask, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+    __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                     _mm_blendv_epi8(old, _mm_set1_epi32(index), lanes));
+  }
+
+  BELEGIUM_SIMD_TARGET static Vec Set1(int64_t x) {
+    return _mm256_set1_epi64x(x);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Iota() {
+    return _mm256_setr_epi64x(0, 1, 2, 3);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Add(Vec a, Vec b) {
+    return _mm256_add_epi64(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Sub(Vec a, Vec b) {
+    return _mm256_sub_epi64(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec CmpGt(Vec a, Vec b) {
+    return _mm256_cmpgt_epi64(a, b);
+  }
+  // b in the lanes set in |mask|, a otherwise
+  BELEGIUM_SIMD_TARGET static Vec Blend(Vec a, Vec b, Vec mask) {
+    return _mm256_blendv_epi8(a, b, mask);
+  }
+  BELEGIUM_SIMD_TARGET static Vec AndNot(Vec a, Vec b) {
+    return _mm256_andnot_si256(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Or(Vec a, Vec b) {
+    return _mm256_or_si256(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Xor(Vec a, Vec b) {
+    return _mm256_xor_si256(a, b);
+  }
+
+  // product of the sign extended low halves of the lanes
+  BELEGIUM_SIMD_TARGET static Vec Mul32(Vec a, Vec b) {
+    return _mm256_mul_epi32(a, b);
+  }
+};
+
+}  // namespace
+}  // namespace belegium
+
+#include "simd_kernels_impl.h"
+
+namespace belegium {
+
+const SimdKernels* Avx2Kernels() {
+  static const SimdKernels kernels = MakeKernels<Avx2>();
+  return &kernels;
+}
+
+}  // namespace belegium
+
+#else
+
+namespace belegium {
+
+const SimdKernels* Avx2Kernels() {
+  return nullptr;
+}
+
+}  // namespace belegium
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef BELEGIUM_CORE_SIMD_KERNELS_IMPL_H_
+#define BELEGIUM_CORE_SIMD_KERNELS_IMPL_H_
+
+// Kernels of simd_kernels.h written once against a vector type V with
+// 64 bit lanes. Each instruction set defines V and BELEGIUM_SIMD_TARGET in its
+// own translation unit before including this file, everything here has
+// internal linkage, so no code compiled for one instruction set can be picked
+// up by another translation unit.
+
+#include <cstdint>
+#include <limits>
+
+#include "simd_kernels.h"
+
+#ifndef BELEGIUM_SIMD_TARGET
+#error "BELEGIUM_SIMD_TARGET must be defined before including this file"
+#endif
+
+namespace belegium {
+namespace {
+
+constexpr int64_t kLargest = std::numeric_limits<int64_t>::max();
+
+template <typename V, typename Cost>
+BELEGIUM_SIMD_TARGET void ColumnMinima(const Cost* row,
+                                       int n,
+                                       int32_t row_index,
+                                       int64_t* minima,
+                                       int32_t* min_rows) {
+  int j = 0;
+  for (; j + V::kLanes <= n; j += V::kLanes) {
+    typename V::Vec value = V::LoadCost(row + j);
+    typename V::Vec minimum = V::Load(minima + j);
+    typename V::Vec lower = V::CmpGt(minimum, value);
+    V::Store(minima + j, V::Blend(minimum, value, lower));
+    V::StoreIndex(min_rows + j, lower, row_index);
+  }
+
+  for (; j < n; ++j) {
+    if (row[j] < minima[j]) {
+      minima[j] = row[j];
+      min_rows[j] = row_index;
+    }
+  }
+}
+
+template <typename V, typename Cost>
+BELEGIUM_SIMD_TARGET int64_t RelaxRow(const Cost* cost_row,
+                                      int n,
+                                      int64_t u,
+                                      const int64_t* v,
+                                      const char* visited,
+                                      int32_t row,
+                                      int64_t* min_slack,
+                                      int32_t* predecessor,
+                                      int32_t* min_column) {
+  const typename V::Vec row_potential = V::Set1(u);
+  const typename V::Vec largest = V::Set1(kLargest);
+  const typename V::Vec step = V::Set1(V::kLanes);
+
+  // smallest slack of each lane and its first column
+  typename V::Vec best = largest;
+  typename V::Vec best_column = V::Set1(-1);
+  typename V::Vec column = V::Iota();
+
+  int j = 0;
+  for (; j + V::kLanes <= n; j += V::kLanes) {
+    typename V::Vec done = V::LoadVisited(visited + j);
+    typename V::Vec slack =
+        V::Sub(V::Sub(V::LoadCost(cost_row + j), row_potential),
+               V::Load(v + j));
+    typename V::Vec old = V::Load(min_slack + j);
+
+    typename V::Vec lower = V::AndNot(done, V::CmpGt(old, slack));
+    typename V::Vec updated = V::Blend(old, slack, lower);
+    V::Store(min_slack + j, updated);
+    V::StoreIndex(predecessor + j, lower, row);
+
+    typename V::Vec candidate = V::Blend(updated, largest, done);
+    typename V::Vec better = V::CmpGt(best, candidate);
+    best = V::Blend(best, candidate, better);
+    best_column = V::Blend(best_column, column, better);
+    column = V::Add(column, step);
+  }
+
+  // lanes hold disjoint columns, equal slacks go to the first column
+  int64_t lanes[V::kLanes];
+  int64_t lane_columns[V::kLanes];
+  V::Store(lanes, best);
+  V::Store(lane_columns, best_column);
+
+  int64_t delta = kLargest;
+  int64_t next = -1;
+  for (int k = 0; k < V::kLanes; ++k) {
+    if (lanes[k] < delta || (lanes[k] == delta && lane_columns[k] < next)) {
+      delta = lanes[k];
+      next = lane_columns[k];
+    }
+  }
+
+  for (; j < n; ++j) {
+    if (visited[j]) continue;
+
+    int64_t slack = static_cast<int64_t>(cost_row[j]) - u - v[j];
+    if (slack < min_slack[j]) {
+      min_slack[j] = slack;
+      predecessor[j] = row;
+    }
+
+    if (min_slack[j] < delta) {
+      delta = min_slack[j];
+      next = j;
+    }
+  }
+
+  *min_column = static_cast<int32_t>(next);
+  return delta;
+}
+
+template <typename V>
+BELEGIUM_SIMD_TARGET void Subtract(int64_t* values, int n, int64_t delta) {
+  const typename V::Vec amount = V::Set1(delta);
+
+  int j = 0;
+  for (; j + V::kLanes <= n; j += V::kLanes) {
+    V::Store(values + j, V::Sub(V::Load(values + j), amount));
+  }
+
+  for (; j < n; ++j) values[j] -= delta;
+}
+
+// a + b
+struct SumOp {
+  template <typename V>
+  BELEGIUM_SIMD_TARGET static typename V::Vec Apply(typename V::Vec a,
+                                                    typename V::Vec b) {
+    return V::Add(a, b);
+  }
+};
+
+// a * b
+struct ProductOp {
+  template <typename V>
+  BELEGIUM_SIMD_TARGET static typename V::Vec Apply(typename V::Vec a,
+                                                    typename V::Vec b) {
+    return V::Mul32(a, b);
+  }
+};
+
+// a * b, negated if a or b is negative
+struct SignedProductOp {
+  template <typename V>
+  BELEGIUM_SIMD_TARGET static typename V::Vec Apply(typename V::Vec a,
+                                                    typename V::Vec b) {
+    typename V::Vec zero = V::Set1(0);
+    typename V::Vec negate =
+        V::Or(V::CmpGt(zero, a), V::CmpGt(zero, b));
+    return V::Sub(V::Xor(V::Mul32(a, b), negate), negate);
+  }
+};
+
+// 3(a + b) - |a - b|
+struct BalancedSumOp {
+  template <typename V>
+  BELEGIUM_SIMD_TARGET static typename V::Vec Apply(typename V::Vec a,
+                                                    typename V::Vec b) {
+    typename V::Vec zero = V::Set1(0);
+    typename V::Vec sum = V::Add(a, b);
+    typename V::Vec difference = V::Sub(a, b);
+    typename V::Vec sign = V::CmpGt(zero, difference);
+    typename V::Vec distance = V::Sub(V::Xor(difference, sign), sign);
+    return V::Sub(V::Add(sum, V::Add(sum, sum)), distance);
+  }
+};
+
+template <typename V, typename Op>
+BELEGIUM_SIMD_TARGET void CombineWith(Combination combination,
+                                      const int64_t* a,
+                                      const int64_t* b,
+                                      int64_t* out,
+                                      int n) {
+  int j = 0;
+  for (; j + V::kLanes <= n; j += V::kLanes) {
+    V::Store(out + j, Op::template Apply<V>(V::Load(a + j), V::Load(b + j)));
+  }
+
+  for (; j < n; ++j) out[j] = Combine(combination, a[j], b[j]);
+}
+
+template <typename V>
+BELEGIUM_SIMD_TARGET void CombineRow(Combination combination,
+                                     const int64_t* a,
+                                     const int64_t* b,
+                                     int64_t* out,
+                                     int n) {
+  switch (combination) {
+    case Combination::kSum:
+      return CombineWith<V, SumOp>(combination, a, b, out, n);
+    case Combination::kProduct:
+      return CombineWith<V, ProductOp>(combination, a, b, out, n);
+    case Combination::kSignedProduct:
+      return CombineWith<V, SignedProductOp>(combination, a, b, out, n);
+    case Combination::kBalancedSum:
+      return CombineWith<V, BalancedSumOp>(combination, a, b, out, n);
+  }
+}
+
+template <typename V>
+SimdKernels MakeKernels() {
+  SimdKernels kernels;
+  kernels.column_minima_i16 = &ColumnMinima<V, int16_t>;
+  kernels.column_minima_i32 = &ColumnMinima<V, int32_t>;
+  kernels.column_minima_i64 = &ColumnMinima<V, int64_t>;
+  kernels.relax_row_i16 = &RelaxRow<V, int16_t>;
+  kernels.relax_row_i32 = &RelaxRow<V, int32_t>;
+  kernels.relax_row_i64 = &RelaxRow<V, int64_t>;
+  kernels.subtract = &Subtract<V>;
+  kernels.combine = &CombineRow<V>;
+  return kernels;
+}
+
+}  // namespace
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SIMD_KERNELS_IMPL_H_
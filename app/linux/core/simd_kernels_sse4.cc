@@ -0,0 +1,113 @@
+// SSE4.2 build of the kernels, two 64 bit lanes.
+
+#include "simd_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+#define BELEGIUM_SIMD_TARGET __attribute__((target("sse4.2")))
+
+namespace belegium {
+namespace {
+
+struct Sse4 {
+  using Vec = __m128i;
+  static constexpr int kLanes = 2;
+
+  BELEGIUM_SIMD_TARGET static Vec Load(const int64_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  BELEGIUM_SIMD_TARGET static void Store(int64_t* p, Vec x) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x);
+  }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int64_t* p) { return Load(p); }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int32_t* p) {
+    return _mm_cvtepi32_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+  }
+  BELEGIUM_SIMD_TARGET static Vec LoadCost(const int16_t* p) {
+    int32_t costs;
+    std::memcpy(&costs, p, sizeof(costs));
+    return _mm_cvtepi16_epi64(_mm_cvtsi32_si128(costs));
+  }
+
+  // all bits set in the lanes whose flag is not zero
+  BELEGIUM_SIMD_TARGET static Vec LoadVisited(const char* p) {
+    int16_t flags;
+    std::memcpy(&flags, p, sizeof(flags));
+    Vec x = _mm_cvtepi8_epi64(_mm_cvtsi32_si128(flags));
+    return _mm_xor_si128(_mm_cmpeq_epi64(x, _mm_setzero_si128()),
+                         _mm_set1_epi64x(-1));
+  }
+
+  // sets p[k] to |index| in the lanes set in |mask|
+  BELEGIUM_SIMD_TARGET static void StoreIndex(int32_t* p,
+                                              Vec mask,
+                                              int32_t index) {
+    __m128i lanes = _mm_shuffle_epi32(mask, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128i old = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p),
+                     _mm_blendv_epi8(old, _mm_set1_epi32(index), lanes));
+  }
+
+  BELEGIUM_SIMD_TARGET static Vec Set1(int64_t x) {
+    return _mm_set1_epi64x(x);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Iota() { return _mm_set_epi64x(1, 0); }
+  BELEGIUM_SIMD_TARGET static Vec Add(Vec a, Vec b) {
+    return _mm_add_epi64(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Sub(Vec a, Vec b) {
+    return _mm_sub_epi64(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec CmpGt(Vec a, Vec b) {
+    return _mm_cmpgt_epi64(a, b);
+  }
+  // b in the lanes set in |mask|, a otherwise
+  BELEGIUM_SIMD_TARGET static Vec Blend(Vec a, Vec b, Vec mask) {
+    return _mm_blendv_epi8(a, b, mask);
+  }
+  BELEGIUM_SIMD_TARGET static Vec AndNot(Vec a, Vec b) {
+    return _mm_andnot_si128(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Or(Vec a, Vec b) {
+    return _mm_or_si128(a, b);
+  }
+  BELEGIUM_SIMD_TARGET static Vec Xor(Vec a, Vec b) {
+    return _mm_xor_si128(a, b);
+  }
+
+  // product of the sign extended low halves of the lanes
+  BELEGIUM_SIMD_TARGET static Vec Mul32(Vec a, Vec b) {
+    return _mm_mul_epi32(a, b);
+  }
+};
+
+}  // namespace
+}  // namespace belegium
+
+#include "simd_kernels_impl.h"
+
+namespace belegium {
+
+const SimdKernels* Sse4Kernels() {
+  static const SimdKernels kernels = MakeKernels<Sse4>();
+  return &kernels;
+}
+
+}  // namespace belegium
+
+#else
+
+namespace belegium {
+
+const SimdKernels* Sse4Kernels() {
+  return nullptr;
+}
+
+}  // namespace belegium
+
+#endif
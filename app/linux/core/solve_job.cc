@@ -0,0 +1,90 @@
+#include "solve_job.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "cost_width.h"
+
+namespace belegium {
+
+namespace {
+
+// smallest time between two progress reports, a consumer redrawing on each
+// report does not need more
+constexpr std::chrono::milliseconds kProgressInterval(50);
+
+}  // namespace
+
+SolveJob::SolveJob(IncrementalSolver* solver,
+                   const int32_t* costs,
+                   int n,
+                   int stride,
+                   ProgressCallback progress,
+                   DoneCallback done)
+    : solver_(solver),
+      n_(n),
+      progress_(std::move(progress)),
+      done_(std::move(done)) {
+  // narrow costs halve the memory read by the solver
+  bool narrow = NarrowestCostWidth(FindCostBounds(costs, n, n, stride)) ==
+                CostWidth::kInt16;
+  if (narrow) {
+    costs16_.resize(static_cast<size_t>(n) * n);
+  } else {
+    costs_.resize(static_cast<size_t>(n) * n);
+  }
+  for (int i = 0; i < n; i++) {
+    const int32_t* row = costs + static_cast<int64_t>(i) * stride;
+    int64_t offset = static_cast<int64_t>(i) * n;
+    if (narrow) {
+      std::transform(row, row + n, costs16_.begin() + offset,
+                     [](int32_t cost) { return static_cast<int16_t>(cost); });
+    } else {
+      std::copy(row, row + n, costs_.begin() + offset);
+    }
+  }
+  row_to_col_.assign(n, -1);
+
+  thread_ = std::thread(&SolveJob::Run, this);
+}
+
+SolveJob::~SolveJob() {
+  Cancel();
+  Wait();
+}
+
+void SolveJob::Wait() {
+  if (thread_.joinable()) thread_.join();
+}
+
+void SolveJob::Run() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point last_report = Clock::now();
+
+  solver_->set_progress([this, &last_report](int assigned,
+                                             int64_t dual_objective) {
+    if (cancel_requested_.load(std::memory_order_relaxed)) return false;
+
+    Clock::time_point now = Clock::now();
+    if (progress_ && now - last_report >= kProgressInterval) {
+      last_report = now;
+      progress_({assigned, n_, dual_objective});
+    }
+    return true;
+  });
+
+  total_cost_ =
+      costs16_.empty()
+          ? solver_->Solve(costs_.data(), n_, n_, row_to_col_.data())
+          : solver_->Solve(costs16_.data(), n_, n_, row_to_col_.data());
+  cancelled_ = solver_->cancelled();
+  stats_ = solver_->stats();
+  solver_->set_progress(nullptr);
+
+  // at the optimum the dual objective equals the total cost
+  if (progress_ && !cancelled_) progress_({n_, n_, total_cost_});
+  if (done_) done_();
+}
+
+}  // namespace belegium
@@ -0,0 +1,91 @@
+#ifndef BELEGIUM_CORE_SOLVE_JOB_H_
+#define BELEGIUM_CORE_SOLVE_JOB_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "incremental_solver.h"
+#include "solver_stats.h"
+
+namespace belegium {
+
+// Solves one square assignment problem (minimization) on a thread of its own,
+// so the event loop of the caller stays responsive during big solves. The job
+// reports its progress while solving and can be cancelled at any time.
+class SolveJob {
+ public:
+  // State of the running solve, see LapSolver::Progress.
+  struct Progress {
+    int assigned;
+    int n;
+    int64_t dual_objective;
+  };
+
+  using ProgressCallback = std::function<void(const Progress&)>;
+  using DoneCallback = std::function<void()>;
+
+  // Copies the n x n problem whose rows are |stride| cells apart and starts
+  // solving it with |solver|, which must outlive the job and must not be used
+  // otherwise until it is done. |progress| is called at most every
+  // kProgressInterval and once the problem is solved, |done| after the result
+  // is available. Both are called on the thread of the job and may be empty,
+  // |done| must not destroy the job.
+  SolveJob(IncrementalSolver* solver,
+           const int32_t* costs,
+           int n,
+           int stride,
+           ProgressCallback progress,
+           DoneCallback done);
+
+  // Cancels the solve and joins its thread.
+  ~SolveJob();
+
+  SolveJob(const SolveJob&) = delete;
+  SolveJob& operator=(const SolveJob&) = delete;
+
+  // Asks the solve to stop after the current augmenting path. May be called
+  // from any thread.
+  void Cancel() { cancel_requested_.store(true, std::memory_order_relaxed); }
+
+  // Blocks until the solve finished or stopped.
+  void Wait();
+
+  // Result of the job, only valid after Wait returned. The assignment of a
+  // cancelled job is incomplete, see LapSolver::cancelled.
+  bool cancelled() const { return cancelled_; }
+  const std::vector<int32_t>& row_to_col() const { return row_to_col_; }
+  int64_t total_cost() const { return total_cost_; }
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Main function of the thread of the job.
+  void Run();
+
+  IncrementalSolver* solver_;
+  int n_;
+
+  // copy of the problem, row-major without gaps, in |costs16_| if all costs
+  // fit into 16 bits and in |costs_| otherwise
+  std::vector<int16_t> costs16_;
+  std::vector<int32_t> costs_;
+
+  ProgressCallback progress_;
+  DoneCallback done_;
+
+  std::atomic<bool> cancel_requested_{false};
+
+  bool cancelled_ = false;
+  std::vector<int32_t> row_to_col_;
+  int64_t total_cost_ = 0;
+  SolverStats stats_;
+
+  // started last, after all members it reads
+  std::thread thread_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SOLVE_JOB_H_
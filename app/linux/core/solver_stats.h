@@ -0,0 +1,26 @@
+#ifndef BELEGIUM_CORE_SOLVER_STATS_H_
+#define BELEGIUM_CORE_SOLVER_STATS_H_
+
+#include <cstdint>
+
+namespace belegium {
+
+// Work counters of the last solve, they allow comparing solvers independent of
+// the hardware.
+struct SolverStats {
+  // number of shortest augmenting path searches
+  int64_t augmentations = 0;
+
+  // number of rows and columns settled by all path searches
+  int64_t scanned = 0;
+
+  // number of times the dual potentials or prices were changed
+  int64_t dual_updates = 0;
+
+  // number of pairs added to the assignment along all augmenting paths
+  int64_t path_length = 0;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SOLVER_STATS_H_
@@ -0,0 +1,181 @@
+#include "sparse_lap_solver.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+// column with its tentative distance, ordered for a min heap
+using HeapEntry = std::pair<int64_t, int32_t>;
+
+}  // namespace
+
+int64_t SparseLapSolver::Solve(const int32_t* row_offsets,
+                               const int32_t* columns,
+                               const int64_t* costs,
+                               int m,
+                               int n,
+                               int32_t* row_to_col) {
+  // one more real pair changes the costs of the real pairs by less than the
+  // penalty: an augmenting path adds at most min(m, n) pairs and removes one
+  // fewer, so assigning a row is always worth giving up a dummy column
+  int32_t pairs = row_offsets[m];
+  int64_t low = 0;
+  int64_t high = 0;
+  if (pairs > 0) {
+    low = *std::min_element(costs, costs + pairs);
+    high = *std::max_element(costs, costs + pairs);
+  }
+  n_ = n;
+  penalty_ = int64_t{std::min(m, n)} * (high - low) +
+             std::max<int64_t>(high, 0) + 1;
+
+  u_.assign(m, 0);
+  v_.assign(n + m, 0);
+  row_to_col_.assign(m, -1);
+  col_to_row_.assign(n + m, -1);
+  distance_.assign(n + m, kInfinity);
+  predecessor_.assign(n + m, -1);
+  done_.assign(n + m, 0);
+  reached_.clear();
+  unassigned_rows_.clear();
+  stats_ = SolverStats();
+
+  // row minima make all reduced costs non-negative. Column potentials start
+  // at zero and only decrease, so columns left free keep a potential of zero
+  // as required for optimality if there are more columns than rows.
+  for (int i = 0; i < m; i++) {
+    if (row_offsets[i] == row_offsets[i + 1]) continue;
+
+    u_[i] = *std::min_element(costs + row_offsets[i],
+                              costs + row_offsets[i + 1]);
+
+    // assign the row greedily to a free column with a reduced cost of zero
+    for (int32_t k = row_offsets[i]; k < row_offsets[i + 1]; k++) {
+      int j = columns[k];
+      if (col_to_row_[j] == -1 && costs[k] == u_[i]) {
+        row_to_col_[i] = j;
+        col_to_row_[j] = i;
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < m; i++) {
+    if (row_to_col_[i] == -1) Augment(row_offsets, columns, costs, i);
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < m; i++) {
+    if (row_to_col_[i] >= n) {
+      row_to_col[i] = -1;
+      unassigned_rows_.push_back(i);
+      continue;
+    }
+    row_to_col[i] = row_to_col_[i];
+
+    // the cheapest of duplicate pairs is the assigned one
+    int64_t cost = kInfinity;
+    for (int32_t k = row_offsets[i]; k < row_offsets[i + 1]; k++) {
+      if (columns[k] == row_to_col_[i]) cost = std::min(cost, costs[k]);
+    }
+    total += cost;
+  }
+
+  return total;
+}
+
+void SparseLapSolver::Augment(const int32_t* row_offsets,
+                              const int32_t* columns,
+                              const int64_t* costs,
+                              int row) {
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                      std::greater<HeapEntry>>
+      heap;
+
+  // relaxes the pair of row |i| and column |j|, the row is reached at |base|
+  auto relax_pair = [&](int i, int j, int64_t cost, int64_t base) {
+    if (done_[j]) return;
+
+    int64_t distance = base + cost - u_[i] - v_[j];
+    if (distance < distance_[j]) {
+      if (distance_[j] == kInfinity) reached_.push_back(j);
+      distance_[j] = distance;
+      predecessor_[j] = i;
+      heap.emplace(distance, j);
+    }
+  };
+
+  // relaxes the allowed pairs and the dummy column of row |i|
+  auto relax = [&](int i, int64_t base) {
+    for (int32_t k = row_offsets[i]; k < row_offsets[i + 1]; k++) {
+      relax_pair(i, columns[k], costs[k], base);
+    }
+    relax_pair(i, n_ + i, penalty_, base);
+  };
+
+  relax(row, 0);
+
+  // the dummy column of the free row is free, so a sink is always found
+  int sink = -1;
+  while (!heap.empty()) {
+    HeapEntry entry = heap.top();
+    heap.pop();
+
+    int j = entry.second;
+    if (done_[j] || entry.first != distance_[j]) continue;
+
+    done_[j] = 1;
+    stats_.scanned++;
+
+    if (col_to_row_[j] == -1) {
+      sink = j;
+      break;
+    }
+
+    // the assigned pair has a reduced cost of zero
+    relax(col_to_row_[j], distance_[j]);
+  }
+
+  stats_.augmentations++;
+  stats_.dual_updates++;
+
+  // keep the reduced costs non-negative and make the path tight
+  int64_t sink_distance = distance_[sink];
+  u_[row] += sink_distance;
+  for (int32_t j : reached_) {
+    if (!done_[j] || j == sink) continue;
+
+    int64_t delta = sink_distance - distance_[j];
+    v_[j] -= delta;
+    u_[col_to_row_[j]] += delta;
+  }
+
+  // flip the path
+  int j = sink;
+  for (;;) {
+    int i = predecessor_[j];
+    int next = row_to_col_[i];
+    row_to_col_[i] = j;
+    col_to_row_[j] = i;
+    stats_.path_length++;
+    if (i == row) break;
+    j = next;
+  }
+
+  for (int32_t j : reached_) {
+    distance_[j] = kInfinity;
+    predecessor_[j] = -1;
+    done_[j] = 0;
+  }
+  reached_.clear();
+}
+
+}  // namespace belegium
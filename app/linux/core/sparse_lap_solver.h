@@ -0,0 +1,100 @@
+#ifndef BELEGIUM_CORE_SPARSE_LAP_SOLVER_H_
+#define BELEGIUM_CORE_SPARSE_LAP_SOLVER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "solver_stats.h"
+
+namespace belegium {
+
+// Allowed pairs of an m x n assignment problem in compressed sparse row form.
+// The allowed columns of row i and their costs are stored at the indices
+// row_offsets[i] to row_offsets[i + 1] - 1 of |columns| and |costs|, every
+// other pair is forbidden.
+struct SparseProblem {
+  int m = 0;
+  int n = 0;
+  std::vector<int32_t> row_offsets;
+  std::vector<int32_t> columns;
+  std::vector<int64_t> costs;
+};
+
+// Solves rectangular assignment problems (minimization) whose forbidden pairs
+// are left out instead of being priced with a large cost. Every row is
+// assigned to a distinct allowed column along shortest augmenting paths,
+// which are searched with Dijkstra on the reduced costs of the allowed pairs
+// only, so the work depends on the number of allowed pairs instead of m * n.
+//
+// If not every row can be assigned, as many rows as possible are assigned and
+// among those matchings one with minimal costs is found. Each row gets a
+// dummy column of its own, priced above the cost of any change of the real
+// pairs, so a row only takes its dummy column if no maximum matching assigns
+// it. The rows left on their dummy columns are reported as unassigned.
+//
+// The solver keeps its work buffers between calls, so a single instance can
+// be reused for many problems without reallocating.
+class SparseLapSolver {
+ public:
+  // Solves the m x n problem described by |row_offsets| (m + 1 entries),
+  // |columns| and |costs| and writes the column assigned to each row into
+  // |row_to_col|, -1 for unassigned rows. Returns the total cost of the
+  // assigned rows.
+  int64_t Solve(const int32_t* row_offsets,
+                const int32_t* columns,
+                const int64_t* costs,
+                int m,
+                int n,
+                int32_t* row_to_col);
+
+  int64_t Solve(const SparseProblem& problem, int32_t* row_to_col) {
+    return Solve(problem.row_offsets.data(), problem.columns.data(),
+                 problem.costs.data(), problem.m, problem.n, row_to_col);
+  }
+
+  // Rows left unassigned by the last solve, in ascending order. The problem
+  // is infeasible if there are any.
+  const std::vector<int32_t>& unassigned_rows() const {
+    return unassigned_rows_;
+  }
+
+  // Work counters of the last solve.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Augments the matching along a shortest path starting at the free |row|,
+  // which always reaches its dummy column at the latest.
+  void Augment(const int32_t* row_offsets,
+               const int32_t* columns,
+               const int64_t* costs,
+               int row);
+
+  // number of real columns, the dummy column of row i is n_ + i
+  int n_ = 0;
+
+  // cost of a dummy column
+  int64_t penalty_ = 0;
+
+  // row and column potentials, dummy columns included, the reduced cost of
+  // an allowed pair is costs[i][j] - u_[i] - v_[j] and never negative
+  std::vector<int64_t> u_;
+  std::vector<int64_t> v_;
+
+  // assignment in both directions, -1 if unassigned
+  std::vector<int32_t> row_to_col_;
+  std::vector<int32_t> col_to_row_;
+
+  // shortest path state, only the columns in |reached_| are reset
+  std::vector<int64_t> distance_;
+  std::vector<int32_t> predecessor_;
+  std::vector<char> done_;
+  std::vector<int32_t> reached_;
+
+  std::vector<int32_t> unassigned_rows_;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_SPARSE_LAP_SOLVER_H_
@@ -0,0 +1,93 @@
+#include "thread_pool.h"
+
+#include <utility>
+
+namespace belegium {
+
+namespace {
+
+// index of the worker running on this thread, -1 for other threads
+thread_local int g_worker_index = -1;
+
+// pool of the worker running on this thread, null for other threads
+thread_local const ThreadPool* g_worker_pool = nullptr;
+
+}  // namespace
+
+ThreadPool::ThreadPool(int thread_count) {
+  if (thread_count < 1) thread_count = HardwareThreads();
+
+  workers_.reserve(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    workers_.emplace_back(&ThreadPool::Work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    pending_++;
+  }
+  task_available_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return pending_ == 0; });
+}
+
+int ThreadPool::HardwareThreads() {
+  unsigned int count = std::thread::hardware_concurrency();
+  return count > 0 ? static_cast<int>(count) : 1;
+}
+
+int ThreadPool::CurrentWorker() {
+  return g_worker_index;
+}
+
+int ThreadPool::WorkerIndex(const ThreadPool* pool) {
+  return pool != nullptr && g_worker_pool == pool ? g_worker_index : 0;
+}
+
+void ThreadPool::Work(int index) {
+  g_worker_index = index;
+  g_worker_pool = this;
+
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock,
+                           [this] { return stopping_ || !tasks_.empty(); });
+
+      // drain the queue before stopping
+      if (tasks_.empty()) return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_--;
+      if (pending_ == 0) idle_.notify_all();
+    }
+  }
+}
+
+}  // namespace belegium
@@ -0,0 +1,65 @@
+#ifndef BELEGIUM_CORE_THREAD_POOL_H_
+#define BELEGIUM_CORE_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace belegium {
+
+// Fixed size pool of worker threads executing submitted tasks in FIFO order.
+class ThreadPool {
+ public:
+  // Starts |thread_count| workers, or one per hardware thread if it is < 1.
+  explicit ThreadPool(int thread_count = 0);
+
+  // Finishes all submitted tasks and joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Queues |task| for execution on one of the workers.
+  void Submit(std::function<void()> task);
+
+  // Blocks until every submitted task has finished.
+  void Wait();
+
+  int size() const { return static_cast<int>(workers_.size()); }
+
+  // Returns the number of hardware threads, at least 1.
+  static int HardwareThreads();
+
+  // Returns the index in [0, size()) of the worker running the caller within
+  // its pool, -1 if the caller is no worker. Tasks can use it to keep
+  // buffers per worker.
+  static int CurrentWorker();
+
+  // Returns the index in [0, pool->size()) of the worker of |pool| running
+  // the caller, 0 if |pool| is null or the caller is no worker of it, e.g.
+  // when a worker of another pool solves on its own thread. Solvers use it to
+  // pick their buffers per worker, the caller shares the first ones.
+  static int WorkerIndex(const ThreadPool* pool);
+
+ private:
+  // Main loop of the worker at |index|.
+  void Work(int index);
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::condition_variable idle_;
+
+  // number of tasks queued or running
+  int pending_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_THREAD_POOL_H_
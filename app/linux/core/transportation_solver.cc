@@ -0,0 +1,196 @@
+#include "transportation_solver.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace belegium {
+
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+
+}  // namespace
+
+int64_t TransportationSolver::Solve(const int64_t* costs,
+                                    int m,
+                                    int n,
+                                    const int32_t* row_capacities,
+                                    const int32_t* column_capacities,
+                                    std::vector<int32_t>* rows,
+                                    std::vector<int32_t>* columns) {
+  stats_ = SolverStats();
+
+  int64_t row_units = std::accumulate(row_capacities, row_capacities + m,
+                                      static_cast<int64_t>(0));
+  int64_t column_units = std::accumulate(
+      column_capacities, column_capacities + n, static_cast<int64_t>(0));
+
+  // the augmenting paths start at the side with fewer units, so the
+  // transposed problem is solved and its flow turned back
+  std::vector<int64_t> transposed;
+  bool transpose = row_units > column_units;
+  if (transpose) {
+    transposed.resize(static_cast<size_t>(m) * n);
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        transposed[static_cast<size_t>(j) * m + i] =
+            costs[static_cast<size_t>(i) * n + j];
+      }
+    }
+    Assign(transposed.data(), n, m, column_capacities, row_capacities);
+  } else {
+    Assign(costs, m, n, row_capacities, column_capacities);
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      size_t cell = static_cast<size_t>(i) * n + j;
+      int32_t units =
+          flow_[transpose ? static_cast<size_t>(j) * m + i : cell];
+      for (int32_t unit = 0; unit < units; unit++) {
+        rows->push_back(i);
+        columns->push_back(j);
+        total += costs[cell];
+      }
+    }
+  }
+
+  return total;
+}
+
+void TransportationSolver::Assign(const int64_t* costs,
+                                  int m,
+                                  int n,
+                                  const int32_t* row_capacities,
+                                  const int32_t* column_capacities) {
+  flow_.assign(static_cast<size_t>(m) * n, 0);
+  column_rows_.assign(n, {});
+  row_left_.assign(row_capacities, row_capacities + m);
+  column_left_.assign(column_capacities, column_capacities + n);
+
+  // row minima make all reduced costs non-negative, the columns with units
+  // left keep a potential of 0, so the closest of them ends a shortest path
+  u_.assign(m, 0);
+  v_.assign(n, 0);
+  for (int i = 0; i < m; i++) {
+    const int64_t* row = costs + static_cast<size_t>(i) * n;
+    if (n > 0) u_[i] = *std::min_element(row, row + n);
+  }
+
+  // units whose cheapest column has units left are assigned right away
+  for (int i = 0; i < m; i++) {
+    const int64_t* row = costs + static_cast<size_t>(i) * n;
+    for (int j = 0; j < n && row_left_[i] > 0; j++) {
+      if (row[j] != u_[i] || column_left_[j] == 0) continue;
+
+      int32_t units = std::min(row_left_[i], column_left_[j]);
+      AddFlow(n, i, j, units);
+      row_left_[i] -= units;
+      column_left_[j] -= units;
+    }
+  }
+
+  distance_.resize(n);
+  column_parent_.resize(n);
+  row_distance_.resize(m);
+  row_parent_.resize(m);
+  row_reached_.assign(m, 0);
+
+  for (int i = 0; i < m; i++) {
+    while (row_left_[i] > 0) Augment(costs, n, i);
+  }
+}
+
+void TransportationSolver::Augment(const int64_t* costs, int n, int row) {
+  stats_.augmentations++;
+
+  unsettled_.resize(n);
+  std::iota(unsettled_.begin(), unsettled_.end(), 0);
+  std::fill(distance_.begin(), distance_.end(), kInfinity);
+  settled_.clear();
+  reached_.clear();
+
+  // the rows are scanned as soon as they are reached, as the cells with flow
+  // have no reduced cost, a row is as far as the column it is reached from
+  auto scan = [&](int i, int64_t distance) {
+    row_reached_[i] = 1;
+    row_distance_[i] = distance;
+    reached_.push_back(i);
+
+    const int64_t* cost_row = costs + static_cast<size_t>(i) * n;
+    int64_t base = distance - u_[i];
+    for (int32_t j : unsettled_) {
+      int64_t candidate = base + cost_row[j] - v_[j];
+      if (candidate < distance_[j]) {
+        distance_[j] = candidate;
+        column_parent_[j] = i;
+      }
+    }
+  };
+
+  row_parent_[row] = -1;
+  scan(row, 0);
+
+  int sink = -1;
+  int64_t lowest = kInfinity;
+  while (sink == -1) {
+    // settle the closest column
+    size_t best = 0;
+    for (size_t k = 1; k < unsettled_.size(); k++) {
+      if (distance_[unsettled_[k]] < distance_[unsettled_[best]]) best = k;
+    }
+    int j = unsettled_[best];
+    unsettled_[best] = unsettled_.back();
+    unsettled_.pop_back();
+    settled_.push_back(j);
+    stats_.scanned++;
+
+    if (column_left_[j] > 0) {
+      sink = j;
+      lowest = distance_[j];
+      break;
+    }
+
+    for (int32_t i : column_rows_[j]) {
+      if (row_reached_[i]) continue;
+
+      row_parent_[i] = j;
+      scan(i, distance_[j]);
+    }
+  }
+
+  // keep the reduced costs non-negative and the ones of the path at 0, the
+  // columns with units left are never settled before the sink and keep 0
+  stats_.dual_updates++;
+  for (int32_t j : settled_) v_[j] += distance_[j] - lowest;
+  for (int32_t i : reached_) {
+    u_[i] += lowest - row_distance_[i];
+    row_reached_[i] = 0;
+  }
+
+  // move one unit along the path
+  int j = sink;
+  for (;;) {
+    int i = column_parent_[j];
+    AddFlow(n, i, j, 1);
+    stats_.path_length++;
+    if (i == row) break;
+
+    j = row_parent_[i];
+    AddFlow(n, i, j, -1);
+  }
+  row_left_[row]--;
+  column_left_[sink]--;
+}
+
+void TransportationSolver::AddFlow(int n, int row, int column, int32_t units) {
+  int32_t& flow = flow_[static_cast<size_t>(row) * n + column];
+  std::vector<int32_t>& rows = column_rows_[column];
+  if (flow == 0) rows.push_back(row);
+  flow += units;
+  if (flow == 0) rows.erase(std::find(rows.begin(), rows.end(), row));
+}
+
+}  // namespace belegium
@@ -0,0 +1,88 @@
+#ifndef BELEGIUM_CORE_TRANSPORTATION_SOLVER_H_
+#define BELEGIUM_CORE_TRANSPORTATION_SOLVER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "solver_stats.h"
+
+namespace belegium {
+
+// Solves assignment problems where rows and columns may be matched several
+// times (minimization). Row i can be used row_capacities[i] times and column j
+// column_capacities[j] times, which is the same as solving the square problem
+// with every row and column copied accordingly and padded with a constant,
+// but without ever building that matrix.
+//
+// The problem is solved as a min-cost flow with one shortest augmenting path
+// per unit of the side with fewer units, like LapSolver on the copied matrix.
+// The rows of the problem are the units of that side and a greedy start
+// already assigns the units whose cheapest column is free. Every search only
+// scans the m x n cells instead of the copies, so it takes
+// O(units * (m + n) * n) in the worst case, about the number of seats per
+// column faster than solving the copied matrix.
+class TransportationSolver {
+ public:
+  // Solves the m x n problem stored row-major in |costs|. Assigns
+  // min(sum of row capacities, sum of column capacities) units and appends one
+  // (row, column) pair per unit to |rows| and |columns| in row-major order.
+  // Returns the total cost.
+  int64_t Solve(const int64_t* costs,
+                int m,
+                int n,
+                const int32_t* row_capacities,
+                const int32_t* column_capacities,
+                std::vector<int32_t>* rows,
+                std::vector<int32_t>* columns);
+
+  // Work counters of the last solve.
+  const SolverStats& stats() const { return stats_; }
+
+ private:
+  // Assigns the units of every row, which must not be more than the units of
+  // the columns, and leaves the flow in |flow_|.
+  void Assign(const int64_t* costs,
+              int m,
+              int n,
+              const int32_t* row_capacities,
+              const int32_t* column_capacities);
+
+  // Assigns one more unit of |row| along a shortest augmenting path on the
+  // reduced costs, which ends at the closest column with units left.
+  void Augment(const int64_t* costs, int n, int row);
+
+  // Moves |units| units of |row| to |column| and keeps |column_rows_|.
+  void AddFlow(int n, int row, int column, int32_t units);
+
+  // units sent over each cell
+  std::vector<int32_t> flow_;
+
+  // rows with units on each column, they are reached by undoing a unit
+  std::vector<std::vector<int32_t>> column_rows_;
+
+  // remaining capacities
+  std::vector<int32_t> row_left_;
+  std::vector<int32_t> column_left_;
+
+  // dual potentials, the reduced costs costs[i][j] - u_[i] - v_[j] are
+  // non-negative and 0 for cells with flow
+  std::vector<int64_t> u_;
+  std::vector<int64_t> v_;
+
+  // shortest path state: distances and parents of the columns, the columns
+  // not settled yet, and the rows reached with their distances and parents
+  std::vector<int64_t> distance_;
+  std::vector<int32_t> column_parent_;
+  std::vector<int32_t> unsettled_;
+  std::vector<int32_t> settled_;
+  std::vector<int64_t> row_distance_;
+  std::vector<int32_t> row_parent_;
+  std::vector<char> row_reached_;
+  std::vector<int32_t> reached_;
+
+  SolverStats stats_;
+};
+
+}  // namespace belegium
+
+#endif  // BELEGIUM_CORE_TRANSPORTATION_SOLVER_H_
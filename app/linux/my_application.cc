@@ -5,15 +5,53 @@
 #include <gdk/gdkx.h>
 #endif
 
+#include <cstring>
+
+#include "core/belegium_core.h"
 #include "flutter/generated_plugin_registrant.h"
+#include "solver_channel.h"
+
+// Options of main.dart that take a value, the value is the next argument
+// unless it is given as --option=value.
+static const char* const kValueOptions[] = {
+    "--extra",   "--score",          "--k-best", "--max-gap",
+    "--profile", "--solution-cache", "--solver",
+};
 
 struct _MyApplication {
   GtkApplication parent_instance;
   char** dart_entrypoint_arguments;
+  SolverChannel* solver_channel;
 };
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
+// Returns the input file among the Dart entrypoint |arguments| the way
+// main.dart parses them, nullptr if there is none.
+static const gchar* find_input_file(char** arguments) {
+  const gchar* input_file = nullptr;
+  for (char** argument = arguments; *argument != nullptr; argument++) {
+    // every argument after "--" is positional
+    if (strcmp(*argument, "--") == 0) {
+      if (input_file == nullptr) input_file = argument[1];
+      break;
+    }
+
+    if (g_str_has_prefix(*argument, "-")) {
+      for (const char* option : kValueOptions) {
+        if (strcmp(*argument, option) == 0 && argument[1] != nullptr) {
+          argument++;
+          break;
+        }
+      }
+      continue;
+    }
+
+    if (input_file == nullptr) input_file = *argument;
+  }
+  return input_file;
+}
+
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
@@ -59,6 +97,14 @@ static void my_application_activate(GApplication* application) {
 
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
 
+  // Solve on native worker threads, so big problems do not block the main
+  // loop.
+  g_autoptr(FlPluginRegistrar) solver_registrar =
+      fl_plugin_registry_get_registrar_for_plugin(FL_PLUGIN_REGISTRY(view),
+                                                  "SolverChannel");
+  self->solver_channel = solver_channel_new(
+      fl_plugin_registrar_get_messenger(solver_registrar));
+
   gtk_widget_grab_focus(GTK_WIDGET(view));
 }
 
@@ -68,6 +114,11 @@ static gboolean my_application_local_command_line(GApplication* application, gch
   // Strip out the first argument as it is the binary name.
   self->dart_entrypoint_arguments = g_strdupv(*arguments + 1);
 
+  // Load the input file while GTK and the engine start, the Dart code takes
+  // the parsed tables instead of loading the file itself.
+  const gchar* input_file = find_input_file(self->dart_entrypoint_arguments);
+  if (input_file != nullptr) belegium_preload_input(input_file);
+
   g_autoptr(GError) error = nullptr;
   if (!g_application_register(application, nullptr, &error)) {
      g_warning("Failed to register: %s", error->message);
@@ -95,6 +146,7 @@ static void my_application_shutdown(GApplication* application) {
   //MyApplication* self = MY_APPLICATION(object);
 
   // Perform any actions required at application shutdown.
+  belegium_discard_preloaded_inputs();
 
   G_APPLICATION_CLASS(my_application_parent_class)->shutdown(application);
 }
@@ -103,6 +155,7 @@ static void my_application_shutdown(GApplication* application) {
 static void my_application_dispose(GObject* object) {
   MyApplication* self = MY_APPLICATION(object);
   g_clear_pointer(&self->dart_entrypoint_arguments, g_strfreev);
+  g_clear_pointer(&self->solver_channel, solver_channel_free);
   G_OBJECT_CLASS(my_application_parent_class)->dispose(object);
 }
 
@@ -0,0 +1,357 @@
+#include "solver_channel.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "core/belegium_core.h"
+
+static constexpr char kMethodChannelName[] = "belegium_matcher/solver";
+static constexpr char kEventChannelName[] = "belegium_matcher/solver/progress";
+
+// Solve submitted by a "solve" call, answered once its job is done.
+struct SolveRequest {
+  SolverChannel* channel;
+  int64_t id;
+  std::string key;
+  int32_t n;
+  FlMethodCall* method_call;
+  BelegiumSolveJob* job;
+};
+
+// Progress of a job, sent from its thread to the main loop.
+struct SolveProgress {
+  SolverChannel* channel;
+  int64_t id;
+  int32_t assigned;
+  int32_t n;
+  int64_t dual_objective;
+};
+
+struct _SolverChannel {
+  FlMethodChannel* methods;
+  FlEventChannel* events;
+
+  // whether the Dart code listens to the progress events
+  gboolean listening;
+
+  // solvers by the key of their problem, they keep the state of their last
+  // solve, so solving a slightly changed problem again only repairs it
+  std::map<std::string, BelegiumIncrementalSolver*> solvers;
+
+  // running requests by id
+  std::map<int64_t, SolveRequest*> requests;
+
+  // sources posted by the threads of the jobs that did not run yet, they
+  // point to the requests and are removed with them
+  std::mutex sources_mutex;
+  std::set<GSource*> sources;
+};
+
+// Queues |callback| with |data| on the main loop and keeps its source until it
+// ran, |notify| releases |data| even if the source is removed before. Called
+// on the threads of the jobs.
+static void post_to_main_loop(SolverChannel* self,
+                              GSourceFunc callback,
+                              gpointer data,
+                              GDestroyNotify notify) {
+  GSource* source = g_idle_source_new();
+  g_source_set_callback(source, callback, data, notify);
+
+  std::lock_guard<std::mutex> lock(self->sources_mutex);
+  self->sources.insert(source);
+  g_source_attach(source, nullptr);
+}
+
+// Forgets the source running on the main loop, called by posted callbacks.
+static void forget_current_source(SolverChannel* self) {
+  GSource* source = g_main_current_source();
+
+  std::lock_guard<std::mutex> lock(self->sources_mutex);
+  self->sources.erase(source);
+  g_source_unref(source);
+}
+
+// Looks up the argument |name| of the |type|, nullptr if it is missing.
+static FlValue* lookup_argument(FlValue* args,
+                                const gchar* name,
+                                FlValueType type) {
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+
+  FlValue* value = fl_value_lookup_string(args, name);
+  if (value == nullptr || fl_value_get_type(value) != type) return nullptr;
+  return value;
+}
+
+static void respond_error(FlMethodCall* method_call,
+                          const gchar* code,
+                          const gchar* message) {
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond_error(method_call, code, message, nullptr,
+                                    &error)) {
+    g_warning("Failed to send response: %s", error->message);
+  }
+}
+
+// Sends the progress of a job to the Dart code, runs on the main loop.
+static gboolean send_progress_cb(gpointer user_data) {
+  SolveProgress* progress = static_cast<SolveProgress*>(user_data);
+  SolverChannel* self = progress->channel;
+  forget_current_source(self);
+
+  if (self->listening) {
+    g_autoptr(FlValue) event = fl_value_new_map();
+    fl_value_set_string_take(event, "job", fl_value_new_int(progress->id));
+    fl_value_set_string_take(event, "assigned",
+                             fl_value_new_int(progress->assigned));
+    fl_value_set_string_take(event, "n", fl_value_new_int(progress->n));
+    fl_value_set_string_take(event, "dual_objective",
+                             fl_value_new_int(progress->dual_objective));
+
+    g_autoptr(GError) error = nullptr;
+    if (!fl_event_channel_send(self->events, event, nullptr, &error)) {
+      g_warning("Failed to send progress: %s", error->message);
+    }
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void free_progress(gpointer data) {
+  delete static_cast<SolveProgress*>(data);
+}
+
+// Answers the call of a finished job and releases it, runs on the main loop.
+static gboolean finish_solve_cb(gpointer user_data) {
+  SolveRequest* request = static_cast<SolveRequest*>(user_data);
+  SolverChannel* self = request->channel;
+  forget_current_source(self);
+
+  g_autofree int32_t* row_to_col = g_new(int32_t, request->n);
+  int64_t total_cost = 0;
+  int32_t status =
+      belegium_solve_job_finish(request->job, row_to_col, &total_cost);
+
+  if (status == BELEGIUM_OK) {
+    BelegiumSolverStats stats;
+    belegium_last_solver_stats(&stats);
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "row_to_col",
+                             fl_value_new_int32_list(row_to_col, request->n));
+    fl_value_set_string_take(result, "total_cost",
+                             fl_value_new_int(total_cost));
+    fl_value_set_string_take(result, "augmentations",
+                             fl_value_new_int(stats.augmentations));
+    fl_value_set_string_take(result, "scanned",
+                             fl_value_new_int(stats.scanned));
+    fl_value_set_string_take(result, "dual_updates",
+                             fl_value_new_int(stats.dual_updates));
+    fl_value_set_string_take(result, "path_length",
+                             fl_value_new_int(stats.path_length));
+
+    g_autoptr(GError) error = nullptr;
+    if (!fl_method_call_respond_success(request->method_call, result,
+                                        &error)) {
+      g_warning("Failed to send response: %s", error->message);
+    }
+  } else if (status == BELEGIUM_ERROR_CANCELLED) {
+    respond_error(request->method_call, "cancelled",
+                  "The solve was cancelled.");
+  } else {
+    respond_error(request->method_call, "failed", "The solve failed.");
+  }
+
+  self->requests.erase(request->id);
+  belegium_solve_job_free(request->job);
+  g_object_unref(request->method_call);
+  delete request;
+
+  return G_SOURCE_REMOVE;
+}
+
+// Called on the thread of a job.
+static void solve_progress_cb(void* user_data,
+                              int32_t assigned,
+                              int32_t n,
+                              int64_t dual_objective) {
+  SolveRequest* request = static_cast<SolveRequest*>(user_data);
+  post_to_main_loop(request->channel, send_progress_cb,
+                    new SolveProgress{request->channel, request->id, assigned,
+                                      n, dual_objective},
+                    free_progress);
+}
+
+// Called on the thread of a job, after its last progress.
+static void solve_done_cb(void* user_data) {
+  SolveRequest* request = static_cast<SolveRequest*>(user_data);
+  post_to_main_loop(request->channel, finish_solve_cb, request, nullptr);
+}
+
+// Handles the "solve" method, its arguments are the "job" id chosen by the
+// caller, the "key" of the problem, the size "n" and the n x n row-major
+// "costs" to minimize.
+static void solver_channel_solve(SolverChannel* self,
+                                 FlMethodCall* method_call) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  FlValue* id = lookup_argument(args, "job", FL_VALUE_TYPE_INT);
+  FlValue* key = lookup_argument(args, "key", FL_VALUE_TYPE_STRING);
+  FlValue* n = lookup_argument(args, "n", FL_VALUE_TYPE_INT);
+  FlValue* costs = lookup_argument(args, "costs", FL_VALUE_TYPE_INT32_LIST);
+
+  if (id == nullptr || key == nullptr || n == nullptr || costs == nullptr ||
+      fl_value_get_int(n) < 1 || fl_value_get_int(n) > G_MAXINT32 ||
+      fl_value_get_length(costs) !=
+          static_cast<size_t>(fl_value_get_int(n) * fl_value_get_int(n))) {
+    respond_error(method_call, "invalid_argument", "Invalid solve arguments.");
+    return;
+  }
+
+  if (self->requests.count(fl_value_get_int(id)) != 0) {
+    respond_error(method_call, "busy", "The job id is in use.");
+    return;
+  }
+
+  // the solver of a problem keeps its state, so it solves one job at a time
+  for (const auto& entry : self->requests) {
+    if (entry.second->key == fl_value_get_string(key)) {
+      respond_error(method_call, "busy", "The problem is being solved.");
+      return;
+    }
+  }
+
+  BelegiumIncrementalSolver*& solver =
+      self->solvers[fl_value_get_string(key)];
+  if (solver == nullptr) solver = belegium_incremental_solver_create();
+
+  SolveRequest* request = new SolveRequest{
+      self,
+      fl_value_get_int(id),
+      fl_value_get_string(key),
+      static_cast<int32_t>(fl_value_get_int(n)),
+      FL_METHOD_CALL(g_object_ref(method_call)),
+      nullptr,
+  };
+
+  // the job copies the costs, so the arguments may be released
+  int32_t status = belegium_solve_job_start(
+      solver, fl_value_get_int32_list(costs), request->n, request->n,
+      solve_progress_cb, solve_done_cb, request, &request->job);
+  if (status != BELEGIUM_OK) {
+    respond_error(method_call, "failed", "The solve could not be started.");
+    g_object_unref(request->method_call);
+    delete request;
+    return;
+  }
+
+  self->requests[request->id] = request;
+}
+
+// Handles the "cancel" method, its argument is the "job" id. The "solve" call
+// of the job fails with the code "cancelled" if it was not done yet.
+static void solver_channel_cancel(SolverChannel* self,
+                                  FlMethodCall* method_call) {
+  FlValue* id = lookup_argument(fl_method_call_get_args(method_call), "job",
+                                FL_VALUE_TYPE_INT);
+  if (id == nullptr) {
+    respond_error(method_call, "invalid_argument", "Invalid cancel arguments.");
+    return;
+  }
+
+  auto it = self->requests.find(fl_value_get_int(id));
+  if (it != self->requests.end()) belegium_solve_job_cancel(it->second->job);
+
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond_success(method_call, nullptr, &error)) {
+    g_warning("Failed to send response: %s", error->message);
+  }
+}
+
+static void method_call_cb(FlMethodChannel* channel,
+                           FlMethodCall* method_call,
+                           gpointer user_data) {
+  SolverChannel* self = static_cast<SolverChannel*>(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+
+  if (strcmp(method, "solve") == 0) {
+    solver_channel_solve(self, method_call);
+  } else if (strcmp(method, "cancel") == 0) {
+    solver_channel_cancel(self, method_call);
+  } else {
+    g_autoptr(GError) error = nullptr;
+    if (!fl_method_call_respond_not_implemented(method_call, &error)) {
+      g_warning("Failed to send response: %s", error->message);
+    }
+  }
+}
+
+static FlMethodErrorResponse* listen_cb(FlEventChannel* channel,
+                                        FlValue* args,
+                                        gpointer user_data) {
+  static_cast<SolverChannel*>(user_data)->listening = TRUE;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* cancel_cb(FlEventChannel* channel,
+                                        FlValue* args,
+                                        gpointer user_data) {
+  static_cast<SolverChannel*>(user_data)->listening = FALSE;
+  return nullptr;
+}
+
+SolverChannel* solver_channel_new(FlBinaryMessenger* messenger) {
+  SolverChannel* self = new SolverChannel();
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+
+  self->methods = fl_method_channel_new(messenger, kMethodChannelName,
+                                        FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(self->methods, method_call_cb,
+                                            self, nullptr);
+
+  self->events = fl_event_channel_new(messenger, kEventChannelName,
+                                      FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(self->events, listen_cb, cancel_cb,
+                                       self, nullptr);
+
+  return self;
+}
+
+void solver_channel_free(SolverChannel* self) {
+  fl_method_channel_set_method_call_handler(self->methods, nullptr, nullptr,
+                                            nullptr);
+  fl_event_channel_set_stream_handlers(self->events, nullptr, nullptr, nullptr,
+                                       nullptr);
+
+  // the jobs are cancelled and joined before their solvers are released,
+  // then no thread posts sources anymore
+  for (const auto& entry : self->requests) {
+    belegium_solve_job_cancel(entry.second->job);
+  }
+  for (const auto& entry : self->requests) {
+    belegium_solve_job_free(entry.second->job);
+  }
+
+  // sources that did not run yet point to the requests, they are removed
+  // before the requests are released, the progress is released with them
+  for (GSource* source : self->sources) {
+    g_source_destroy(source);
+    g_source_unref(source);
+  }
+  self->sources.clear();
+
+  for (const auto& entry : self->requests) {
+    g_object_unref(entry.second->method_call);
+    delete entry.second;
+  }
+  for (const auto& entry : self->solvers) {
+    belegium_incremental_solver_free(entry.second);
+  }
+
+  g_object_unref(self->methods);
+  g_object_unref(self->events);
+  delete self;
+}
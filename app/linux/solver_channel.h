@@ -0,0 +1,32 @@
+#ifndef FLUTTER_SOLVER_CHANNEL_H_
+#define FLUTTER_SOLVER_CHANNEL_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+typedef struct _SolverChannel SolverChannel;
+
+/**
+ * solver_channel_new:
+ * @messenger: an #FlBinaryMessenger of the engine.
+ *
+ * Registers the "belegium_matcher/solver" method channel, whose "solve"
+ * method runs a solve job of the native core on a worker thread and whose
+ * "cancel" method stops it, and the "belegium_matcher/solver/progress" event
+ * channel streaming the progress of all running jobs. The main loop is never
+ * blocked by a solve.
+ *
+ * Returns: a new #SolverChannel, release it with solver_channel_free() on
+ * the thread of the main loop.
+ */
+SolverChannel* solver_channel_new(FlBinaryMessenger* messenger);
+
+/**
+ * solver_channel_free:
+ * @channel: a #SolverChannel.
+ *
+ * Cancels and waits for all running jobs, removes their progress and results
+ * that were not sent yet from the main loop and releases @channel.
+ */
+void solver_channel_free(SolverChannel* channel);
+
+#endif  // FLUTTER_SOLVER_CHANNEL_H_